@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <cstdint>
+
+#include "bf/instruction.hpp"
+
+namespace bf {
+
+/**
+ * @brief Compile-time analysis passes that rely on the tape state at program start.
+ *
+ * A Brainfuck program always starts on a zeroed tape with the data pointer at the origin,
+ * so every cell value is known until the program reads input. The passes below use that
+ * knowledge; they plug into the Optimizer pipeline like any other pass (see
+ * Compiler::compile_analyzed) and, like every pass, take and return unlinked code.
+ *
+ * Both passes assume the program runs on a fresh tape of at least evaluation_window cells.
+ */
+class Analyzer {
+public:
+    /**
+     * @brief Number of cells, starting at the origin, the compile-time evaluation may touch.
+     */
+    static constexpr int64_t evaluation_window = 1024;
+
+    /**
+     * @brief Maximum number of instructions executed at compile time.
+     */
+    static constexpr size_t evaluation_step_limit = size_t{1} << 22;
+
+    /**
+     * @brief Runs the program at compile time up to its first input-dependent instruction.
+     *
+     * Evaluation stops before the first Input, before any access outside the evaluation
+     * window, at HALT or when the step limit is reached. If it stops inside a loop, it backs
+     * up to the start of the outermost loop being run. The evaluated prefix is replaced by
+     * straight-line code that prints the precomputed output bytes and then sets up the tape
+     * and data pointer the prefix left behind; the rest of the program follows unchanged.
+     */
+    static Code evaluate_constant_prefix(Code const& code);
+
+    /**
+     * @brief Tracks known cell values (relative to the data pointer) through the code.
+     *
+     * Using what is known about each cell:
+     * - loops entered on a cell known to be zero are removed, with their bodies;
+     * - SetZero of a cell known to be zero is removed;
+     * - MultiplyAdd of a known factor becomes an Add, or disappears when the factor is zero.
+     * Knowledge is dropped when a loop is entered (only the exit cell, zero, is known after it),
+     * after a scan, and for a cell that receives input.
+     */
+    static Code propagate_known_cells(Code const& code);
+};
+
+} // namespace bf
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace bf {
+
+/**
+ * @brief Exception thrown when a program cannot be compiled to native code or loaded for execution.
+ */
+class JitException : public std::runtime_error {
+public:
+    explicit JitException(const std::string& reason);
+};
+
+/**
+ * @brief Exception thrown when a guarded tape region cannot be reserved or committed.
+ */
+class TapeException : public std::runtime_error {
+public:
+    explicit TapeException(const std::string& reason);
+};
+
+/**
+ * @brief Exception thrown when a source file cannot be opened or mapped.
+ */
+class SourceException : public std::runtime_error {
+public:
+    explicit SourceException(const std::string& reason);
+};
+
+} // namespace bf
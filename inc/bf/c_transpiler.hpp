@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <stddef.h>
+
+#include "bf/instruction.hpp"
+#include "bf/native_code.hpp"
+#include "bf/memory.hpp"
+
+namespace bf {
+
+/**
+ * @brief Translates a program into C source and builds it into a loadable shared object.
+ *
+ * An alternative to X86Jit that leaves instruction selection and register allocation to the
+ * system C compiler. The emitted translation unit exports a single function, 'bf_entry',
+ * with the NativeEntry signature and the same tape edge semantics as Memory.
+ */
+class CTranspiler {
+public:
+    /**
+     * @brief Name of the function exported by the emitted source.
+     */
+    static constexpr const char* entry_symbol = "bf_entry";
+
+    /**
+     * @brief Emits C source for the given instructions.
+     *
+     * @param code The (optionally optimized) instructions to translate; translation stops at the first HALT.
+     * @param tape_size Number of cells of the tape the code will run on.
+     * @param boundary Edge behaviour of the tape the code will run on.
+     * @return std::string A complete C translation unit.
+     */
+    static std::string emit(Code const& code, size_t tape_size, Boundary boundary = Boundary::Wrap);
+
+    /**
+     * @brief Compiles C source with the system compiler and loads the result with dlopen.
+     *
+     * The source and the shared object are written to a private temporary directory which
+     * is removed once the library is loaded.
+     *
+     * @param source The C source, as produced by emit().
+     * @param compiler The compiler command to invoke (default: "cc").
+     * @return std::unique_ptr<SharedLibrary> The loaded library.
+     * @throws JitException if compilation or loading fails.
+     */
+    static std::unique_ptr<SharedLibrary> build(std::string const& source, std::string const& compiler = "cc");
+};
+
+} // namespace bf
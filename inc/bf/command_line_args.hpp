@@ -2,10 +2,38 @@
 
 #include <string>
 #include <iostream>
-#include <fstream>
-#include <sstream>
+
+#include "bf/memory.hpp"
+#include "bf/console.hpp"
 
 namespace bf {
+
+/**
+ * @brief Selects the engine that executes the compiled program.
+ */
+enum class Backend {
+    Microcode,      ///< The VM: fetches each instruction and dispatches it through Microcode.
+    Threaded,       ///< The ThreadedVM: direct-threaded interpreter loop.
+    Jit,            ///< The JitVM with x86-64 machine code.
+    JitC            ///< The JitVM with C source built by the system compiler.
+};
+
+/**
+ * @brief Execution options given on the command line.
+ *
+ * @details
+ * Members:
+ * - Backend backend: The engine that runs the program (--threaded, --jit or --jit-c).
+ * - Boundary boundary: The edge behaviour of the tape (--grow selects Boundary::Grow).
+ * - ConsoleMode console: How program I/O reaches the streams (--buffered selects ConsoleMode::Buffered).
+ * - std::string source_path: The source file to compile, empty when the code was given with '-r'.
+ */
+struct RunOptions {
+    Backend backend = Backend::Microcode;
+    Boundary boundary = Boundary::Wrap;
+    ConsoleMode console = ConsoleMode::Direct;
+    std::string source_path;
+};
    
  /**
  * @brief Handles and validates command line arguments for a Brainfuck interpreter.
@@ -24,6 +52,27 @@ public:
      * @return bool True if arguments are valid and code is retrieved, false otherwise.
      */
     static bool get_code_for_compilation(int argc, char* argv[], std::string& code);
+
+    // The overload below does not read source files: it reports the path in
+    // RunOptions::source_path, so the caller can map the file and compile it in place.
+
+    /**
+     * @brief Validates the command line arguments, retrieves the Brainfuck code and the run options.
+     *
+     * Options start with "--" and may appear anywhere before the file name or the '-r' code:
+     * - --threaded : run the program on the direct-threaded interpreter.
+     * - --jit      : compile the program to x86-64 machine code.
+     * - --jit-c    : compile the program to C and build it with the system compiler.
+     * - --grow     : run on a growable, guard-paged tape instead of the wrapping 30000-cell one.
+     * - --buffered : buffer program output and read input in blocks.
+     *
+     * @param argc Number of command line arguments.
+     * @param argv Array of command line arguments.
+     * @param code Receives the Brainfuck code given with '-r'; left empty for a source file.
+     * @param options Receives the run options found on the command line, including the source file path.
+     * @return bool True if arguments are valid, false otherwise.
+     */
+    static bool get_code_for_compilation(int argc, char* argv[], std::string& code, RunOptions& options);
 };
    
 }       // namespace bf
@@ -1,11 +1,12 @@
 # pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 
 #include "bf/operations.hpp"
 #include "bf/program.hpp"
+#include "bf/optimizer.hpp"
 
 namespace bf {
 
@@ -18,68 +19,77 @@ public:
     /**
      * @brief Compiles the given source string into a Program.
      * 
-     * This method involves parsing the source code into opcodes, building a jump table for loop control,
-     * and creating a Program instance with these components.
+     * Translates the source into instructions, validates bracket pairing and links every loop
+     * bracket to its matching bracket in a single pass over the source. The source may be a
+     * std::string or a view of a mapped SourceFile, so large files are compiled without a copy.
      * 
      * @param source The Brainfuck source code to be compiled.
      * @return Program The compiled program.
+     *
+     * @note If validation fails, logs an error to standard error output and returns an empty program.
+     */
+    Program compile(std::string_view source);
+
+    /**
+     * @brief Compiles the given source string into an optimized Program.
+     *
+     * Compiles the source like compile() and then runs the Optimizer pipeline over it, so the
+     * resulting Program holds operand-carrying IR instructions (Add, Move, SetZero, MultiplyAdd,
+     * ScanLeft, ScanRight) instead of one opcode per source character.
+     *
+     * @param source The Brainfuck source code to be compiled.
+     * @return Program The compiled and optimized program.
      */
-    Program compile(const std::string& source);
+    Program compile_optimized(std::string_view source);
+
+    /**
+     * @brief Compiles the given source string into an optimized Program, using compile-time analysis.
+     *
+     * Runs the Optimizer pipeline of compile_optimized() extended with the Analyzer passes: the
+     * input-independent prefix of the program is evaluated at compile time (its output is emitted
+     * as precomputed bytes), and known cell values are propagated through the rest to remove dead
+     * loops and redundant clears. The program must be run on a fresh tape of at least
+     * Analyzer::evaluation_window cells.
+     *
+     * @param source The Brainfuck source code to be compiled.
+     * @return Program The compiled, analyzed and optimized program.
+     */
+    Program compile_analyzed(std::string_view source);
 
     /**
      * @brief Parses the given source string into a vector of opcodes.
      * 
-     * Filters the source to remove non-relevant characters, validates the filtered source for correct syntax,
+     * Skips non-relevant characters, validates the source for correct bracket pairing,
      * and translates each valid character into an OpCode, collecting them into a vector. The vector is
-     * returned with an 'END' OpCode marking the completion.
+     * returned with a 'HALT' OpCode marking the completion.
      * 
      * @param source The source code to be parsed.
      * @return std::vector<OpCode> The vector of parsed opcodes.
      * 
      * @note If validation fails, logs an error to standard error output and returns an empty vector.
      */
-    std::vector<OpCode> parse(const std::string& source);
+    std::vector<OpCode> parse(std::string_view source);
 
     /**
-     * @brief Builds a jump table for matching loop start and end points.
-     * 
-     * This function generates mappings from loop start indices to their corresponding loop end indices
-     * and vice versa, facilitating efficient control flow during program execution.
-     * 
-     * @param instructions The vector of opcodes previously parsed from the source.
-     * @param jump_table Reference to an unordered_map to store the loop start and end mappings.
+     * @brief Checks that every loop bracket in the source is matched, without compiling it.
+     *
+     * @param source The Brainfuck source code to check.
+     * @return bool True if the source compiles, false otherwise. Nothing is logged.
      */
-    void build_jump_table(std::vector<OpCode> instructions, std::unordered_map<size_t, size_t>& jump_table);
+    bool validate(std::string_view source) const;
 
 private:
     /**
-     * @brief Filters the source code to remove any non-instruction characters.
-     * 
-     * This method helps in cleaning the input source code by removing characters
-     * that are not part of the programming language syntax.
-     * 
-     * @param source The unfiltered source code.
-     * @return std::string The filtered source code.
-     */
-    std::string filter(const std::string& source);
-
-    /**
-     * @brief Translates a single character into its corresponding OpCode.
-     * 
-     * @param c The character to translate.
-     * @return OpCode The corresponding opcode of the character.
-     */
-    OpCode translate(char c);
-
-    /**
-     * @brief Validates the source code for correct bracket pairing.
-     * 
-     * This method ensures that all loop start and end markers ('[' and ']') in the source code are correctly paired.
+     * @brief Translates, validates and links the source in one pass.
+     *
+     * Characters are classified through a 256-entry table (HALT marks non-instruction bytes) and
+     * every LoopStart and LoopEnd gets the index of its matching bracket as its 'arg'.
      *
-     * @param source The source code to validate, consisting of characters that are translated into OpCodes.
+     * @param source The source code to translate.
+     * @param code Receives the linked instructions, terminated by HALT.
      * @return bool True if all loops are properly closed and no unmatched loop end markers are found, false otherwise.
      */
-    bool validate(const std::string& source);
+    bool translate_and_link(std::string_view source, Code& code);
 };
 
-}
\ No newline at end of file
+}
@@ -1,12 +1,22 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
+#include <stddef.h>
 
 #include "bf/mem_arg_types.hpp"
 
 namespace bf
 {
 
+/**
+ * @brief Selects how the Console talks to its streams.
+ */
+enum class ConsoleMode {
+    Direct,     ///< Every character goes straight to / comes straight from the stream.
+    Buffered    ///< Output is collected and written in bulk, input is read in bulk.
+};
+
 /**
  * @brief Handles input and output operations for Brainfuck execution.
  *
@@ -14,14 +24,33 @@ namespace bf
  * used in the Brainfuck interpreter. It allows reading from and writing to
  * character streams, which can be directed to or from different sources such
  * as standard input/output or file streams.
+ *
+ * In ConsoleMode::Buffered the output is kept in a large buffer and written to the
+ * stream with a single write when the buffer reaches its threshold, when the program
+ * asks for input (so prompts are visible), on flush() and on destruction. Input is
+ * read in blocks of whatever the stream has available.
  * 
  * @details
  * Members:
  * - std::ostream& os_: Output stream used for writing characters. Default is std::cout.
  * - std::istream& is_: Input stream used for reading characters. Default is std::cin.
+ * - ConsoleMode mode_: Direct or buffered I/O.
+ * - std::vector<char> output_: Pending output (buffered mode).
+ * - std::vector<char> input_: Input read ahead from the stream (buffered mode).
+ * - size_t input_next_: Next unread position in input_.
  */
 class Console {
 public:
+    /**
+     * @brief Output buffer size at which buffered output is written to the stream.
+     */
+    static constexpr size_t output_threshold = size_t{1} << 16;
+
+    /**
+     * @brief Maximum number of bytes read from the input stream at once.
+     */
+    static constexpr size_t input_block = size_t{1} << 12;
+
     /**
      * @brief Construct a new Console object.
      * 
@@ -30,29 +59,31 @@ public:
      * 
      * @param os_ Reference to the output stream.
      * @param is_ Reference to the input stream.
+     * @param mode Direct (default) or buffered I/O.
      */
-    Console(std::ostream& os = std::cout, std::istream& is = std::cin);
+    Console(std::ostream& os = std::cout, std::istream& is = std::cin, ConsoleMode mode = ConsoleMode::Direct);
 
     /**
-     * @brief Default copy constructor.
+     * @brief Copying is disabled - pending buffered output must be written exactly once.
      */
-    Console(Console const& other) = default;
+    Console(Console const& other) = delete;
 
     /**
-     * @brief Default destructor.
+     * @brief Destructor - writes any pending buffered output.
      */
-    ~Console() = default;
+    ~Console();
 
     /**
-     * @brief Default copy assignment operator.
+     * @brief Copy assignment is disabled, see the copy constructor.
      */
-    Console& operator=(Console const& other) = default;
+    Console& operator=(Console const& other) = delete;
 
     /**
      * @brief Read a single character from the input stream.
      * 
      * Reads a character from the input stream and returns it as a CellType value.
      * This function is typically used to fetch user input during Brainfuck execution.
+     * In buffered mode pending output is written first, and end of input reads as 0.
      * 
      * @return CellType The character read from the input stream, converted to CellType.
      */
@@ -68,9 +99,38 @@ public:
      */
     void print_char(CellType c);
 
+    /**
+     * @brief Write the same character several times - the fast path for a folded run of '.'.
+     *
+     * @param c The character to print.
+     * @param count How many times to print it.
+     */
+    void print_chars(CellType c, size_t count);
+
+    /**
+     * @brief Write any pending buffered output to the stream and flush the stream.
+     */
+    void flush();
+
+private:
+    /**
+     * @brief Refills the input buffer from the stream.
+     *
+     * Waits for the stream to have input, then takes up to input_block bytes of what its
+     * buffer holds. An unbuffered stream buffer (e.g. std::cin while synced with stdio)
+     * yields one byte per refill.
+     *
+     * @return bool False at end of input.
+     */
+    bool refill();
+
 private:
     std::ostream& os_;
     std::istream& is_;
+    ConsoleMode mode_;
+    std::vector<char> output_;
+    std::vector<char> input_;
+    size_t input_next_;
 };
 
 } // namespace bf
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <shared_mutex>
+#include <future>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <stddef.h>
+
+#include "bf/program.hpp"
+#include "bf/memory.hpp"
+#include "dp/object_pool.hpp"
+#include "mt/thread_pool.hpp"
+
+namespace bf {
+
+/**
+ * @brief How a run submitted to the Engine ended.
+ */
+enum class RunStatus {
+    Halted,         ///< The program ran to completion.
+    StepLimit,      ///< The run was stopped by its step limit.
+    InvalidSource   ///< The source has unmatched brackets; nothing was run.
+};
+
+/**
+ * @brief The outcome of one Engine run.
+ *
+ * @details
+ * Members:
+ * - RunStatus status: How the run ended.
+ * - std::string output: Everything the program printed (up to the point it stopped).
+ */
+struct RunReport {
+    RunStatus status;
+    std::string output;
+};
+
+/**
+ * @brief Runs many Brainfuck programs concurrently, compiling each distinct source once.
+ *
+ * Compiled programs are cached by a hash of their source (the source itself is kept to
+ * rule out collisions) and shared by every run of that source - a Program copy only
+ * shares the instructions. The cache holds at most cache_capacity programs; compiling one
+ * more evicts the least recently used. Runs execute on a worker pool, each on a ThreadedVM
+ * with a 30000-cell wrapping tape taken from a tape pool and in-memory, buffered I/O. A tape
+ * returns to the pool after clearing only the cells its run touched, or all of them if the
+ * run threw.
+ *
+ * Programs are compiled with Compiler::compile_analyzed, so the input-independent
+ * prefix of a script is evaluated once, at compile time, not on every run.
+ *
+ * @details
+ * Members:
+ * - std::unordered_map<size_t, CacheEntry> programs_: Compiled programs keyed by source hash.
+ * - std::shared_mutex programs_mutex_: Guards programs_ (many readers, occasional writer).
+ * - size_t cache_capacity_: Maximum number of entries in programs_.
+ * - std::atomic<uint64_t> clock_: Stamps cache lookups, for least recently used eviction.
+ * - dp::ObjectPool<Memory> tapes_: Idle, zeroed tapes.
+ * - mt::ThreadPool<> workers_: Executes the runs; declared last so it is joined first.
+ */
+class Engine {
+public:
+    /**
+     * @brief Number of cells on every tape.
+     */
+    static constexpr size_t tape_size = 30000;
+
+    /**
+     * @brief Step limit meaning "run until HALT".
+     */
+    static constexpr size_t unlimited = 0;
+
+    /**
+     * @brief Default number of compiled programs kept in the cache.
+     */
+    static constexpr size_t default_cache_capacity = 1024;
+
+    /**
+     * @brief Starts the worker pool and fills the tape pool with one tape per worker.
+     *
+     * @param workers Number of worker threads; 0, as hardware_concurrency() may report,
+     *        starts one worker so that submitted runs still complete.
+     * @param cache_capacity Number of compiled programs kept (0 is treated as 1).
+     */
+    explicit Engine(size_t workers = std::thread::hardware_concurrency(), size_t cache_capacity = default_cache_capacity);
+
+    /**
+     * @brief Waits for all submitted runs to finish and stops the workers.
+     */
+    ~Engine();
+
+    Engine(Engine const&) = delete;
+    Engine& operator=(Engine const&) = delete;
+
+    /**
+     * @brief Queues a run of a program and returns its future report.
+     *
+     * @param source The Brainfuck source - compiled on first use, then taken from the cache.
+     * @param input Everything the program may read; reading past it yields 0.
+     * @param step_limit Maximum number of steps (loop iterations and scan moves, see
+     *        ThreadedVM::run_for), or unlimited.
+     * @return std::future<RunReport> The report, ready when the run ends.
+     */
+    std::future<RunReport> submit(std::string const& source, std::string input = "", size_t step_limit = unlimited);
+
+    /**
+     * @brief Runs a program on a worker and waits for its report.
+     */
+    RunReport run(std::string const& source, std::string input = "", size_t step_limit = unlimited);
+
+    /**
+     * @brief Returns the number of compiled programs currently cached, at most the cache capacity.
+     */
+    size_t cached_programs() const;
+
+private:
+    struct CacheEntry {
+        CacheEntry(std::string const& source, std::shared_ptr<const Program> program, uint64_t stamp);
+
+        std::string source;
+        std::shared_ptr<const Program> program;   // nullptr for invalid source
+        std::atomic<uint64_t> last_used;          // bumped under the shared lock
+    };
+
+    /**
+     * @brief Returns the compiled program for a source, compiling and caching it if needed.
+     *
+     * @return std::shared_ptr<const Program> The program, or nullptr if the source is invalid.
+     */
+    std::shared_ptr<const Program> program_for(std::string const& source);
+
+    /**
+     * @brief Executes one run on the calling (worker) thread.
+     */
+    RunReport execute(std::string const& source, std::string const& input, size_t step_limit);
+
+private:
+    std::unordered_map<size_t, CacheEntry> programs_;
+    mutable std::shared_mutex programs_mutex_;
+    size_t cache_capacity_;
+    std::atomic<uint64_t> clock_;
+    dp::ObjectPool<Memory> tapes_;
+    mt::ThreadPool<> workers_;
+};
+
+} // namespace bf
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <signal.h>
+#include <stddef.h>
+#include <cstdint>
+
+#include "bf/mem_arg_types.hpp"
+
+namespace bf {
+
+/**
+ * @brief A large virtual byte region, committed on demand and fenced by PROT_NONE guard pages.
+ *
+ * The whole region is reserved up front with mmap as PROT_NONE; only a prefix is made
+ * readable and writable. Touching a cell past the committed prefix raises SIGSEGV, which a
+ * process-wide handler turns into a commit of the pages up to the fault (rounded up to a
+ * growth chunk) before the faulting instruction is retried. The region can also be grown
+ * explicitly with ensure(). A guard zone of at least one page before the first byte and one
+ * after the last is never committed, so an access that lands in either still faults - through
+ * the previously installed handler, i.e. normally a crash rather than silent memory corruption.
+ * An access further out than the guard zone is not caught, so callers size it to the largest
+ * jump they can make past an end (see Program::reach()).
+ *
+ * Members:
+ * - char* mapping_: Start of the whole mapping, including the leading guard zone.
+ * - size_t mapping_size_: Length of the whole mapping.
+ * - size_t capacity_: Number of usable bytes between the guard zones.
+ * - size_t guard_: Length of each guard zone.
+ * - size_t slot_: Index of this region in the signal handler's registry.
+ */
+class GuardedRegion {
+public:
+    /**
+     * @brief Default number of usable bytes reserved (1 GiB of address space, not of memory).
+     */
+    static constexpr size_t default_capacity = size_t{1} << 30;
+
+    /**
+     * @brief Reserves the region and commits its first 'initial' bytes.
+     *
+     * @param initial Number of bytes to commit right away.
+     * @param capacity Number of usable bytes to reserve.
+     * @param guard Minimum length of each guard zone, rounded up to whole pages (at least one).
+     * @throws TapeException if the reservation fails or too many regions are alive.
+     */
+    explicit GuardedRegion(size_t initial, size_t capacity = default_capacity, size_t guard = 0);
+
+    /**
+     * @brief Unregisters and unmaps the region.
+     */
+    ~GuardedRegion();
+
+    GuardedRegion(GuardedRegion const&) = delete;
+    GuardedRegion& operator=(GuardedRegion const&) = delete;
+
+    /**
+     * @brief Returns the first usable byte.
+     */
+    CellType* data() const;
+
+    /**
+     * @brief Returns the number of usable bytes reserved.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Returns the length of the guard zone on each side.
+     */
+    size_t guard() const;
+
+    /**
+     * @brief Returns the number of bytes currently committed (readable and writable).
+     */
+    size_t committed() const;
+
+    /**
+     * @brief Commits at least the first 'bytes' usable bytes.
+     *
+     * @param bytes Number of bytes that must be accessible, clamped to capacity().
+     */
+    void ensure(size_t bytes);
+
+private:
+    struct Slot {
+        std::atomic<uintptr_t> begin;
+        std::atomic<uintptr_t> end;
+        std::atomic<uintptr_t> committed_end;
+    };
+
+    static constexpr size_t max_regions = 64;
+    static constexpr size_t growth_chunk = size_t{64} << 10;
+
+    /**
+     * @brief Commits [committed_end, target) of a slot, rounded up to the growth chunk.
+     */
+    static bool commit_up_to(Slot& slot, uintptr_t target) noexcept;
+
+    /**
+     * @brief Installs the SIGSEGV handler unless it is already the active one.
+     */
+    static void install_handler();
+
+    /**
+     * @brief SIGSEGV handler - grows the region owning the faulting address, or defers to the previous handler.
+     */
+    static void on_fault(int signal, siginfo_t* info, void* context);
+
+    static Slot slots_[max_regions];
+    static struct sigaction previous_action_;
+
+private:
+    char* mapping_;
+    size_t mapping_size_;
+    size_t capacity_;
+    size_t guard_;
+    size_t slot_;
+};
+
+} // namespace bf
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "bf/operations.hpp"
+
+namespace bf {
+
+/**
+ * @brief A single instruction of the intermediate representation executed by the VM.
+ *
+ * Plain Brainfuck opcodes ('+', '>', '[' ...) carry no operands, while the optimized
+ * IR opcodes (Add, Move, SetZero, MultiplyAdd, ScanLeft, ScanRight) and a folded
+ * Output use the operands:
+ * - Add(n)                  : arg = n, offset = cell offset relative to the data pointer.
+ * - Move(n)                 : arg = n (negative moves left).
+ * - SetZero                 : offset = cell offset relative to the data pointer.
+ * - MultiplyAdd(off, f)     : arg = f, offset = off.
+ * - ScanLeft / ScanRight    : arg = step size.
+ * - Output(n)               : arg = n repetitions of the current cell (0 and 1 both print once).
+ * - LoopStart / LoopEnd     : arg = index of the matching bracket (the jump target).
+ *
+ * @details
+ * Members:
+ * - OpCode op: The operation to perform.
+ * - int32_t arg: The primary operand (amount, distance or factor).
+ * - int32_t offset: Offset of the target cell relative to the data pointer.
+ */
+struct Instruction {
+    OpCode op;
+    int32_t arg = 0;
+    int32_t offset = 0;
+};
+
+/**
+ * @brief A sequence of instructions - the unit every optimization pass works on.
+ */
+using Code = std::vector<Instruction>;
+
+} // namespace bf
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+
+#include "bf/memory.hpp"
+#include "bf/program.hpp"
+#include "bf/console.hpp"
+#include "bf/native_code.hpp"
+
+namespace bf {
+
+/**
+ * @brief Selects how JitVM produces native code.
+ */
+enum class JitMode {
+    MachineCode,    ///< Assemble x86-64 machine code directly into an executable buffer (X86Jit).
+    CSource         ///< Transpile to C, build with the system compiler and dlopen the result (CTranspiler).
+};
+
+/**
+ * @brief Runs Brainfuck-like programs as native code.
+ *
+ * The whole program is translated when the JitVM is constructed, for the size of the given tape;
+ * run() then calls straight into the generated code, which calls back into the Console for I/O.
+ * Programs always start from their first instruction. When run() returns, the Memory data pointer
+ * and the Program instruction pointer reflect the final state, exactly as after VM::run().
+ *
+ * Members:
+ * - Memory& memory_: Reference to the Memory instance that stores data cells manipulated by the program.
+ * - Program& program_: Reference to the Program instance that was translated.
+ * - Console& console_: Reference to the Console instance used for input and output operations.
+ * - std::unique_ptr<ExecutableBuffer> machine_code_: Generated code in MachineCode mode.
+ * - std::unique_ptr<SharedLibrary> library_: Loaded shared object in CSource mode.
+ * - NativeEntry entry_: Entry point of the generated code.
+ */
+class JitVM {
+public:
+    /**
+     * @brief Translates the program into native code.
+     *
+     * @param memory Reference to a Memory instance for data storage.
+     * @param program Reference to a Program instance holding the (optionally optimized) instructions.
+     * @param console Reference to a Console instance for handling input and output.
+     * @param mode How to produce the native code.
+     * @throws JitException if the code cannot be generated or loaded (e.g. MachineCode on a non x86-64 host).
+     */
+    JitVM(Memory& memory, Program& program, Console& console, JitMode mode = JitMode::MachineCode);
+
+    /**
+     * @brief Executes the native code until HALT.
+     */
+    void run();
+
+private:
+    Memory& memory_;
+    Program& program_;
+    Console& console_;
+    std::unique_ptr<ExecutableBuffer> machine_code_;
+    std::unique_ptr<SharedLibrary> library_;
+    NativeEntry entry_;
+};
+
+} // namespace bf
@@ -1,18 +1,39 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include <stddef.h>
 #include <cstdint>
 
 #include "bf/mem_arg_types.hpp"
+#include "bf/guarded_region.hpp"
 
 namespace bf {
 
+/**
+ * @brief Selects what happens when the data pointer reaches the edge of the tape.
+ */
+enum class Boundary {
+    Wrap,   ///< Fixed-size tape, the data pointer wraps around at both ends.
+    Grow    ///< Tape starting at cell 0 and growing to the right on demand; no bounds checks on moves.
+};
+
 /**
  * @brief Represents memory management for a Brainfudg-like interpreter.
+ *
+ * A Boundary::Wrap tape is a fixed std::vector whose pointer moves wrap around the edges.
+ * A Boundary::Grow tape lives in a GuardedRegion: a large reserved virtual range that is
+ * committed on demand when the program first touches a page, so pointer moves need no
+ * checks at all. Every VM widens the region's guard zones to the reach of the program it
+ * runs (see reserve_guard()), so an access left of cell 0, or past the reserved range, lands
+ * in a guard zone and faults instead of corrupting memory.
  * 
  * Members:
- * - std::vector<uint8_t> tape_: The memory tape where data is stored.
+ * - Boundary boundary_: The edge behaviour of the tape.
+ * - std::vector<uint8_t> tape_: The memory tape where data is stored (Boundary::Wrap).
+ * - std::unique_ptr<GuardedRegion> region_: The memory tape where data is stored (Boundary::Grow).
+ * - CellType* cells_: The first cell of whichever storage is in use.
+ * - size_t size_: The number of addressable cells.
  * - size_t pointer_: The current position of the data pointer on the tape.
  */
 class Memory {
@@ -21,11 +42,13 @@ public:
     /**
      * @brief Constructs a Memory object with a specified tape size.
      *
-     * @param size The size of the memory tape. Default is 30000.
+     * @param size The size of the memory tape. Default is 30000. For a Boundary::Grow tape
+     * this is the number of cells committed up front; the tape can grow far beyond it.
+     * @param boundary The edge behaviour of the tape. Default is Boundary::Wrap.
      * 
      * @note Initializes the tape with a given size, setting all cells to zero and the pointer to the start.
      */
-    Memory(size_t size = 30000);
+    Memory(size_t size = 30000, Boundary boundary = Boundary::Wrap);
 
     /**
      * @brief Default destructor.
@@ -33,14 +56,14 @@ public:
     ~Memory() = default;
 
     /**
-     * @brief Default copy constructor.
+     * @brief Copy constructor - a growable tape gets its own region with the committed cells copied.
      */
-    Memory(Memory const& other) = default;
+    Memory(Memory const& other);
 
     /**
-     * @brief Default copy assignment operator.
+     * @brief Copy assignment operator.
      */
-    Memory& operator=(Memory const& other) = default;
+    Memory& operator=(Memory const& other);
 
     /**
      * @brief Reads the byte at the current pointer position.
@@ -70,12 +93,104 @@ public:
      */
     void move_right();
 
+    /**
+     * @brief Moves the data pointer by a given number of cells.
+     *
+     * Wraps around the tape edges the same way move_left() and move_right() do (Boundary::Wrap).
+     *
+     * @param distance Number of cells to move, negative values move to the left.
+     */
+    void move(int32_t distance);
+
+    /**
+     * @brief Reads the byte at a given offset from the current pointer position.
+     *
+     * @param offset Offset relative to the data pointer, wrapping around the tape edges (Boundary::Wrap).
+     * @return CellType The value at the addressed cell.
+     */
+    CellType read_at(int32_t offset);
+
+    /**
+     * @brief Writes a byte at a given offset from the current pointer position.
+     *
+     * @param offset Offset relative to the data pointer, wrapping around the tape edges (Boundary::Wrap).
+     * @param c The byte to write to the memory tape.
+     */
+    void write_at(int32_t offset, CellType c);
+
+    /**
+     * @brief Returns a pointer to the first cell of the tape.
+     *
+     * Used by interpreters that keep the data pointer in a local variable.
+     */
+    CellType* data();
+
+    /**
+     * @brief Returns the number of cells on the tape (the reserved capacity for Boundary::Grow).
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the edge behaviour of the tape.
+     */
+    Boundary boundary() const;
+
+    /**
+     * @brief Returns the current position of the data pointer.
+     */
+    Index position() const;
+
+    /**
+     * @brief Places the data pointer at a given cell.
+     *
+     * @param position Index of the cell, must be smaller than size().
+     */
+    void seek(Index position);
+
+    /**
+     * @brief Zeroes the cells in [begin, end) and places the data pointer at cell 0.
+     *
+     * Lets a tape be reused for another run while clearing only the cells the last run
+     * touched. On a Boundary::Grow tape only committed cells are cleared - the rest are
+     * still untouched zero pages.
+     *
+     * @param begin Index of the first cell to clear.
+     * @param end Index one past the last cell to clear, at most size().
+     */
+    void reset(Index begin, Index end);
+
+    /**
+     * @brief Makes the guard zones of a Boundary::Grow tape at least 'cells' wide, plus however
+     * far the data pointer already lies outside the tape.
+     *
+     * A wider guard means a new region: the committed cells are copied into it and data()
+     * changes. Does nothing on a Boundary::Wrap tape or when the guard is already wide enough.
+     *
+     * @param cells Largest distance past either end an access may land, e.g. Program::reach().
+     */
+    void reserve_guard(size_t cells);
+
 #ifdef BF_DEBUG
     CellType operator[](Index index) const;
 #endif
     // CellType operator[](Index index) const;
 private:
+    /**
+     * @brief Translates an offset from the data pointer into a tape index, wrapping around the edges.
+     */
+    Index wrap(int32_t offset) const;
+
+    /**
+     * @brief Translates an offset from the data pointer into a tape index for either boundary.
+     */
+    Index locate(int32_t offset) const;
+
+private:
+    Boundary boundary_;
     std::vector<CellType> tape_;
+    std::unique_ptr<GuardedRegion> region_;
+    CellType* cells_;
+    size_t size_;
     Index pointer_;
 };
 
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <array>
 #include <functional>
 #include <sys/types.h>
 #include <cstdint>
 
 #include "bf/operations.hpp"
+#include "bf/instruction.hpp"
 #include "bf/memory.hpp"
 #include "bf/program.hpp"
 #include "bf/console.hpp"
@@ -22,8 +24,9 @@ namespace bf {
  * - Memory& memory_: Reference to the Memory component used for data storage and manipulation.
  * - Program& program_: Reference to the Program component managing the instruction flow.
  * - Console& console_: Reference to the Console component for input/output operations.
- * - std::array<std::function<void()>, static_cast<uint8_t>(OpCode::END)> commands_: 
- *   Array of command functions, each corresponding to an opcode, to execute the associated operation.
+ * - std::array<std::function<void(Instruction const&)>, static_cast<uint8_t>(OpCode::END)> commands_: 
+ *   Array of command functions, each corresponding to an opcode, to execute the associated operation
+ *   with the operands carried by the instruction.
  */
 class Microcode {
 public:
@@ -47,13 +50,14 @@ public:
     int index(OpCode op);
 
     /**
-     * @brief Executes the command associated with the given opcode.
+     * @brief Executes the command associated with the given instruction.
      * 
-     * Executes the function mapped to the opcode in the commands array.
+     * Executes the function mapped to the instruction's opcode in the commands array,
+     * passing along its operands.
      * 
-     * @param op The opcode to execute.
+     * @param instruction The instruction to execute.
      */
-    void execute(OpCode op);
+    void execute(Instruction const& instruction);
     
 private:  
     /**
@@ -67,7 +71,7 @@ private:
     Memory& memory_;
     Program& program_;
     Console& console_;
-    std::array<std::function<void()>, static_cast<uint8_t>(OpCode::END)> commands_;
+    std::array<std::function<void(Instruction const&)>, static_cast<uint8_t>(OpCode::END)> commands_;
 };
 
 }
\ No newline at end of file
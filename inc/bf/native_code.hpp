@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stddef.h>
+
+#include "bf/mem_arg_types.hpp"
+
+namespace bf {
+
+/**
+ * @brief I/O callbacks handed to native code.
+ *
+ * Native code never touches a Console directly; it calls back through these
+ * plain function pointers with 'context' as the first argument.
+ *
+ * Members:
+ * - void* context: Opaque pointer passed back to the callbacks (the Console).
+ * - void (*output)(void*, CellType): Writes one byte.
+ * - CellType (*input)(void*): Reads one byte.
+ * - void (*output_repeat)(void*, CellType, size_t): Writes one byte n times (folded Output).
+ */
+struct NativeIO {
+    void* context;
+    void (*output)(void* context, CellType c);
+    CellType (*input)(void* context);
+    void (*output_repeat)(void* context, CellType c, size_t count);
+};
+
+/**
+ * @brief Entry point of a compiled program.
+ *
+ * Receives the tape, its size, the starting data pointer index and the I/O callbacks,
+ * and returns the data pointer index at HALT. Both the x86-64 JIT and the C backend
+ * produce functions with this signature (extern "C" calling convention).
+ */
+using NativeEntry = size_t (*)(CellType* tape, size_t size, size_t position, NativeIO* io);
+
+/**
+ * @brief Owns a page-aligned, executable copy of generated machine code.
+ *
+ * The code is copied into an anonymous mmap'd buffer which is then remapped
+ * read + execute (never writable and executable at the same time).
+ *
+ * Members:
+ * - void* buffer_: Start of the mapping.
+ * - size_t size_: Length of the mapping in bytes.
+ */
+class ExecutableBuffer {
+public:
+    /**
+     * @brief Maps the given machine code as executable.
+     *
+     * @param code The machine code bytes.
+     * @throws JitException if the mapping or the protection change fails.
+     */
+    explicit ExecutableBuffer(std::vector<uint8_t> const& code);
+
+    /**
+     * @brief Unmaps the buffer.
+     */
+    ~ExecutableBuffer();
+
+    ExecutableBuffer(ExecutableBuffer const&) = delete;
+    ExecutableBuffer& operator=(ExecutableBuffer const&) = delete;
+
+    /**
+     * @brief Returns the start of the code as a callable entry point.
+     */
+    NativeEntry entry() const;
+
+private:
+    void* buffer_;
+    size_t size_;
+};
+
+/**
+ * @brief Owns a shared object loaded with dlopen.
+ *
+ * Members:
+ * - void* handle_: The dlopen handle.
+ */
+class SharedLibrary {
+public:
+    /**
+     * @brief Loads the shared object at the given path.
+     *
+     * @param path Path of the shared object.
+     * @throws JitException if the library cannot be loaded.
+     */
+    explicit SharedLibrary(std::string const& path);
+
+    /**
+     * @brief Closes the library.
+     */
+    ~SharedLibrary();
+
+    SharedLibrary(SharedLibrary const&) = delete;
+    SharedLibrary& operator=(SharedLibrary const&) = delete;
+
+    /**
+     * @brief Looks up a NativeEntry exported by the library.
+     *
+     * @param symbol Name of the exported function.
+     * @throws JitException if the symbol is missing.
+     */
+    NativeEntry entry(std::string const& symbol) const;
+
+private:
+    void* handle_;
+};
+
+} // namespace bf
@@ -21,6 +21,12 @@ enum class OpCode : uint8_t {
     Input,          ///< Corresponds to ',', accepts one byte of input, storing it at the data pointer.
     LoopStart,      ///< Corresponds to '[', if the byte at the data pointer is zero, jump forward to the command to the matching 'LoopEnd'.
     LoopEnd,        ///< Corresponds to ']', if the byte at the data pointer is nonzero, jump back to the command to the matching 'LoopStart'.
+    Add,            ///< IR: adds 'arg' (mod 256) to the byte at 'offset' from the data pointer - folded run of '+'/'-'.
+    Move,           ///< IR: moves the data pointer by 'arg' cells - folded run of '>'/'<'.
+    SetZero,        ///< IR: clears the byte at 'offset' from the data pointer - replaces '[-]' and '[+]'.
+    MultiplyAdd,    ///< IR: adds 'arg' times the current byte to the byte at 'offset' - copy/multiply loops.
+    ScanLeft,       ///< IR: moves the data pointer left by 'arg' cells until a zero byte is found - replaces '[<]'.
+    ScanRight,      ///< IR: moves the data pointer right by 'arg' cells until a zero byte is found - replaces '[>]'.
     HALT,           ///< Special operation to signify the end of execution.
     END             ///< Marks the end of the opcode list - the number of operations.
 };
@@ -28,8 +34,9 @@ enum class OpCode : uint8_t {
 /**
  * @brief Maps characters from the Brainfuck programming language to their corresponding OpCode.
  *
- * This mapping is utilized by the compiler to translate Brainfuck source code into the
- * corresponding operational codes that the virtual machine can execute.
+ * This mapping defines how Brainfuck source code translates into the operational codes
+ * that the virtual machine can execute. The compiler uses an equivalent 256-entry table
+ * so that classifying a source byte is a single indexed load.
  */
 const std::unordered_map<char, OpCode> op_code_map = {
     {'>', OpCode::MoveRight},
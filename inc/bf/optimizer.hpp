@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+
+#include "bf/operations.hpp"
+#include "bf/instruction.hpp"
+
+namespace bf {
+
+/**
+ * @brief Rewrites a sequence of plain Brainfuck instructions into the optimized IR.
+ *
+ * The optimizer runs an ordered pipeline of passes, each taking the code produced
+ * by the previous one. The default pipeline is:
+ * 1. fold_runs            : '+'/'-' runs become Add(n), '>'/'<' runs become Move(n),
+ *                          '.' runs become Output(n).
+ * 2. lower_clear_loops    : '[-]' / '[+]' (any odd Add) become SetZero.
+ * 3. lower_scan_loops     : '[<]' / '[>]' (any Move) become ScanLeft / ScanRight.
+ * 4. fold_offsets         : Moves between cell updates are folded into the updates' offsets,
+ *                           so '>+>++<<' becomes Add(1, @1), Add(2, @2) with no Move at all.
+ * 5. lower_multiply_loops : balanced copy/multiply loops such as '[->+>++<<]', by now
+ *                           offset-form bodies of Adds, become a series of MultiplyAdd
+ *                           followed by SetZero.
+ *
+ * @details
+ * Members:
+ * - std::vector<Pass> passes_: The passes to run, in order.
+ */
+class Optimizer {
+public:
+    using Pass = std::function<Code(Code const&)>;
+
+    /**
+     * @brief Constructs an Optimizer with the default pass pipeline.
+     */
+    Optimizer();
+
+    /**
+     * @brief Appends a pass to the end of the pipeline.
+     *
+     * @param pass A callable taking the current code and returning the rewritten code.
+     */
+    void add_pass(Pass pass);
+
+    /**
+     * @brief Runs all passes of the pipeline over the given code.
+     *
+     * @param code Code to optimize - plain opcodes or IR, loops need not be linked.
+     * @return Code The optimized code, with loop brackets linked to their jump targets.
+     */
+    Code optimize(Code code) const;
+
+    /**
+     * @brief Folds runs of Increment/Decrement into Add and MoveLeft/MoveRight into Move,
+     *        and consecutive Outputs into a single Output(n).
+     *
+     * Adds that cancel out (mod 256) and moves that cancel out are removed.
+     */
+    static Code fold_runs(Code const& code);
+
+    /**
+     * @brief Replaces loops whose body is a single odd Add with SetZero.
+     */
+    static Code lower_clear_loops(Code const& code);
+
+    /**
+     * @brief Replaces loops whose body is a single Move with ScanLeft/ScanRight.
+     */
+    static Code lower_scan_loops(Code const& code);
+
+    /**
+     * @brief Replaces balanced loops of Add/Move that step the loop counter by one
+     * with MultiplyAdd instructions followed by SetZero.
+     *
+     * Bodies may be plain (Adds between Moves) or offset-form (Adds at offsets, as left by
+     * fold_offsets); both address cell position + offset.
+     */
+    static Code lower_multiply_loops(Code const& code);
+
+    /**
+     * @brief Defers Moves past Add and SetZero by addressing those at an offset instead.
+     *
+     * The accumulated Move is emitted only before an instruction that depends on the data
+     * pointer itself (I/O, loops, scans, MultiplyAdd) and at the end of the code.
+     */
+    static Code fold_offsets(Code const& code);
+
+private:
+    /**
+     * @brief Builds the default pass pipeline.
+     */
+    void build_pipeline();
+
+    /**
+     * @brief Rewrites every innermost loop for which the rewriter returns true.
+     *
+     * @param code The code to scan.
+     * @param rewrite Receives the loop body (without brackets) and fills in the replacement.
+     * @return Code The code with matching loops replaced.
+     */
+    static Code rewrite_innermost_loops(Code const& code, std::function<bool(Code const&, Code&)> const& rewrite);
+
+private:
+    std::vector<Pass> passes_;
+};
+
+} // namespace bf
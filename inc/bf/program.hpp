@@ -1,9 +1,11 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include <stddef.h>
 
 #include <bf/operations.hpp>
+#include <bf/instruction.hpp>
 
 namespace bf {
 
@@ -17,32 +19,41 @@ namespace bf {
  *
  * @details
  * Members:
- * - std::vector<OpCode> instructions_: Holds all operation codes that the program will execute.
+ * - std::shared_ptr<const Code> instructions_: Holds all instructions (opcode and operands) that the program will execute.
  * - size_t ip_: Tracks the current position of the instruction pointer within the instruction list.
- * - std::unordered_map<size_t, size_t> jump_table_: Maps loop start indices ('[') to their
- *   corresponding loop end indices (']') for efficient navigation within loops.
+ * - size_t reach_: How far past a tape end the program can address a cell, see reach().
+ *
+ * The instructions are immutable once constructed and shared between copies, so copying a
+ * Program is cheap: every copy gets its own instruction pointer over the same code. This is
+ * what lets one compiled program run on several VMs at once.
+ *
+ * Loop brackets carry the index of their matching bracket in their 'arg' operand, so taking
+ * a branch is a single indexed load.
  */
 class Program {
 public:
     /**
      * @brief Constructs a Program object with a vector of opcodes.
+     *
+     * Loop brackets are linked to their matching brackets during construction.
      * 
      * @param source A vector of OpCode representing the program's source code.
      */
     Program(std::vector<OpCode> source); 
 
     /**
-     * @brief Constructs a Program object with a list of opcodes and an existing jump table.
+     * @brief Constructs a Program object from already linked instructions.
      *
-     * This constructor can be used when the jump table is already known, avoiding redundant calculations.
-     * 
-     * @param source A vector of OpCode representing the program's instructions.
-     * @param jump_t An existing jump table mapping loop start and end indices.
+     * Used for code produced by the Compiler and the Optimizer, whose loop brackets already
+     * hold their jump targets - no further pass over the code is made. A HALT instruction is
+     * appended if the code does not already end with one.
+     *
+     * @param code The linked instructions, including operand-carrying IR opcodes.
      */
-    Program(std::vector<OpCode> source, std::unordered_map<size_t, size_t> jump_t);
+    Program(Code code);
 
     /**
-     * @brief Default copy constructor.
+     * @brief Default copy constructor - the copy shares the instructions and has its own instruction pointer.
      */
     Program(Program const& other) = default;
 
@@ -70,6 +81,13 @@ public:
      */
     OpCode fetch_current();
 
+    /**
+     * @brief Returns the full instruction (opcode and operands) at the instruction pointer.
+     *
+     * @return const Instruction& The current instruction.
+     */
+    const Instruction& current() const;
+
     /**
      * @brief Jumps the instruction pointer by a specified offset.
      * 
@@ -91,6 +109,13 @@ public:
      */
     void jump_backward_to_matching_start();
 
+    /**
+     * @brief Places the instruction pointer on the final HALT, as if the program had run to completion.
+     *
+     * Used by backends that run the whole program natively and only need to leave it done.
+     */
+    void finish();
+
     /**
      * @brief Checks if the program has finished executing.
      * 
@@ -98,22 +123,43 @@ public:
      */
     bool is_done() const;
 
-    //for debug mode
-    const std::vector<OpCode>& get_instructions() const;
-    const std::unordered_map<size_t, size_t>& get_jump_table() const;
+    /**
+     * @brief Wraps plain opcodes into operand-less instructions.
+     *
+     * @param source The opcodes to wrap.
+     * @return Code The equivalent instruction sequence.
+     */
+    static Code to_code(std::vector<OpCode> const& source);
 
-private:
     /**
-     * @brief Builds a jump table to map loop starts ('[') to their corresponding loop ends (']') and vice versa.
-     * 
-     * This method is called during construction to prepare the program for efficient loop execution.
+     * @brief Stores the index of the matching bracket in the 'arg' of every LoopStart and LoopEnd.
+     *
+     * @param code The code to link in place.
+     * @return bool True if all brackets are matched, false otherwise.
+     */
+    static bool link_loops(Code& code);
+
+    /**
+     * @brief Returns the largest distance, in cells, between a cell the program addresses and
+     * the cell it addressed before.
+     *
+     * Only Moves run between two instructions that touch the tape (loop brackets read it), so
+     * this is bounded by twice the widest cell offset plus the longest run of Moves or scan
+     * step. If every earlier access stayed on the tape, no access lands further than this past
+     * either end - the guard a Boundary::Grow tape needs (see Memory::reserve_guard()).
      */
-    void build_jump_table();
+    size_t reach() const;
+
+    //for debug mode
+    const Code& get_instructions() const;
+
+private:
+    static size_t measure_reach(Code const& code);
 
 private:
-    std::vector<OpCode> instructions_;
+    std::shared_ptr<const Code> instructions_;
     size_t ip_;
-    std::unordered_map<size_t, size_t> jump_table_;
+    size_t reach_;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <stddef.h>
+
+namespace bf {
+
+/**
+ * @brief A Brainfuck source file mapped read-only into memory.
+ *
+ * A regular file is mmap'ed instead of being read into a string, so a multi-megabyte program
+ * is never copied: the compiler walks the mapped pages once, and the kernel is told the
+ * access is sequential so it reads ahead. An empty file has no mapping and an empty view.
+ * Anything else - a pipe, a FIFO, <(...) or /dev/stdin - reports no size up front, so it is
+ * read to its end into a string instead.
+ *
+ * Members:
+ * - const char* data_: Start of the mapping, or nullptr for an empty or streamed file.
+ * - size_t size_: Length of the file in bytes.
+ * - std::string streamed_: Contents of a file that is not a regular file.
+ */
+class SourceFile {
+public:
+    /**
+     * @brief Opens and maps (or reads) the file.
+     *
+     * @param path Path of the source file.
+     * @throws SourceException if the file cannot be opened, inspected, mapped or read.
+     */
+    explicit SourceFile(const std::string& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~SourceFile();
+
+    SourceFile(SourceFile const&) = delete;
+    SourceFile& operator=(SourceFile const&) = delete;
+
+    /**
+     * @brief Returns the whole file contents.
+     */
+    std::string_view view() const;
+
+    /**
+     * @brief Returns the length of the file in bytes.
+     */
+    size_t size() const;
+
+private:
+    const char* data_;
+    size_t size_;
+    std::string streamed_;
+};
+
+} // namespace bf
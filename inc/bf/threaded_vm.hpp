@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include "bf/memory.hpp"
+#include "bf/program.hpp"
+#include "bf/console.hpp"
+#include "bf/instruction.hpp"
+
+namespace bf {
+
+/**
+ * @brief A direct-threaded interpreter for Brainfuck-like programs.
+ *
+ * Executes the same programs as VM, but without the per-instruction calls into Program and
+ * Microcode: the instruction pointer and the data pointer live in local variables, and each
+ * handler jumps straight to the handler of the next instruction. With GCC/Clang the handlers
+ * are dispatched with computed goto (labels as values); other compilers, or builds defining
+ * BF_NO_COMPUTED_GOTO, fall back to a switch inside a loop.
+ *
+ * The edge behaviour of the tape is resolved once per run: a Boundary::Wrap tape keeps its
+ * wrap-around semantics, a Boundary::Grow tape is stepped with no bounds checks at all.
+ * When run() returns, the Memory data pointer and the
+ * Program instruction pointer reflect the final state, exactly as after VM::run().
+ *
+ * run_for() executes under a step budget, where a step is a taken backward branch (one loop
+ * iteration) or one move of a scan - the only ways a program runs for longer than its own
+ * length. A run stopped by the budget can be resumed with another run() or run_for() call.
+ * While metered, the VM also records which cells the run may have written (see touched_begin()).
+ *
+ * Members:
+ * - Memory& memory_: Reference to the Memory instance that stores data cells manipulated by the program.
+ * - Program& program_: Reference to the Program instance that stores the instructions.
+ * - Console& console_: Reference to the Console instance used for input and output operations.
+ * - Index lowest_, highest_: Lowest and highest data pointer positions seen by run_for().
+ * - Index touched_begin_, touched_end_: The cells run_for() may have written, [begin, end).
+ */
+class ThreadedVM {
+public:
+    /**
+     * @brief Constructs a ThreadedVM with references to its main components.
+     *
+     * @param memory Reference to a Memory instance for data storage.
+     * @param program Reference to a Program instance holding the (optionally optimized) instructions.
+     * @param console Reference to a Console instance for handling input and output.
+     */
+    ThreadedVM(Memory& memory, Program& program, Console& console);
+
+    /**
+     * @brief Executes the program from its current instruction until HALT.
+     */
+    void run();
+
+    /**
+     * @brief Executes the program from its current instruction for at most 'step_limit' steps.
+     *
+     * @param step_limit Number of loop iterations and scan moves the run may take.
+     * @return bool True if the program reached HALT, false if the budget ran out first.
+     */
+    bool run_for(size_t step_limit);
+
+    /**
+     * @brief Returns the first cell that a run_for() call may have written.
+     */
+    Index touched_begin() const;
+
+    /**
+     * @brief Returns one past the last cell that a run_for() call may have written.
+     */
+    Index touched_end() const;
+
+private:
+    /**
+     * @brief The interpreter loop, specialized for a tape policy providing 'step(index, delta, size)'
+     * and a meter providing 'tick()' (false stops the run) and 'visit(index)'.
+     *
+     * @return bool True if the program reached HALT.
+     */
+    template <typename Tape, typename Meter>
+    bool execute(Meter& meter);
+
+    /**
+     * @brief Widens the touched range by the cell offsets the program addresses.
+     */
+    void update_touched();
+
+private:
+    Memory& memory_;
+    Program& program_;
+    Console& console_;
+    Index lowest_;
+    Index highest_;
+    Index touched_begin_;
+    Index touched_end_;
+};
+
+} // namespace bf
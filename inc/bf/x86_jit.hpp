@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <stddef.h>
+
+#include "bf/instruction.hpp"
+#include "bf/memory.hpp"
+
+namespace bf {
+
+/**
+ * @brief Translates a program into x86-64 machine code (System V calling convention).
+ *
+ * The generated function has the NativeEntry signature. Register usage:
+ * - rbx : tape base address.
+ * - r12 : data pointer (index into the tape) - lives in a register for the whole run.
+ * - r13 : tape size.
+ * - r14 : NativeIO pointer, used to call back into the Console for '.' and ','.
+ *
+ * For a Boundary::Wrap tape the size is known at translation time, so every pointer move and
+ * offset access is wrapped around the tape edges with a single compare against r13, preserving
+ * the wrap-around semantics of Memory. For a Boundary::Grow tape moves are plain additions.
+ */
+class X86Jit {
+public:
+    /**
+     * @brief Assembles the given instructions.
+     *
+     * Translation stops at the first HALT. Loop brackets must be matched.
+     *
+     * @param code The (optionally optimized) instructions to translate.
+     * @param tape_size Number of cells of the tape the code will run on.
+     * @param boundary Edge behaviour of the tape the code will run on.
+     * @return std::vector<uint8_t> The machine code.
+     */
+    static std::vector<uint8_t> assemble(Code const& code, size_t tape_size, Boundary boundary = Boundary::Wrap);
+};
+
+} // namespace bf
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace img_proc {
+
+/**
+ * @brief Standard allocator returning storage aligned to Alignment bytes.
+ *
+ * Used for pixel planes so every plane starts on a cache line and vector loads never straddle one.
+ *
+ * @tparam T Element type.
+ * @tparam Alignment Power of two, at least alignof(T).
+ */
+template<typename T, std::size_t Alignment>
+class AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not weaken the alignment of T");
+
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(AlignedAllocator<U, Alignment> const&) noexcept {}
+
+    T* allocate(std::size_t count);
+    void deallocate(T* ptr, std::size_t count) noexcept;
+
+    template<typename U>
+    bool operator==(AlignedAllocator<U, Alignment> const&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(AlignedAllocator<U, Alignment> const&) const noexcept { return false; }
+};
+
+/*---------------------------------------------------------*/
+/*                      Implementations                    */
+/*---------------------------------------------------------*/
+
+template<typename T, std::size_t Alignment>
+T* AlignedAllocator<T, Alignment>::allocate(std::size_t count)
+{
+    return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+}
+
+template<typename T, std::size_t Alignment>
+void AlignedAllocator<T, Alignment>::deallocate(T* ptr, std::size_t) noexcept
+{
+    ::operator delete(ptr, std::align_val_t{Alignment});
+}
+
+} // namespace img_proc
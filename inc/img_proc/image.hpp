@@ -6,20 +6,41 @@
 #include <istream>
 #include <ostream>
 #include <type_traits> 
+#include <thread>
 
 #include "img_proc/rgb.hpp"
+#include "img_proc/aligned_allocator.hpp"
+#include "img_proc/image_view.hpp"
 
 namespace img_proc {
 namespace image {
 
+/**
+ * @brief Layout tag: pixels stored as one array of RGB<T> (array of structures).
+ */
+struct Interleaved {};
+
+/**
+ * @brief Layout tag: each channel stored in its own plane (structure of arrays).
+ */
+struct Planar {};
+
+/**
+ * @brief A 2D image of RGB pixels, stored in the given layout.
+ *
+ * @tparam T Unsigned integral type for pixel channels.
+ * @tparam Layout Interleaved (default) or Planar.
+ */
+template<typename T, typename Layout = Interleaved>
+class Image;
+
 /**
  * @brief Represents a 2D image composed of RGB pixels.
  * 
  * @tparam T Unsigned integral type for pixel channels.
  */
 template<typename T>
-class Image {
-    static_assert(!std::is_same_v<T, uint8_t>, "T must not be uint8_t");
+class Image<T, Interleaved> {
     static_assert(!std::is_same_v<T, char>, "T must not be char");
 
 public:
@@ -67,6 +88,30 @@ public:
      */
     RGB<T> operator()(size_t row, size_t column) const;
 
+    /**
+     * @brief Unchecked access to the pixel at (row, column), for hot loops.
+     */
+    RGB<T>& at_unchecked(size_t row, size_t column) noexcept;
+    const RGB<T>& at_unchecked(size_t row, size_t column) const noexcept;
+
+    /**
+     * @brief Returns the first pixel of the given row; rows are width() pixels apart.
+     */
+    RGB<T>* row_ptr(size_t row) noexcept;
+    const RGB<T>* row_ptr(size_t row) const noexcept;
+
+    /**
+     * @brief Returns the width() pixels of the given row.
+     */
+    Span<RGB<T>> row(size_t row) noexcept;
+    Span<const RGB<T>> row(size_t row) const noexcept;
+
+    /**
+     * @brief Returns a view of the whole image (stride == width).
+     */
+    ImageView<RGB<T>> view() noexcept;
+    ImageView<const RGB<T>> view() const noexcept;
+
     /**
      * @brief Compares two images for equality.
      */
@@ -109,33 +154,160 @@ private:
     std::vector<RGB<T>> pixels_;
 };
 
+/**
+ * @brief An image stored as three channel planes (r, g, b).
+ *
+ * Each plane is a contiguous height × stride block of T. The stride pads a row to a whole number
+ * of 64-byte cache lines, so every row of every plane starts aligned and a kernel walking one
+ * channel touches only that channel's memory. Padding samples are zero and not part of the image.
+ *
+ * @tparam T Unsigned integral type for pixel channels.
+ */
+template<typename T>
+class Image<T, Planar> {
+    static_assert(!std::is_same_v<T, char>, "T must not be char");
+
+public:
+    static constexpr size_t alignment = 64;
+    static constexpr size_t channels = 3;
+
+    /**
+     * @brief Default constructor. Creates an empty image (0x0, max_color = 255).
+     */
+    Image() = default;
+
+    /**
+     * @brief Constructs a black image with specified dimensions.
+     * 
+     * @param height Height of the image.
+     * @param width Width of the image.
+     * @param max_color Maximum pixel value.
+     */
+    Image(size_t height, size_t width, size_t max_color);
+
+    /**
+     * @brief Returns the first sample of a channel plane (0 = r, 1 = g, 2 = b).
+     */
+    T* plane(size_t channel) noexcept;
+    const T* plane(size_t channel) const noexcept;
+
+    /**
+     * @brief Returns the first sample of a row in a channel plane.
+     */
+    T* row(size_t channel, size_t row) noexcept;
+    const T* row(size_t channel, size_t row) const noexcept;
+
+    /**
+     * @brief Reads the pixel at (row, column) with bounds checking.
+     */
+    RGB<T> operator()(size_t row, size_t column) const;
+
+    /**
+     * @brief Writes the pixel at (row, column) with bounds checking.
+     */
+    void set(size_t row, size_t column, RGB<T> const& pixel);
+
+    /**
+     * @brief Compares the dimensions, max color and visible pixels of two images.
+     */
+    bool operator==(const Image<T, Planar>& other) const noexcept;
+
+    /**
+     * @brief Returns the number of pixels (width × height).
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Returns the distance, in samples, between the starts of consecutive rows.
+     */
+    size_t stride() const noexcept;
+
+    size_t height() const noexcept;
+    size_t width() const noexcept;
+    size_t max_color() const noexcept;
+
+private:
+    size_t height_{0};
+    size_t width_{0};
+    size_t max_color_{255};
+    size_t stride_{0};
+    std::vector<T, AlignedAllocator<T, alignment>> samples_;
+};
+
+/**
+ * @brief 8-bit image: a third to a half of the memory traffic of 16 or 32-bit channels, for
+ * images whose max color is at most 255. The loaders reject larger max colors for it.
+ */
+using Image8 = Image<uint8_t>;
+
+/**
+ * @brief Splits an interleaved image into channel planes.
+ */
+template<typename T>
+Image<T, Planar> to_planar(Image<T, Interleaved> const& image);
+
+/**
+ * @brief Merges channel planes back into an interleaved image.
+ */
+template<typename T>
+Image<T, Interleaved> to_interleaved(Image<T, Planar> const& image);
+
+/**
+ * @brief Netpbm encodings understood by the loaders and savers.
+ */
+enum class Format {
+    P3,     ///< ASCII RGB (PPM)
+    P4,     ///< Binary bitmap (PBM), one bit per pixel, 1 is black
+    P5,     ///< Binary grayscale (PGM), 1 or 2 big-endian bytes per sample
+    P6      ///< Binary RGB (PPM), 1 or 2 big-endian bytes per channel
+};
+
 /**
  * @brief Loads an image from a file path.
+ *
+ * The file is mapped into memory and decoded in place, the encoding is taken from its magic number.
+ * Grayscale and bitmap images are expanded to RGB; a bitmap loads with max_color 1.
+ * @param threads Number of threads decoding a large P3 raster.
  * @throws FileOpenException if file cannot be opened.
+ * @throws FileASCIIException or FileFormatException if invalid.
  */
 template<typename T>
-Image<T> image_loader(const std::string& file_path);
+Image<T> image_loader(const std::string& file_path, size_t threads = std::thread::hardware_concurrency());
 
 /**
  * @brief Loads an image from an input stream.
  * @throws FileASCIIException or InputStreamException if invalid.
  */
 template<typename T>
-Image<T> image_loader(std::istream& is);
+Image<T> image_loader(std::istream& is, size_t threads = std::thread::hardware_concurrency());
+
+/**
+ * @brief Decodes an image held in memory (any of the Format encodings).
+ *
+ * A P3 raster of a few MiB or more is split at whitespace into chunks that are counted and
+ * then parsed in parallel, each straight into its own pixels.
+ * @throws FileASCIIException or FileFormatException if invalid.
+ */
+template<typename T>
+Image<T> image_decoder(const char* data, size_t size, size_t threads = std::thread::hardware_concurrency());
 
 /**
  * @brief Saves an image to a file path.
  * @throws FileOpenException or OutputStreamException if invalid.
  */
 template<typename T>
-void image_saver(const std::string& file_path, Image<T>& image);
+void image_saver(const std::string& file_path, Image<T> const& image, Format format = Format::P3);
 
 /**
  * @brief Saves an image to an output stream.
+ *
+ * The encoded image is built in a buffer and handed to the stream in large blocks.
+ * P5 stores the gray level of each pixel, P4 stores black below half of max_color.
  * @throws OutputStreamException if invalid.
+ * @throws FileFormatException if max_color does not fit a binary encoding.
  */
 template<typename T>
-void image_saver(std::ostream& os, Image<T>& image);
+void image_saver(std::ostream& os, Image<T> const& image, Format format = Format::P3);
 
 } // namespace image
 } // namespace img_proc
@@ -1,10 +1,17 @@
 #pragma once
 
 #include <fstream>
+#include <iostream>
 #include <stdexcept>
+#include <iterator>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
 
 #include "img_proc/image.hpp"
 #include "img_proc/img_proc_exceptions.hpp"
+#include "img_proc/mapped_file.hpp"
+#include "img_proc/tile_scheduler.hpp"
 
 namespace img_proc::image {
 
@@ -56,6 +63,54 @@ RGB<T> Image<T>::operator()(size_t row, size_t column) const
     return pixels_[row * width_ + column];
 }
 
+template<typename T>
+RGB<T>& Image<T>::at_unchecked(size_t row, size_t column) noexcept
+{
+    return pixels_[row * width_ + column];
+}
+
+template<typename T>
+const RGB<T>& Image<T>::at_unchecked(size_t row, size_t column) const noexcept
+{
+    return pixels_[row * width_ + column];
+}
+
+template<typename T>
+RGB<T>* Image<T>::row_ptr(size_t row) noexcept
+{
+    return pixels_.data() + row * width_;
+}
+
+template<typename T>
+const RGB<T>* Image<T>::row_ptr(size_t row) const noexcept
+{
+    return pixels_.data() + row * width_;
+}
+
+template<typename T>
+Span<RGB<T>> Image<T>::row(size_t row) noexcept
+{
+    return Span<RGB<T>>{row_ptr(row), width_};
+}
+
+template<typename T>
+Span<const RGB<T>> Image<T>::row(size_t row) const noexcept
+{
+    return Span<const RGB<T>>{row_ptr(row), width_};
+}
+
+template<typename T>
+ImageView<RGB<T>> Image<T>::view() noexcept
+{
+    return ImageView<RGB<T>>{pixels_.data(), height_, width_, width_};
+}
+
+template<typename T>
+ImageView<const RGB<T>> Image<T>::view() const noexcept
+{
+    return ImageView<const RGB<T>>{pixels_.data(), height_, width_, width_};
+}
+
 template<typename T>
 bool Image<T>::operator==(const Image<T>& other) const noexcept
 {
@@ -110,77 +165,574 @@ size_t Image<T>::max_color() const noexcept
 }
 
 template<typename T>
-Image<T> image_loader(const std::string& file_path)
+Image<T, Planar>::Image(size_t height, size_t width, size_t max_color)
+: height_{height}
+, width_{width}
+, max_color_{max_color}
+, stride_{(width + alignment / sizeof(T) - 1) / (alignment / sizeof(T)) * (alignment / sizeof(T))}
+, samples_(channels * stride_ * height)
+{
+}
+
+template<typename T>
+T* Image<T, Planar>::plane(size_t channel) noexcept
 {
-    std::ifstream in(file_path);
-    if (!in) {
-        throw FileOpenException(file_path);
+    return samples_.data() + channel * stride_ * height_;
+}
+
+template<typename T>
+const T* Image<T, Planar>::plane(size_t channel) const noexcept
+{
+    return samples_.data() + channel * stride_ * height_;
+}
+
+template<typename T>
+T* Image<T, Planar>::row(size_t channel, size_t row) noexcept
+{
+    return plane(channel) + row * stride_;
+}
+
+template<typename T>
+const T* Image<T, Planar>::row(size_t channel, size_t row) const noexcept
+{
+    return plane(channel) + row * stride_;
+}
+
+template<typename T>
+RGB<T> Image<T, Planar>::operator()(size_t row, size_t column) const
+{
+    if (row >= height_ || column >= width_) {
+        throw OutOfBoundsException();
     }
-    return image_loader<T>(in);
+    size_t index = row * stride_ + column;
+    return RGB<T>{plane(0)[index], plane(1)[index], plane(2)[index]};
 }
 
 template<typename T>
-Image<T> image_loader(std::istream& is)
+void Image<T, Planar>::set(size_t row, size_t column, RGB<T> const& pixel)
 {
-    if (!is) {
-        throw InputStreamException();
+    if (row >= height_ || column >= width_) {
+        throw OutOfBoundsException();
     }
+    size_t index = row * stride_ + column;
+    plane(0)[index] = pixel.r;
+    plane(1)[index] = pixel.g;
+    plane(2)[index] = pixel.b;
+}
 
-    std::string header;
-    if (!(is >> header) || header != "P3") {
-        throw FileASCIIException();
+template<typename T>
+bool Image<T, Planar>::operator==(const Image<T, Planar>& other) const noexcept
+{
+    if (height_ != other.height_ || width_ != other.width_ || max_color_ != other.max_color_) {
+        return false;
     }
+    for (size_t channel = 0; channel < channels; ++channel) {
+        for (size_t y = 0; y < height_; ++y) {
+            if (!std::equal(row(channel, y), row(channel, y) + width_, other.row(channel, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
 
-    while (is.peek() == '#') {
-        std::string skip;
-        std::getline(is, skip);
+template<typename T>
+size_t Image<T, Planar>::size() const noexcept
+{
+    return width_ * height_;
+}
+
+template<typename T>
+size_t Image<T, Planar>::stride() const noexcept
+{
+    return stride_;
+}
+
+template<typename T>
+size_t Image<T, Planar>::height() const noexcept
+{
+    return height_;
+}
+
+template<typename T>
+size_t Image<T, Planar>::width() const noexcept
+{
+    return width_;
+}
+
+template<typename T>
+size_t Image<T, Planar>::max_color() const noexcept
+{
+    return max_color_;
+}
+
+template<typename T>
+Image<T, Planar> to_planar(Image<T, Interleaved> const& image)
+{
+    Image<T, Planar> planar{image.height(), image.width(), image.max_color()};
+    for (size_t y = 0; y < image.height(); ++y) {
+        const RGB<T>* src = &image[y * image.width()];
+        T* r = planar.row(0, y);
+        T* g = planar.row(1, y);
+        T* b = planar.row(2, y);
+        for (size_t x = 0; x < image.width(); ++x) {
+            r[x] = src[x].r;
+            g[x] = src[x].g;
+            b[x] = src[x].b;
+        }
+    }
+    return planar;
+}
+
+template<typename T>
+Image<T, Interleaved> to_interleaved(Image<T, Planar> const& image)
+{
+    Image<T, Interleaved> interleaved{image.height(), image.width(), image.max_color()};
+    for (size_t y = 0; y < image.height(); ++y) {
+        RGB<T>* dst = &interleaved[y * image.width()];
+        const T* r = image.row(0, y);
+        const T* g = image.row(1, y);
+        const T* b = image.row(2, y);
+        for (size_t x = 0; x < image.width(); ++x) {
+            dst[x] = RGB<T>{r[x], g[x], b[x]};
+        }
     }
+    return interleaved;
+}
+
+namespace detail {
+
+inline bool is_space(char c) noexcept
+{
+    // ' ' or one of '\t', '\n', '\v', '\f', '\r', which are contiguous; branch-free so scans vectorize
+    return (c == ' ') | (static_cast<unsigned char>(c - '\t') < 5);
+}
 
-    size_t width, height, max_color;
-    if (!(is >> width >> height) || width == 0 || height == 0) {
+inline bool is_digit(char c) noexcept
+{
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+/**
+ * @brief Read position inside an encoded image.
+ */
+struct Cursor {
+    const char* pos;
+    const char* end;
+};
+
+/**
+ * @brief Skips whitespace and '#' comments, which may appear anywhere in the header.
+ */
+inline void skip_header_space(Cursor& cur) noexcept
+{
+    while (cur.pos != cur.end) {
+        if (is_space(*cur.pos)) {
+            ++cur.pos;
+        } else if (*cur.pos == '#') {
+            while (cur.pos != cur.end && *cur.pos != '\n' && *cur.pos != '\r') {
+                ++cur.pos;
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Parses a decimal value no larger than limit, skipping leading whitespace only.
+ * @throws FileFormatException on a missing or out of range value.
+ */
+inline size_t parse_decimal(Cursor& cur, size_t limit)
+{
+    if (cur.pos == cur.end || !is_digit(*cur.pos)) {
         throw FileFormatException();
     }
+    size_t value = 0;
+    do {
+        value = value * 10 + static_cast<size_t>(*cur.pos - '0');
+        if (value > limit) {
+            throw FileFormatException();
+        }
+        ++cur.pos;
+    } while (cur.pos != cur.end && is_digit(*cur.pos));
+    return value;
+}
 
-    if (!(is >> max_color) || max_color == 0) {
+inline size_t parse_header_value(Cursor& cur, size_t limit)
+{
+    skip_header_space(cur);
+    size_t value = parse_decimal(cur, limit);
+    if (value == 0) {
         throw FileFormatException();
     }
+    return value;
+}
 
-    std::vector<RGB<T>> vec(width * height);
+/**
+ * @brief Parses one P3 raster sample; the raster holds no comments.
+ * @throws FileFormatException unless the sample ends on whitespace or at the end of cur, so a
+ * malformed token is rejected even when it is the last one a chunk parses.
+ */
+inline size_t parse_sample(Cursor& cur, size_t max_color)
+{
+    while (cur.pos != cur.end && is_space(*cur.pos)) {
+        ++cur.pos;
+    }
+    size_t value = parse_decimal(cur, max_color);
+    if (cur.pos != cur.end && !is_space(*cur.pos)) {
+        throw FileFormatException();
+    }
+    return value;
+}
 
-    for (auto& pixel : vec) {
-        T r, g, b;
-        if (!(is >> r >> g >> b)) {
+/**
+ * @brief Appends the decimal digits of value followed by the separator.
+ */
+inline void append_decimal(std::string& out, uint64_t value, char separator)
+{
+    char digits[21];
+    char* first = digits + sizeof digits;
+    *--first = separator;
+    do {
+        *--first = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    out.append(first, digits + sizeof digits);
+}
+
+inline void append_sample(std::string& out, uint64_t value, bool wide)
+{
+    if (wide) {
+        out.push_back(static_cast<char>(value >> 8));
+    }
+    out.push_back(static_cast<char>(value & 0xFF));
+}
+
+inline size_t read_sample(const unsigned char*& src, bool wide) noexcept
+{
+    size_t value = *src++;
+    if (wide) {
+        value = (value << 8) | *src++;
+    }
+    return value;
+}
+
+constexpr size_t encode_block = size_t{1} << 16;   // flush to the stream every 64 KiB
+
+/**
+ * @brief Dimensions and sample range read from a Netpbm header.
+ */
+struct Header {
+    Format format;
+    size_t width;
+    size_t height;
+    size_t max_color;
+};
+
+/**
+ * @brief Parses the magic number, dimensions and max color, leaving cur after the last value.
+ * @throws FileASCIIException for an unsupported magic number, FileFormatException for bad values.
+ */
+template<typename T>
+Header parse_header(Cursor& cur)
+{
+    if (cur.end - cur.pos < 2 || cur.pos[0] != 'P' || cur.pos[1] < '3' || cur.pos[1] > '6') {
+        throw FileASCIIException();
+    }
+    Header header{static_cast<Format>(cur.pos[1] - '3'), 0, 0, 1};
+    cur.pos += 2;
+
+    constexpr size_t dimension_limit = size_t{1} << 24;
+    header.width = parse_header_value(cur, dimension_limit);
+    header.height = parse_header_value(cur, dimension_limit);
+    if (header.format != Format::P4) {
+        constexpr size_t sample_limit = std::numeric_limits<T>::max() < 0xFFFF ? static_cast<size_t>(std::numeric_limits<T>::max()) : 0xFFFF;
+        header.max_color = parse_header_value(cur, sample_limit);
+    }
+    return header;
+}
+
+constexpr size_t decode_chunk = size_t{1} << 20;   // P3 raster bytes per parallel decode task
+
+/**
+ * @brief Counts the whitespace-separated tokens in [begin, end), which starts on whitespace.
+ */
+inline size_t count_tokens(const char* begin, const char* end) noexcept
+{
+    if (begin == end) {
+        return 0;
+    }
+    // A token starts at every non-space character that follows a space
+    size_t count = is_space(*begin) ? 0 : 1;
+    size_t size = static_cast<size_t>(end - begin);
+    for (size_t i = 1; i < size; ++i) {
+        count += static_cast<size_t>(is_space(begin[i - 1]) & !is_space(begin[i]));
+    }
+    return count;
+}
+
+/**
+ * @brief Parses the samples of a P3 raster into width × height pixels.
+ *
+ * A raster of several decode_chunk bytes is cut into chunks that start on whitespace, so no
+ * sample straddles two of them. The chunks' samples are counted in parallel, a prefix sum
+ * gives the index of each chunk's first sample, and the chunks are then parsed in parallel
+ * straight into their pixels. Samples past the last pixel are ignored, as in a serial parse.
+ *
+ * @throws FileFormatException on a missing, malformed or out of range sample.
+ */
+template<typename T>
+void decode_ascii_raster(Cursor cur, RGB<T>* out, Header const& header, size_t threads)
+{
+    static constexpr T RGB<T>::* channels[] = {&RGB<T>::r, &RGB<T>::g, &RGB<T>::b};
+    size_t samples = 3 * header.width * header.height;
+    size_t bytes = static_cast<size_t>(cur.end - cur.pos);
+    size_t chunks = std::min(bytes / decode_chunk, 4 * threads);
+
+    auto parse = [&](Cursor chunk, size_t first, size_t last) {
+        RGB<T>* px = out + first / 3;
+        size_t channel = first % 3;
+        for (size_t i = first; i < last; ++i) {
+            px->*channels[channel] = static_cast<T>(parse_sample(chunk, header.max_color));
+            if (++channel == 3) {
+                channel = 0;
+                ++px;
+            }
+        }
+    };
+
+    if (chunks < 2 || threads < 2) {
+        parse(cur, 0, samples);
+        return;
+    }
+
+    std::vector<const char*> bounds(chunks + 1);
+    bounds[0] = cur.pos;
+    bounds[chunks] = cur.end;
+    for (size_t k = 1; k < chunks; ++k) {
+        const char* p = std::max(cur.pos + bytes / chunks * k, bounds[k - 1]);
+        while (p != cur.end && !is_space(*p)) {
+            ++p;
+        }
+        bounds[k] = p;
+    }
+
+    // first[k] is the index of chunk k's first sample
+    std::vector<size_t> first(chunks + 1);
+    TileScheduler::shared().parallel_for(chunks, threads, [&](size_t k) {
+        first[k + 1] = count_tokens(bounds[k], bounds[k + 1]);
+    });
+    for (size_t k = 0; k < chunks; ++k) {
+        first[k + 1] += first[k];
+    }
+    if (first[chunks] < samples) {
+        throw FileFormatException();
+    }
+
+    TileScheduler::shared().parallel_for(chunks, threads, [&](size_t k) {
+        size_t last = std::min(first[k + 1], samples);
+        if (first[k] < last) {
+            parse(Cursor{bounds[k], bounds[k + 1]}, first[k], last);
+        }
+    });
+}
+
+/**
+ * @brief Returns the size in bytes of one raster row of a binary format.
+ */
+inline size_t binary_row_bytes(Header const& header) noexcept
+{
+    if (header.format == Format::P4) {
+        return (header.width + 7) / 8;
+    }
+    size_t channels = (header.format == Format::P6) ? 3 : 1;
+    return header.width * channels * (header.max_color > 0xFF ? 2 : 1);
+}
+
+/**
+ * @brief Decodes one raster row of a binary format (P4, P5 or P6) into width pixels.
+ */
+template<typename T>
+void decode_binary_row(const unsigned char* src, RGB<T>* out, Header const& header) noexcept
+{
+    bool wide = header.max_color > 0xFF;
+    if (header.format == Format::P6) {
+        for (size_t col = 0; col < header.width; ++col) {
+            T r = static_cast<T>(read_sample(src, wide));
+            T g = static_cast<T>(read_sample(src, wide));
+            T b = static_cast<T>(read_sample(src, wide));
+            out[col] = RGB<T>(r, g, b);
+        }
+    } else if (header.format == Format::P5) {
+        for (size_t col = 0; col < header.width; ++col) {
+            T level = static_cast<T>(read_sample(src, wide));
+            out[col] = RGB<T>(level, level, level);
+        }
+    } else {
+        for (size_t col = 0; col < header.width; ++col) {
+            bool black = (src[col / 8] >> (7 - col % 8)) & 1;
+            T level = black ? T{0} : T{1};
+            out[col] = RGB<T>(level, level, level);
+        }
+    }
+}
+
+/**
+ * @brief Appends the header for an image of the given format, dimensions and max color.
+ */
+inline void append_header(std::string& out, Header const& header)
+{
+    out.push_back('P');
+    out.push_back(static_cast<char>('3' + static_cast<int>(header.format)));
+    out.push_back('\n');
+    append_decimal(out, header.width, ' ');
+    append_decimal(out, header.height, '\n');
+    if (header.format != Format::P4) {
+        append_decimal(out, header.max_color, '\n');
+    }
+}
+
+/**
+ * @brief Appends one raster row of width pixels in the header's format.
+ */
+template<typename T>
+void append_row(std::string& out, const RGB<T>* px, Header const& header)
+{
+    bool wide = header.max_color > 0xFF;
+    switch (header.format) {
+    case Format::P3:
+        for (size_t col = 0; col < header.width; ++col) {
+            append_decimal(out, static_cast<uint64_t>(px[col].r), ' ');
+            append_decimal(out, static_cast<uint64_t>(px[col].g), ' ');
+            append_decimal(out, static_cast<uint64_t>(px[col].b), ' ');
+        }
+        out.back() = '\n';
+        break;
+    case Format::P6:
+        for (size_t col = 0; col < header.width; ++col) {
+            append_sample(out, static_cast<uint64_t>(px[col].r), wide);
+            append_sample(out, static_cast<uint64_t>(px[col].g), wide);
+            append_sample(out, static_cast<uint64_t>(px[col].b), wide);
+        }
+        break;
+    case Format::P5:
+        for (size_t col = 0; col < header.width; ++col) {
+            append_sample(out, static_cast<uint64_t>(px[col].to_intensity()), wide);
+        }
+        break;
+    case Format::P4:
+        for (size_t col = 0; col < header.width; col += 8) {
+            unsigned char bits = 0;
+            for (size_t bit = 0; bit < 8 && col + bit < header.width; ++bit) {
+                if (2 * static_cast<uint64_t>(px[col + bit].to_intensity()) < header.max_color) {
+                    bits |= static_cast<unsigned char>(0x80 >> bit);
+                }
+            }
+            out.push_back(static_cast<char>(bits));
+        }
+        break;
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+Image<T> image_loader(const std::string& file_path, size_t threads)
+{
+    MappedFile file(file_path);
+    return image_decoder<T>(file.data(), file.size(), threads);
+}
+
+template<typename T>
+Image<T> image_loader(std::istream& is, size_t threads)
+{
+    if (!is) {
+        throw InputStreamException();
+    }
+
+    std::string data{std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+    return image_decoder<T>(data.data(), data.size(), threads);
+}
+
+template<typename T>
+Image<T> image_decoder(const char* data, size_t size, size_t threads)
+{
+    detail::Cursor cur{data, data + size};
+    detail::Header header = detail::parse_header<T>(cur);
+    size_t width = header.width;
+    size_t height = header.height;
+    size_t max_color = header.max_color;
+
+    if (header.format == Format::P3) {
+        // Every sample takes at least a separator and a digit
+        if (static_cast<size_t>(cur.end - cur.pos) / 6 < width * height) {
             throw FileFormatException();
         }
-        pixel = RGB<T>(r, g, b);
+        std::vector<RGB<T>> vec(width * height);
+        detail::decode_ascii_raster(cur, vec.data(), header, threads);
+        return Image<T>(std::move(vec), height, width, max_color);
+    }
+
+    // A single whitespace character separates the header from the binary raster
+    if (cur.pos == cur.end || !detail::is_space(*cur.pos)) {
+        throw FileFormatException();
+    }
+    ++cur.pos;
+
+    size_t row_bytes = detail::binary_row_bytes(header);
+    if (static_cast<size_t>(cur.end - cur.pos) / row_bytes < height) {
+        throw FileFormatException();
+    }
+
+    std::vector<RGB<T>> vec(width * height);
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(cur.pos);
+    for (size_t row = 0; row < height; ++row) {
+        detail::decode_binary_row(src + row * row_bytes, vec.data() + row * width, header);
     }
 
     return Image<T>(std::move(vec), height, width, max_color);
 }
 
 template<typename T>
-void image_saver(const std::string& file_path, Image<T>& image)
+void image_saver(const std::string& file_path, Image<T> const& image, Format format)
 {
-    std::ofstream out(file_path);
+    std::ofstream out(file_path, std::ios::binary);
     if (!out) {
         throw FileOpenException(file_path);
     }
-    image_saver(out, image);
+    image_saver(out, image, format);
 }
 
 template<typename T>
-void image_saver(std::ostream& os, Image<T>& image)
+void image_saver(std::ostream& os, Image<T> const& image, Format format)
 {
     if (!os) {
         throw OutputStreamException();
     }
 
-    os << "P3\n" << image.width() << ' ' << image.height() << '\n' << image.max_color() << '\n';
+    size_t max_color = image.max_color();
+    if (format != Format::P3 && (max_color == 0 || max_color > 0xFFFF)) {
+        throw FileFormatException();
+    }
+
+    std::string out;
+    out.reserve(detail::encode_block + image.width() * 24);
+
+    detail::Header header{format, image.width(), image.height(), max_color};
+    detail::append_header(out, header);
     for (size_t row = 0; row < image.height(); ++row) {
-        for (size_t col = 0; col < image.width(); ++col) {
-            os << image(row, col);
+        detail::append_row(out, &image[row * image.width()], header);
+
+        if (out.size() >= detail::encode_block) {
+            os.write(out.data(), static_cast<std::streamsize>(out.size()));
+            out.clear();
         }
-        os << '\n';
+    }
+
+    os.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!os) {
+        throw OutputStreamException();
     }
 }
 
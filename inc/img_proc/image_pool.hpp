@@ -0,0 +1,61 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "img_proc/image.hpp"
+
+namespace img_proc {
+
+/**
+ * @brief Recycles image buffers between frames of the same size.
+ *
+ * A released image is kept idle, and a later acquire for the same number of pixels takes it
+ * back instead of allocating. Its pixels still hold whatever was last written to them, so
+ * acquire suits outputs that are about to be overwritten in full. The pool is safe to share
+ * between threads, e.g. between a decoder producing frames and a worker consuming them.
+ *
+ * Members:
+ * - capacity_: Maximum number of idle images kept; releasing more frees the image.
+ * - idle_: Released images waiting for reuse.
+ * - mutex_: Guards idle_.
+ */
+template<typename T>
+class ImagePool {
+public:
+    explicit ImagePool(size_t capacity = 8);
+
+    ImagePool(ImagePool const&) = delete;
+    ImagePool& operator=(ImagePool const&) = delete;
+
+    /**
+     * @brief Returns a height × width image, reusing an idle one of the same pixel count if any.
+     */
+    Image<T> acquire(size_t height, size_t width, size_t max_color);
+
+    /**
+     * @brief Hands an image back for reuse; it is freed if the pool already holds capacity images.
+     */
+    void release(Image<T>&& image);
+
+    /**
+     * @brief Returns the number of idle images.
+     */
+    size_t size() const;
+
+    size_t capacity() const noexcept;
+
+    /**
+     * @brief Frees every idle image.
+     */
+    void clear();
+
+private:
+    size_t capacity_;
+    std::vector<Image<T>> idle_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace img_proc
+
+#include "img_proc/image_pool.inl"
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+
+#include "img_proc/image_pool.hpp"
+
+namespace img_proc {
+
+template<typename T>
+ImagePool<T>::ImagePool(size_t capacity)
+: capacity_{capacity}
+{
+}
+
+template<typename T>
+Image<T> ImagePool<T>::acquire(size_t height, size_t width, size_t max_color)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto match = std::find_if(idle_.begin(), idle_.end(), [&](Image<T> const& image) {
+            return image.size() == height * width;
+        });
+        if (match != idle_.end()) {
+            Image<T> image = std::move(*match);
+            idle_.erase(match);
+            image.resize(height, width, max_color);
+            return image;
+        }
+    }
+    return Image<T>{height, width, max_color};
+}
+
+template<typename T>
+void ImagePool<T>::release(Image<T>&& image)
+{
+    if (image.size() == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < capacity_) {
+        idle_.push_back(std::move(image));
+    }
+}
+
+template<typename T>
+size_t ImagePool<T>::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+template<typename T>
+size_t ImagePool<T>::capacity() const noexcept
+{
+    return capacity_;
+}
+
+template<typename T>
+void ImagePool<T>::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.clear();
+}
+
+} // namespace img_proc
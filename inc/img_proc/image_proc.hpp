@@ -3,58 +3,312 @@
 #include <string>
 #include <vector>
 #include <thread>
+#include <array>
 
 #include "img_proc/image_proc_interface.hpp"
 #include "img_proc/thread_wrkr.hpp"
+#include "img_proc/tile_scheduler.hpp"
 #include "img_proc/image.hpp"
 
 namespace img_proc {
 
+namespace detail {
+
+/**
+ * @brief Convolves one tile, channel by channel, with the outer product of two odd 1D kernels.
+ *
+ * The horizontal kernel runs over rows padded by edge replication, the vertical kernel over
+ * the horizontally filtered rows; both accumulate with simd::multiply_add.
+ *
+ * @param load load(channel, y, out) widens the halo columns of row y into out.
+ * @param store store(channel, y, sums) narrows the filtered tile columns of row y.
+ */
+template<typename Load, typename Store>
+void convolve_tile(Tile const& tile, std::vector<float> const& horizontal, std::vector<float> const& vertical,
+                   Load const& load, Store const& store);
+
+/**
+ * @brief convolve_tile over interleaved pixels, as StencilTransformer::transform_tile takes them.
+ * @param absolute Keep the magnitude of the response instead of clamping negatives to zero.
+ */
+template<typename T>
+void convolve_interleaved(ImageView<const RGB<T>> src, Tile const& tile, ImageView<RGB<T>> dst, size_t max_color,
+                          std::vector<float> const& horizontal, std::vector<float> const& vertical, bool absolute);
+
+} // namespace detail
+
 template<typename T>
-class NullTransformer : public ImageTransformer<T> {
+class NullTransformer : public PointwiseTransformer<T> {
 public:
-    Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+    void prepare(size_t max_color) override;
+    void transform_span(const RGB<T>* src, RGB<T>* dst, size_t count) const override;
 };
 
+/**
+ * @brief Quantizes every channel to evenly spaced levels; two levels means black and white.
+ *
+ * prepare() resolves the nearest level of every channel value up to max_color once, so
+ * quantizing a channel is a single table load.
+ */
 template<typename T>
-class ColorReduction : public ImageTransformer<T> {
+class ColorReduction : public PointwiseTransformer<T> {
 public:
     explicit ColorReduction(size_t channel_levels = 2);
-    Image<T> transform_to_bw(Image<T> const& original_image) const;
-    Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+    Image<T> transform_to_bw(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) const;
+    void transform_to_bw(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency()) const;
+
+    using PointwiseTransformer<T>::transform_image;
+    void prepare(size_t max_color) override;
+    void transform_span(const RGB<T>* src, RGB<T>* dst, size_t count) const override;
+
+    /**
+     * @brief Planar overload: quantizes each channel plane through the table.
+     */
+    Image<T, Planar> transform_image(Image<T, Planar> const& original_image, size_t threads = std::thread::hardware_concurrency());
+
+private:
+    static void to_bw_span(const RGB<T>* src, RGB<T>* dst, size_t count, T upper_bound);
 
 private:
     size_t levels_;
+    T upper_bound_{0};
+    std::vector<T> levels_table_;   // nearest level of every value in [0, upper_bound_]
+};
+
+/**
+ * @brief Reduces the image to a palette of colors fitted to it with k-means.
+ *
+ * Unlike ColorReduction's fixed levels, the palette depends on the whole image, so this is
+ * not a point-wise transformer. Seeds are drawn by k-means++ (with a fixed seed) from an even
+ * sample of the pixels; Lloyd iterations then run over every pixel. Each part of the rows is
+ * assigned by simd::nearest in short float batches and summed into accumulators of its own,
+ * merged once per iteration, so no pixel is copied into a per-color container. Iterating
+ * stops when no entry moves by half a level or more, or after max_iterations.
+ */
+template<typename T>
+class PaletteReduction : public ImageTransformer<T> {
+public:
+    /**
+     * @throws InvalidPaletteSizeException if colors is zero.
+     */
+    explicit PaletteReduction(size_t colors = 16, size_t max_iterations = 8);
+    Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+    void transform_into(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency()) override;
+
+    /**
+     * @brief Returns the palette fitted by the last transform; fewer than colors entries when
+     * the image has fewer distinct colors.
+     */
+    std::vector<RGB<T>> const& palette() const noexcept;
+
+private:
+    /**
+     * @brief Palette entries as float channel arrays, the layout simd::nearest reads.
+     */
+    struct Centroids {
+        std::vector<float> r;
+        std::vector<float> g;
+        std::vector<float> b;
+    };
+
+    Centroids seed(Image<T> const& image) const;
+
+    /**
+     * @brief Finds the nearest entry of every pixel, the rows split into parts run in parallel.
+     *
+     * Calls visit(part, row, col, entry, count) for each batch of count pixels starting at
+     * (row, col), where entry[i] is the nearest entry of pixel (row, col + i).
+     */
+    template<typename Visit>
+    static void assign(Image<T> const& image, Centroids const& centroids, size_t parts, size_t threads, Visit const& visit);
+
+private:
+    size_t colors_;
+    size_t max_iterations_;
+    std::vector<RGB<T>> palette_;
 };
 
+/**
+ * @brief Replaces every block_size × block_size block with its average color.
+ *
+ * Block sums come from a summed-area table built in parallel, so a block costs four lookups
+ * whatever its size, and the averages live in one flat row-major buffer.
+ */
 template<typename T>
 class Pixelator : public ImageTransformer<T> {
 public:
     explicit Pixelator(size_t block_size);
     Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+    void transform_into(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency()) override;
 
 private:
-    // std::vector<std::vector<RGB<T>>> compute_relevant_block_averages(Image<T> const& image, size_t start_row, size_t end_row) const;
-    // RGB<T> compute_block_average(Image<T> const& image, size_t block_row, size_t block_col) const;
-    std::vector<std::vector<RGB<T>>> precompute_block_averages(Image<T> const& image) const;
+    /**
+     * @brief Returns the (height + 1) × (width + 1) table of 64-bit channel sums of the pixels above and left.
+     */
+    std::vector<RGB<uint64_t>> summed_area_table(Image<T> const& image, size_t threads) const;
+
+    /**
+     * @brief Returns the block averages, blocks_y × blocks_x in row-major order.
+     */
+    std::vector<RGB<T>> precompute_block_averages(Image<T> const& image, size_t threads) const;
 
 private:
     size_t block_size_;
 };
 
+/**
+ * @brief Gaussian blur as two 1D passes (horizontal, then vertical) over float channel planes.
+ *
+ * Borders are replicated once per row into a padded scratch row, so the tap loops never clamp.
+ * Kernels wider than box_threshold that cover ±3 sigma are approximated by three successive
+ * box blurs, which cost O(1) per pixel whatever the kernel size.
+ */
 template<typename T>
-class GaussianBlur : public ImageTransformer<T> {
+class GaussianBlur : public StencilTransformer<T> {
 public:
+    static constexpr size_t box_threshold = 31;
+
+    /**
+     * @throws InvalidKernelSizeException if kernel_size is even.
+     */
     explicit GaussianBlur(size_t kernel_size = 5, double sigma = 1.0);
     Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
 
+    /**
+     * @brief Planar overload: blurs the channel planes directly, without a layout conversion.
+     */
+    Image<T, Planar> transform_image(Image<T, Planar> const& original_image, size_t threads = std::thread::hardware_concurrency());
+
+    size_t halo() const noexcept override;
+    bool tileable() const noexcept override;
+    void transform_tile(ImageView<const RGB<T>> src, Tile const& tile, ImageView<RGB<T>> dst,
+                        size_t max_color) const override;
+
 private:
-    std::vector<std::vector<double>> generate_gaussian_kernel(int size, double sigma) const;
-    RGB<T> apply_kernel_to_pixel(Image<T> const& image, std::vector<std::vector<double>> const& kernel, int y, int x, int half_k) const;
+    std::vector<float> generate_gaussian_kernel(size_t size, double sigma) const;
+    std::array<size_t, 3> box_radii() const;
+    bool uses_box_blur() const noexcept;
+
+    void blur_separable(Image<T, Planar> const& original_image, Image<T, Planar>& image_transformed, size_t threads) const;
+
+    void blur_boxes(Image<T, Planar> const& original_image, Image<T, Planar>& image_transformed, size_t threads) const;
 
 private:
     size_t kernel_size_;
     double sigma_;
+    std::vector<float> kernel_;
+};
+
+/**
+ * @brief Convolves with the outer product of a horizontal and a vertical 1D kernel.
+ *
+ * Runs the same two float passes as GaussianBlur, with edge replication at the borders. With
+ * absolute set the magnitude of the response is kept, which edge detectors need; otherwise
+ * negative responses clamp to zero.
+ */
+template<typename T>
+class SeparableConvolution : public StencilTransformer<T> {
+public:
+    /**
+     * @throws InvalidKernelSizeException if either kernel is empty or of even length.
+     */
+    SeparableConvolution(std::vector<float> horizontal, std::vector<float> vertical, bool absolute = false);
+
+    /**
+     * @brief size × size mean filter.
+     */
+    static SeparableConvolution box(size_t size);
+
+    /**
+     * @brief [-amount, 1 + 2 * amount, -amount] in both directions; the weights add up to one.
+     */
+    static SeparableConvolution sharpen(float amount = 0.5f);
+
+    /**
+     * @brief Magnitude of the horizontal (x) or vertical (y) Sobel gradient, divided by 4 so a
+     * full-range step maps to max_color.
+     */
+    static SeparableConvolution sobel_x();
+    static SeparableConvolution sobel_y();
+
+    Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+    void transform_into(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency()) override;
+
+    size_t halo() const noexcept override;
+    bool tileable() const noexcept override;
+    void transform_tile(ImageView<const RGB<T>> src, Tile const& tile, ImageView<RGB<T>> dst,
+                        size_t max_color) const override;
+
+private:
+    std::vector<float> horizontal_;
+    std::vector<float> vertical_;
+    bool absolute_;
+};
+
+/**
+ * @brief Resampling filters for Resize.
+ */
+enum class ResizeFilter {
+    Bilinear,   ///< Triangle, radius 1
+    Bicubic,    ///< Keys cubic with a = -0.5, radius 2
+    Lanczos3    ///< Windowed sinc, radius 3
+};
+
+/**
+ * @brief Resamples the image to a new size with a separable filter.
+ *
+ * The source taps and weights of every output column and row are computed once per call; when
+ * shrinking, the filter is widened by the scale factor so the result is antialiased. The
+ * horizontal pass writes float channel rows, and the vertical pass accumulates whole output
+ * rows with simd::multiply_add.
+ */
+template<typename T>
+class Resize : public ImageTransformer<T> {
+public:
+    /**
+     * @throws InvalidDimensionsException if height or width is zero.
+     */
+    Resize(size_t height, size_t width, ResizeFilter filter = ResizeFilter::Bilinear);
+    Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+    void transform_into(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency()) override;
+
+private:
+    /**
+     * @brief count source indices (clamped to the image) and normalized weights per output sample.
+     */
+    struct Taps {
+        size_t count;
+        std::vector<size_t> index;
+        std::vector<float> weight;
+    };
+
+    static Taps compute_taps(size_t source_size, size_t target_size, ResizeFilter filter);
+    static double filter_radius(ResizeFilter filter) noexcept;
+    static double filter_weight(ResizeFilter filter, double x) noexcept;
+
+private:
+    size_t height_;
+    size_t width_;
+    ResizeFilter filter_;
+};
+
+/**
+ * @brief Spreads each channel's values over [0, max_color] through its cumulative histogram.
+ *
+ * Each thread counts its share of the rows into histograms of its own, which are merged once
+ * at the end, so counting takes no atomics or locks. The mapping is then a table lookup.
+ */
+template<typename T>
+class HistogramEqualization : public ImageTransformer<T> {
+public:
+    Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+    void transform_into(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency()) override;
+
+private:
+    /**
+     * @brief Maps every value in [0, max_color] of one channel through its normalized cumulative count.
+     */
+    static std::vector<T> equalization_table(const uint64_t* histogram, size_t pixels, size_t max_color);
 };
 
 } // namespace img_proc
@@ -8,33 +8,109 @@
 #include <tuple>
 #include <cmath>
 #include <cstdint>
+#include <numeric>
+#include <random>
+#include <limits>
 
 #include "img_proc/image_proc.hpp"
 #include "img_proc/rgb.hpp"
 #include "img_proc/thread_wrkr.hpp"
+#include "img_proc/tile_scheduler.hpp"
 #include "img_proc/img_proc_exceptions.hpp"
+#include "img_proc/simd.hpp"
 
 namespace img_proc {
 
-template<typename T>
-Image<T> NullTransformer<T>::transform_image(Image<T> const& original_image, size_t threads)
+namespace detail {
+
+template<typename Load, typename Store>
+void convolve_tile(Tile const& tile, std::vector<float> const& horizontal, std::vector<float> const& vertical,
+                   Load const& load, Store const& store)
 {
-    Image<T> image_transformed = Image<T>{original_image.height(), original_image.width(), original_image.max_color()};
+    // The horizontal pass covers the rows the vertical taps reach, the vertical pass the tile's own rows.
+    // Clamping to the halo rectangle is clamping to the image, as the rectangle is clipped to it.
+    size_t horizontal_half = horizontal.size() / 2;
+    size_t vertical_half = vertical.size() / 2;
+    size_t cols = tile.col_end - tile.col_begin;
+    size_t loaded = tile.halo_col_end - tile.halo_col_begin;
+    size_t skip = tile.col_begin - tile.halo_col_begin;        // loaded columns left of the tile
+    size_t first_row = std::max(tile.halo_row_begin, tile.row_begin > vertical_half ? tile.row_begin - vertical_half : 0);
+    size_t last_row = std::min(tile.halo_row_end, tile.row_end + vertical_half);
+    std::vector<float> band((last_row - first_row) * cols);
+    std::vector<float> padded(loaded + 2 * horizontal_half);
+    std::vector<float> sums(cols);
+
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        for (size_t y = first_row; y < last_row; ++y) {
+            float* inner = padded.data() + horizontal_half;
+            load(channel, y, inner);
+            std::fill(padded.data(), inner, inner[0]);
+            std::fill(inner + loaded, padded.data() + padded.size(), inner[loaded - 1]);
+
+            float* out = band.data() + (y - first_row) * cols;
+            std::fill(out, out + cols, 0.0f);
+            for (size_t k = 0; k < horizontal.size(); ++k) {
+                simd::multiply_add(out, padded.data() + skip + k, horizontal[k], cols);
+            }
+        }
 
-    ThreadWorker worker(threads);
-    worker.run(original_image.height(),
-        [&original_image, &image_transformed](std::size_t start_row, std::size_t end_row) {
-            for (size_t row = start_row; row < end_row; ++row) {
-                for (size_t col = 0; col < original_image.width(); ++col) {
-                    image_transformed(row, col) = original_image(row, col);
-                }
+        for (size_t y = tile.row_begin; y < tile.row_end; ++y) {
+            std::fill(sums.begin(), sums.end(), 0.0f);
+            for (size_t k = 0; k < vertical.size(); ++k) {
+                size_t source = std::clamp(y + k, first_row + vertical_half, last_row - 1 + vertical_half) - vertical_half;
+                simd::multiply_add(sums.data(), band.data() + (source - first_row) * cols, vertical[k], cols);
             }
+            store(channel, y, sums.data());
         }
-    );
+    }
+}
 
-    return image_transformed;
+template<typename T>
+void convolve_interleaved(ImageView<const RGB<T>> src, Tile const& tile, ImageView<RGB<T>> dst, size_t max_color,
+                          std::vector<float> const& horizontal, std::vector<float> const& vertical, bool absolute)
+{
+    static constexpr T RGB<T>::* channels[] = {&RGB<T>::r, &RGB<T>::g, &RGB<T>::b};
+    float upper_bound = static_cast<float>(max_color);
+    size_t cols = tile.col_end - tile.col_begin;
+    std::vector<T> narrowed(cols);
+    std::vector<float> magnitude(absolute ? cols : 0);
+
+    convolve_tile(tile, horizontal, vertical,
+        [&](size_t channel, size_t y, float* out) {
+            const RGB<T>* row = src.row_ptr(y - tile.halo_row_begin);
+            for (size_t x = 0; x < src.width(); ++x) {
+                out[x] = static_cast<float>(row[x].*channels[channel]);
+            }
+        },
+        [&](size_t channel, size_t y, const float* sums) {
+            if (absolute) {
+                for (size_t x = 0; x < cols; ++x) {
+                    magnitude[x] = std::fabs(sums[x]);
+                }
+                sums = magnitude.data();
+            }
+            simd::narrow(sums, narrowed.data(), cols, upper_bound);
+            RGB<T>* row = dst.row_ptr(y - tile.row_begin);
+            for (size_t x = 0; x < cols; ++x) {
+                row[x].*channels[channel] = narrowed[x];
+            }
+        });
 }
 
+} // namespace detail
+
+template<typename T>
+void NullTransformer<T>::prepare(size_t)
+{
+}
+
+template<typename T>
+void NullTransformer<T>::transform_span(const RGB<T>* src, RGB<T>* dst, size_t count) const
+{
+    if (src != dst) {
+        std::copy(src, src + count, dst);
+    }
+}
 
 template<typename T>
 ColorReduction<T>::ColorReduction(size_t channel_levels)
@@ -43,76 +119,136 @@ ColorReduction<T>::ColorReduction(size_t channel_levels)
 }
 
 template<typename T>
-using Quantizer = std::function<T(T)>;
+void ColorReduction<T>::to_bw_span(const RGB<T>* src, RGB<T>* dst, size_t count, T upper_bound)
+{
+    constexpr size_t chunk = 256;
+    T intensity[chunk];
+    for (size_t first = 0; first < count; first += chunk) {
+        size_t n = std::min(chunk, count - first);
+        simd::intensity(src + first, intensity, n);
+        for (size_t i = 0; i < n; ++i) {
+            dst[first + i] = (intensity[i] < upper_bound / 2) ? RGB<T>::black() : RGB<T>::white();
+        }
+    }
+}
 
 template<typename T>
-static std::array<Quantizer<T>, 3> make_quantizers(std::vector<T> const& bins) {
-    return {
-        [&bins](T r) {
-            return *std::min_element(bins.begin(), bins.end(), [r](T a, T b) {
-                return std::abs(a - r) < std::abs(b - r);
-            });
-        },
-        [&bins](T g) {
-            return *std::min_element(bins.begin(), bins.end(), [g](T a, T b) {
-                return std::abs(a - g) < std::abs(b - g);
-            });
-        },
-        [&bins](T b) {
-            return *std::min_element(bins.begin(), bins.end(), [b](T a, T b2) {
-                return std::abs(a - b) < std::abs(b2 - b);
-            });
-        }
-    };
+Image<T> ColorReduction<T>::transform_to_bw(Image<T> const& original_image, size_t threads) const {
+    Image<T> image_transformed;
+    transform_to_bw(original_image, image_transformed, threads);
+    return image_transformed;
 }
 
 template<typename T>
-Image<T> ColorReduction<T>::transform_to_bw(Image<T> const& original_image) const {
-    Image<T> image_transformed = Image<T>{original_image.height(), original_image.width(), original_image.max_color()};
+void ColorReduction<T>::transform_to_bw(Image<T> const& original_image, Image<T>& out, size_t threads) const {
+    out.resize(original_image.height(), original_image.width(), original_image.max_color());
 
     T upper_bound = original_image.max_color();
-    image_transformed = original_image;
-    for (size_t i = 0; i < image_transformed.size(); ++i) {
-        T intensity = original_image[i].to_intensity();
-        image_transformed[i] = (intensity < upper_bound / 2) ? RGB<T>::black() : RGB<T>::white();
-    }
-    return image_transformed;
+    size_t width = original_image.width();
+    auto shape = TileScheduler::tile_shape_for(original_image.height(), width, sizeof(RGB<T>));
+    TileScheduler::shared().run_tiles(original_image.height(), width, shape, 0, threads,
+        [&](Tile const& tile) {
+            for (size_t row = tile.row_begin; row < tile.row_end; ++row) {
+                to_bw_span(original_image.row_ptr(row) + tile.col_begin, out.row_ptr(row) + tile.col_begin,
+                           tile.col_end - tile.col_begin, upper_bound);
+            }
+        });
 }
 
 template<typename T>
-Image<T> ColorReduction<T>::transform_image(Image<T> const& original_image, size_t threads)
+void ColorReduction<T>::prepare(size_t max_color)
 {
+    upper_bound_ = static_cast<T>(max_color);
+
     // Special case for black-and-white conversion
-    if(levels_ == 2) {
-        return transform_to_bw(original_image);
+    if (levels_ == 2) {
+        return;
     }
 
-    Image<T> image_transformed = Image<T>{original_image.height(), original_image.width(), original_image.max_color()};
-
     std::vector<T> bins(levels_);
-    size_t upper_bound = original_image.max_color();
-    size_t step = upper_bound / (levels_ - 1);
-
+    size_t step = max_color / (levels_ - 1);
     bins[0] = 0;
     for(size_t i = 1; i < levels_ - 1; ++i) {
         bins[i] = bins[i - 1] + step;
     }
-    bins[levels_ - 1] = std::min(static_cast<T>(upper_bound), static_cast<T>(bins[levels_ - 2] + step));
+    bins[levels_ - 1] = std::min(static_cast<T>(max_color), static_cast<T>(bins[levels_ - 2] + step));
+
+    // Bins never decrease, so one sweep finds every nearest bin; ties keep the lower bin
+    levels_table_.resize(max_color + 1);
+    size_t bin = 0;
+    for (size_t value = 0; value <= max_color; ++value) {
+        auto distance = [value](T level) {
+            return value > level ? value - level : level - value;
+        };
+        while (bin + 1 < levels_ && distance(bins[bin + 1]) < distance(bins[bin])) {
+            ++bin;
+        }
+        levels_table_[value] = bins[bin];
+    }
+}
+
+template<typename T>
+void ColorReduction<T>::transform_span(const RGB<T>* src, RGB<T>* dst, size_t count) const
+{
+    if (levels_ == 2) {
+        to_bw_span(src, dst, count, upper_bound_);
+        return;
+    }
 
-    auto quantizers = make_quantizers<T>(bins);
+    const T* table = levels_table_.data();
+    size_t last = upper_bound_;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = RGB<T>{table[std::min<size_t>(src[i].r, last)],
+                        table[std::min<size_t>(src[i].g, last)],
+                        table[std::min<size_t>(src[i].b, last)]};
+    }
+}
 
-    ThreadWorker worker(threads);
+template<typename T>
+Image<T, Planar> ColorReduction<T>::transform_image(Image<T, Planar> const& original_image, size_t threads)
+{
+    Image<T, Planar> image_transformed{original_image.height(), original_image.width(), original_image.max_color()};
+    auto shape = TileScheduler::tile_shape_for(original_image.height(), original_image.width(), 2 * sizeof(T));
 
-    worker.run(original_image.height(), 
-        [&original_image, &image_transformed, &quantizers](std::size_t start, std::size_t end) {
-            for(std::size_t y = start; y < end; ++y) {
-                for(std::size_t x = 0; x < original_image.width(); ++x) {
-                    const RGB<T>& orig_px = original_image(y, x);
-                    RGB<T>& px = image_transformed(y, x);
+    if (levels_ == 2) {
+        T upper_bound = original_image.max_color();
+        T black = RGB<T>::black().r;
+        T white = RGB<T>::white().r;
+
+        TileScheduler::shared().run_tiles(original_image.height(), original_image.width(), shape, 0, threads,
+            [&](Tile const& tile) {
+                for (std::size_t y = tile.row_begin; y < tile.row_end; ++y) {
+                    const T* r = original_image.row(0, y);
+                    const T* g = original_image.row(1, y);
+                    const T* b = original_image.row(2, y);
+                    T* out_r = image_transformed.row(0, y);
+                    T* out_g = image_transformed.row(1, y);
+                    T* out_b = image_transformed.row(2, y);
+                    for (std::size_t x = tile.col_begin; x < tile.col_end; ++x) {
+                        T intensity = RGB<T>{r[x], g[x], b[x]}.to_intensity();
+                        T level = (intensity < upper_bound / 2) ? black : white;
+                        out_r[x] = level;
+                        out_g[x] = level;
+                        out_b[x] = level;
+                    }
+                }
+        });
+        return image_transformed;
+    }
 
-                    px.r = quantizers[0](orig_px.r);
-                    px.g = quantizers[1](orig_px.g);
-                    px.b = quantizers[2](orig_px.b);
+    prepare(original_image.max_color());
+    const T* table = levels_table_.data();
+    size_t last = upper_bound_;
+
+    TileScheduler::shared().run_tiles(original_image.height(), original_image.width(), shape, 0, threads,
+        [&](Tile const& tile) {
+            for (std::size_t channel = 0; channel < Image<T, Planar>::channels; ++channel) {
+                for (std::size_t y = tile.row_begin; y < tile.row_end; ++y) {
+                    const T* src = original_image.row(channel, y);
+                    T* dst = image_transformed.row(channel, y);
+                    for (std::size_t x = tile.col_begin; x < tile.col_end; ++x) {
+                        dst[x] = table[std::min<size_t>(src[x], last)];
+                    }
                 }
             }
     });
@@ -187,6 +323,192 @@ void ColorReduction<T>::transform_image(Image<T> const& original_image, Image<T>
 
 //----------------->       End Option 2        DO NOT DELETE
 
+template<typename T>
+PaletteReduction<T>::PaletteReduction(size_t colors, size_t max_iterations)
+: colors_{colors}
+, max_iterations_{max_iterations}
+{
+    if (colors == 0) {
+        throw InvalidPaletteSizeException();
+    }
+}
+
+template<typename T>
+std::vector<RGB<T>> const& PaletteReduction<T>::palette() const noexcept
+{
+    return palette_;
+}
+
+template<typename T>
+Image<T> PaletteReduction<T>::transform_image(Image<T> const& original_image, size_t threads)
+{
+    Image<T> image_transformed;
+    transform_into(original_image, image_transformed, threads);
+    return image_transformed;
+}
+
+template<typename T>
+void PaletteReduction<T>::transform_into(Image<T> const& original_image, Image<T>& out, size_t threads)
+{
+    size_t height = original_image.height();
+    size_t width = original_image.width();
+    size_t max_color = original_image.max_color();
+    out.resize(height, width, max_color);
+    palette_.clear();
+    if (original_image.size() == 0) {
+        return;
+    }
+
+    Centroids centroids = seed(original_image);
+    size_t entries = centroids.r.size();
+    size_t parts = std::clamp<size_t>(threads, 1, height);
+
+    // Per part and entry: pixel count and r, g, b sums, exact so the result does not depend on the parts
+    std::vector<uint64_t> sums(parts * entries * 4);
+    for (size_t iteration = 0; iteration < max_iterations_; ++iteration) {
+        std::fill(sums.begin(), sums.end(), 0);
+        assign(original_image, centroids, parts, threads,
+            [&](size_t part, size_t row, size_t col, const uint32_t* entry, size_t count) {
+                uint64_t* acc = sums.data() + part * entries * 4;
+                const RGB<T>* src = original_image.row_ptr(row) + col;
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t* slot = acc + entry[i] * 4;
+                    slot[0] += 1;
+                    slot[1] += src[i].r;
+                    slot[2] += src[i].g;
+                    slot[3] += src[i].b;
+                }
+            });
+        for (size_t part = 1; part < parts; ++part) {
+            const uint64_t* acc = sums.data() + part * entries * 4;
+            for (size_t i = 0; i < entries * 4; ++i) {
+                sums[i] += acc[i];
+            }
+        }
+
+        bool moved = false;
+        for (size_t e = 0; e < entries; ++e) {
+            const uint64_t* slot = sums.data() + e * 4;
+            if (slot[0] == 0) {
+                continue;   // an entry no pixel is nearest to stays where it is
+            }
+            auto mean = [count = static_cast<double>(slot[0])](uint64_t sum) {
+                return static_cast<float>(static_cast<double>(sum) / count);
+            };
+            float r = mean(slot[1]);
+            float g = mean(slot[2]);
+            float b = mean(slot[3]);
+            moved = moved || std::abs(r - centroids.r[e]) >= 0.5f || std::abs(g - centroids.g[e]) >= 0.5f
+                          || std::abs(b - centroids.b[e]) >= 0.5f;
+            centroids.r[e] = r;
+            centroids.g[e] = g;
+            centroids.b[e] = b;
+        }
+        if (!moved) {
+            break;
+        }
+    }
+
+    // Round the palette to sample values, then give every pixel its nearest rounded entry
+    palette_.resize(entries);
+    auto level = [max_color](float value) {
+        return static_cast<T>(std::min(std::lround(value), static_cast<long>(max_color)));
+    };
+    for (size_t e = 0; e < entries; ++e) {
+        palette_[e] = RGB<T>(level(centroids.r[e]), level(centroids.g[e]), level(centroids.b[e]));
+        centroids.r[e] = static_cast<float>(palette_[e].r);
+        centroids.g[e] = static_cast<float>(palette_[e].g);
+        centroids.b[e] = static_cast<float>(palette_[e].b);
+    }
+    assign(original_image, centroids, parts, threads,
+        [&](size_t, size_t row, size_t col, const uint32_t* entry, size_t count) {
+            RGB<T>* dst = out.row_ptr(row) + col;
+            for (size_t i = 0; i < count; ++i) {
+                dst[i] = palette_[entry[i]];
+            }
+        });
+}
+
+template<typename T>
+typename PaletteReduction<T>::Centroids PaletteReduction<T>::seed(Image<T> const& image) const
+{
+    constexpr size_t max_samples = 4096;
+    size_t step = std::max<size_t>(image.size() / max_samples, 1);
+    Centroids samples;
+    for (size_t i = 0; i < image.size(); i += step) {
+        samples.r.push_back(static_cast<float>(image[i].r));
+        samples.g.push_back(static_cast<float>(image[i].g));
+        samples.b.push_back(static_cast<float>(image[i].b));
+    }
+    size_t count = samples.r.size();
+
+    // k-means++: each further seed is a sample drawn with probability proportional to its
+    // squared distance from the nearest seed so far. A fixed seed keeps the palette reproducible.
+    std::mt19937 rng{5489u};
+    Centroids centroids;
+    auto add = [&](size_t i) {
+        centroids.r.push_back(samples.r[i]);
+        centroids.g.push_back(samples.g[i]);
+        centroids.b.push_back(samples.b[i]);
+    };
+    add(rng() % count);
+
+    std::vector<double> distance(count, std::numeric_limits<double>::infinity());
+    while (centroids.r.size() < colors_) {
+        size_t last = centroids.r.size() - 1;
+        double total = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double dr = samples.r[i] - centroids.r[last];
+            double dg = samples.g[i] - centroids.g[last];
+            double db = samples.b[i] - centroids.b[last];
+            distance[i] = std::min(distance[i], dr * dr + dg * dg + db * db);
+            total += distance[i];
+        }
+        if (total == 0.0) {
+            break;      // every sample already equals a seed
+        }
+
+        double target = static_cast<double>(rng()) / 4294967296.0 * total;
+        size_t pick = 0;
+        double sum = distance[0];
+        while (sum <= target && pick + 1 < count) {
+            sum += distance[++pick];
+        }
+        add(pick);
+    }
+    return centroids;
+}
+
+template<typename T>
+template<typename Visit>
+void PaletteReduction<T>::assign(Image<T> const& image, Centroids const& centroids, size_t parts, size_t threads,
+                                 Visit const& visit)
+{
+    constexpr size_t batch = 256;
+    size_t height = image.height();
+    size_t width = image.width();
+    TileScheduler::shared().parallel_for(parts, threads, [&](size_t part) {
+        float r[batch];
+        float g[batch];
+        float b[batch];
+        uint32_t entry[batch];
+        for (size_t row = height * part / parts; row < height * (part + 1) / parts; ++row) {
+            const RGB<T>* src = image.row_ptr(row);
+            for (size_t col = 0; col < width; col += batch) {
+                size_t count = std::min(batch, width - col);
+                for (size_t i = 0; i < count; ++i) {
+                    r[i] = static_cast<float>(src[col + i].r);
+                    g[i] = static_cast<float>(src[col + i].g);
+                    b[i] = static_cast<float>(src[col + i].b);
+                }
+                simd::nearest(r, g, b, count, centroids.r.data(), centroids.g.data(), centroids.b.data(),
+                              centroids.r.size(), entry);
+                visit(part, row, col, entry, count);
+            }
+        }
+    });
+}
+
 template<typename T>
 Pixelator<T>::Pixelator(size_t block_size)
 : block_size_{block_size}
@@ -196,66 +518,120 @@ Pixelator<T>::Pixelator(size_t block_size)
 template<typename T>
 Image<T> Pixelator<T>::transform_image(Image<T> const& original_image, size_t threads)
 {
-    Image<T> image_transformed = Image<T>{original_image.height(), original_image.width(), original_image.max_color()};
+    Image<T> image_transformed;
+    transform_into(original_image, image_transformed, threads);
+    return image_transformed;
+}
 
-    auto block_averages = precompute_block_averages(original_image);
+template<typename T>
+void Pixelator<T>::transform_into(Image<T> const& original_image, Image<T>& out, size_t threads)
+{
+    out.resize(original_image.height(), original_image.width(), original_image.max_color());
+
+    auto block_averages = precompute_block_averages(original_image, threads);
+    size_t width = original_image.width();
+    size_t blocks_x = (width + block_size_ - 1) / block_size_;
+
+    auto shape = TileScheduler::tile_shape_for(original_image.height(), width, sizeof(RGB<T>));
+    TileScheduler::shared().run_tiles(original_image.height(), width, shape, 0, threads,
+        [&, this](Tile const& tile) {
+            size_t cols = tile.col_end - tile.col_begin;
+            for (size_t row = tile.row_begin; row < tile.row_end; ++row) {
+                RGB<T>* dst = out.row_ptr(row) + tile.col_begin;
+
+                // Rows inside one block are identical: copy the row above when it belongs to the same block
+                if (row != tile.row_begin && row % block_size_ != 0) {
+                    const RGB<T>* above = dst - width;
+                    std::copy(above, above + cols, dst);
+                    continue;
+                }
 
-    ThreadWorker worker(threads);
-    worker.run(original_image.height(), 
-        [&original_image, &image_transformed, &block_averages, this](std::size_t start_row, std::size_t end_row) {
-            for (size_t row = start_row; row < end_row; ++row) {
-                for (size_t col = 0; col < original_image.width(); ++col) {
-                    size_t block_row = row / block_size_;
-                    size_t block_col = col / block_size_;
-                    image_transformed(row, col) = block_averages[block_row][block_col];
+                const RGB<T>* averages = &block_averages[(row / block_size_) * blocks_x];
+                size_t col = tile.col_begin;
+                while (col < tile.col_end) {
+                    size_t run_end = std::min((col / block_size_ + 1) * block_size_, tile.col_end);
+                    std::fill(dst + (col - tile.col_begin), dst + (run_end - tile.col_begin), averages[col / block_size_]);
+                    col = run_end;
                 }
             }
         }
     );
+}
 
-    return image_transformed;
+template<typename T>
+std::vector<RGB<uint64_t>> Pixelator<T>::summed_area_table(Image<T> const& image, size_t threads) const
+{
+    size_t height = image.height();
+    size_t width = image.width();
+    size_t stride = width + 1;
+    std::vector<RGB<uint64_t>> table(stride * (height + 1));
+
+    // Prefix sums along each row, then down each column strip; both passes are independent per band
+    ThreadWorker rows(threads);
+    rows.run(height, [&](std::size_t start_row, std::size_t end_row) {
+        for (size_t y = start_row; y < end_row; ++y) {
+            const RGB<T>* src = image.row_ptr(y);
+            RGB<uint64_t>* out = &table[(y + 1) * stride + 1];
+            RGB<uint64_t> sum{};
+            for (size_t x = 0; x < width; ++x) {
+                sum.r += src[x].r;
+                sum.g += src[x].g;
+                sum.b += src[x].b;
+                out[x] = sum;
+            }
+        }
+    });
+
+    ThreadWorker columns(threads);
+    columns.run(width, [&](std::size_t start_col, std::size_t end_col) {
+        for (size_t y = 2; y <= height; ++y) {
+            const RGB<uint64_t>* above = &table[(y - 1) * stride + 1];
+            RGB<uint64_t>* out = &table[y * stride + 1];
+            for (size_t x = start_col; x < end_col; ++x) {
+                out[x].r += above[x].r;
+                out[x].g += above[x].g;
+                out[x].b += above[x].b;
+            }
+        }
+    });
+
+    return table;
 }
 
 template<typename T>
-std::vector<std::vector<RGB<T>>> Pixelator<T>::precompute_block_averages(Image<T> const& image) const
+std::vector<RGB<T>> Pixelator<T>::precompute_block_averages(Image<T> const& image, size_t threads) const
 {
     size_t blocks_y = (image.height() + block_size_ - 1) / block_size_;
     size_t blocks_x = (image.width() + block_size_ - 1) / block_size_;
+    size_t stride = image.width() + 1;
 
-    std::vector<std::vector<RGB<T>>> block_avgs(blocks_y, std::vector<RGB<T>>(blocks_x, RGB<T>{}));
-
-    for (size_t block_row = 0; block_row < blocks_y; ++block_row) {
-        for (size_t block_col = 0; block_col < blocks_x; ++block_col) {
-
-            RGB<uint64_t> sum{};    // Use big type to avoid overflow
-            size_t pixel_count = 0;
+    auto table = summed_area_table(image, threads);
+    std::vector<RGB<T>> block_avgs(blocks_y * blocks_x);
 
+    ThreadWorker worker(threads);
+    worker.run(blocks_y, [&, this](std::size_t start_block, std::size_t end_block) {
+        for (size_t block_row = start_block; block_row < end_block; ++block_row) {
             size_t row_start = block_row * block_size_;
             size_t row_end = std::min(row_start + block_size_, image.height());
 
-            size_t col_start = block_col * block_size_;
-            size_t col_end = std::min(col_start + block_size_, image.width());
+            for (size_t block_col = 0; block_col < blocks_x; ++block_col) {
+                size_t col_start = block_col * block_size_;
+                size_t col_end = std::min(col_start + block_size_, image.width());
 
-            for (size_t row = row_start; row < row_end; ++row) {
-                for (size_t col = col_start; col < col_end; ++col) {
-                    RGB<T> px = image(row, col);
-                    sum.r += px.r;
-                    sum.g += px.g;
-                    sum.b += px.b;
-                    ++pixel_count;
-                }
-            }
+                RGB<uint64_t> const& bottom_right = table[row_end * stride + col_end];
+                RGB<uint64_t> const& bottom_left = table[row_end * stride + col_start];
+                RGB<uint64_t> const& top_right = table[row_start * stride + col_end];
+                RGB<uint64_t> const& top_left = table[row_start * stride + col_start];
+                uint64_t pixel_count = (row_end - row_start) * (col_end - col_start);
 
-            if (pixel_count > 0) {
-                // Compute average
-                block_avgs[block_row][block_col] = RGB<T>{
-                    static_cast<T>(sum.r / pixel_count),
-                    static_cast<T>(sum.g / pixel_count),
-                    static_cast<T>(sum.b / pixel_count)
+                block_avgs[block_row * blocks_x + block_col] = RGB<T>{
+                    static_cast<T>((bottom_right.r - bottom_left.r - top_right.r + top_left.r) / pixel_count),
+                    static_cast<T>((bottom_right.g - bottom_left.g - top_right.g + top_left.g) / pixel_count),
+                    static_cast<T>((bottom_right.b - bottom_left.b - top_right.b + top_left.b) / pixel_count)
                 };
             }
         }
-    }
+    });
 
     return block_avgs;
 }
@@ -264,90 +640,525 @@ template<typename T>
 GaussianBlur<T>::GaussianBlur(size_t kernel_size, double sigma)
 : kernel_size_{kernel_size}
 , sigma_{sigma}
+, kernel_{generate_gaussian_kernel(kernel_size, sigma)}
 {
 }
 
 template<typename T>
 Image<T> GaussianBlur<T>::transform_image(Image<T> const& original_image, size_t threads)
 {
-    int half_k = std::max(static_cast<int>(kernel_size_ / 2), 1);
+    return image::to_interleaved(transform_image(image::to_planar(original_image), threads));
+}
+
+template<typename T>
+Image<T, Planar> GaussianBlur<T>::transform_image(Image<T, Planar> const& original_image, size_t threads)
+{
+    Image<T, Planar> image_transformed{original_image.height(), original_image.width(), original_image.max_color()};
+    if (original_image.size() == 0) {
+        return image_transformed;
+    }
+
+    if (uses_box_blur()) {
+        blur_boxes(original_image, image_transformed, threads);
+    } else {
+        blur_separable(original_image, image_transformed, threads);
+    }
+    return image_transformed;
+}
+
+template<typename T>
+std::vector<float> GaussianBlur<T>::generate_gaussian_kernel(size_t size, double sigma) const
+{
+    if (size % 2 == 0) {
+        throw InvalidKernelSizeException();
+    }
 
-    auto kernel = generate_gaussian_kernel(kernel_size_, sigma_);
+    std::vector<double> weights(size);
+    int half = static_cast<int>(size / 2);
+    double sum = 0.0;
+    for (int x = -half; x <= half; ++x) {
+        weights[x + half] = std::exp(-(x * x) / (2.0 * sigma * sigma));
+        sum += weights[x + half];
+    }
 
-    Image<T> image_transformed = Image<T>{original_image.height(), original_image.width(), original_image.max_color()};
+    // Normalize in double, so the float taps still add up to one
+    std::vector<float> kernel(size);
+    for (size_t i = 0; i < size; ++i) {
+        kernel[i] = static_cast<float>(weights[i] / sum);
+    }
+    return kernel;
+}
 
-    ThreadWorker worker(threads);
-    worker.run(original_image.height(),
-        [&, this](std::size_t start_row, std::size_t end_row) {
-            for (size_t y = start_row; y < end_row; ++y) {
-                for (size_t x = 0; x < original_image.width(); ++x) {
-                    image_transformed(y, x) =
-                        apply_kernel_to_pixel(original_image, kernel, y, x, half_k);
-                }
-            }
+template<typename T>
+bool GaussianBlur<T>::uses_box_blur() const noexcept
+{
+    // A kernel narrower than ±3 sigma is visibly truncated, and boxes would not reproduce that
+    return kernel_size_ > box_threshold && static_cast<double>(kernel_size_) >= 6.0 * sigma_;
+}
+
+template<typename T>
+std::array<size_t, 3> GaussianBlur<T>::box_radii() const
+{
+    // Three boxes whose combined variance matches sigma (widths wl or wl + 2, both odd)
+    constexpr double passes = 3.0;
+    double variance = 12.0 * sigma_ * sigma_;
+    int lower = static_cast<int>(std::floor(std::sqrt(variance / passes + 1.0)));
+    if (lower % 2 == 0) {
+        --lower;
+    }
+    lower = std::max(lower, 1);
+    int lower_count = static_cast<int>(std::round(
+        (variance - passes * lower * lower - 4.0 * passes * lower - 3.0 * passes) / (-4.0 * lower - 4.0)));
+
+    std::array<size_t, 3> radii{};
+    for (int pass = 0; pass < 3; ++pass) {
+        int width = (pass < lower_count) ? lower : lower + 2;
+        radii[pass] = static_cast<size_t>(width / 2);
+    }
+    return radii;
+}
+
+template<typename T>
+void GaussianBlur<T>::blur_separable(Image<T, Planar> const& original_image, Image<T, Planar>& image_transformed, size_t threads) const
+{
+    size_t width = original_image.width();
+    size_t height = original_image.height();
+    size_t half = kernel_size_ / 2;
+    float upper_bound = static_cast<float>(original_image.max_color());
+
+    auto shape = TileScheduler::tile_shape_for(height, width, sizeof(float), half);
+    TileScheduler::shared().run_tiles(height, width, shape, half, threads,
+        [&, this](Tile const& tile) {
+            detail::convolve_tile(tile, kernel_, kernel_,
+                [&](size_t channel, size_t y, float* out) {
+                    simd::widen(original_image.row(channel, y) + tile.halo_col_begin, out, tile.halo_col_end - tile.halo_col_begin);
+                },
+                [&](size_t channel, size_t y, const float* sums) {
+                    simd::narrow(sums, image_transformed.row(channel, y) + tile.col_begin, tile.col_end - tile.col_begin, upper_bound);
+                });
         });
+}
 
-    return image_transformed;
+template<typename T>
+size_t GaussianBlur<T>::halo() const noexcept
+{
+    return kernel_size_ / 2;
 }
 
+template<typename T>
+bool GaussianBlur<T>::tileable() const noexcept
+{
+    return !uses_box_blur();
+}
 
 template<typename T>
-std::vector<std::vector<double>> GaussianBlur<T>::generate_gaussian_kernel(int size, double sigma) const
+void GaussianBlur<T>::transform_tile(ImageView<const RGB<T>> src, Tile const& tile, ImageView<RGB<T>> dst,
+                                     size_t max_color) const
 {
-    if (size % 2 == 0) {
+    detail::convolve_interleaved(src, tile, dst, max_color, kernel_, kernel_, false);
+}
+
+template<typename T>
+void GaussianBlur<T>::blur_boxes(Image<T, Planar> const& original_image, Image<T, Planar>& image_transformed, size_t threads) const
+{
+    size_t width = original_image.width();
+    size_t height = original_image.height();
+    auto radii = box_radii();
+    size_t max_radius = *std::max_element(radii.begin(), radii.end());
+    float upper_bound = static_cast<float>(original_image.max_color());
+
+    // Boxes need whole columns, so this path keeps a full float plane and runs the
+    // horizontal passes over row bands and the vertical passes over column strips.
+    std::vector<float> plane(width * height);
+    std::vector<float> scratch(width * height);
+
+    for (std::size_t channel = 0; channel < Image<T, Planar>::channels; ++channel) {
+        ThreadWorker rows(threads);
+        rows.run(height,
+            [&](std::size_t start_row, std::size_t end_row) {
+                std::vector<float> padded(width + 2 * max_radius);
+                for (size_t y = start_row; y < end_row; ++y) {
+                    float* line = plane.data() + y * width;
+                    simd::widen(original_image.row(channel, y), line, width);
+                    for (size_t radius : radii) {
+                        float* inner = padded.data() + radius;
+                        std::copy(line, line + width, inner);
+                        std::fill(padded.data(), inner, line[0]);
+                        std::fill(inner + width, inner + width + radius, line[width - 1]);
+
+                        double scale = 1.0 / static_cast<double>(2 * radius + 1);
+                        double sum = std::accumulate(padded.data(), padded.data() + 2 * radius + 1, 0.0);
+                        line[0] = static_cast<float>(sum * scale);
+                        for (size_t x = 1; x < width; ++x) {
+                            sum += padded[x + 2 * radius] - padded[x - 1];
+                            line[x] = static_cast<float>(sum * scale);
+                        }
+                    }
+                }
+            });
+
+        ThreadWorker columns(threads);
+        columns.run(width,
+            [&](std::size_t start_col, std::size_t end_col) {
+                size_t strip = end_col - start_col;
+                std::vector<double> sums(strip);
+                float* source = plane.data();
+                float* target = scratch.data();
+                for (size_t radius : radii) {
+                    auto at = [&](float* base, long row) {
+                        row = std::clamp(row, 0L, static_cast<long>(height) - 1);
+                        return base + static_cast<size_t>(row) * width + start_col;
+                    };
+                    long r = static_cast<long>(radius);
+                    double scale = 1.0 / static_cast<double>(2 * radius + 1);
+                    std::fill(sums.begin(), sums.end(), 0.0);
+                    for (long row = -r; row <= r; ++row) {
+                        const float* line = at(source, row);
+                        for (size_t x = 0; x < strip; ++x) {
+                            sums[x] += line[x];
+                        }
+                    }
+                    for (long y = 0; y < static_cast<long>(height); ++y) {
+                        float* out = at(target, y);
+                        const float* enter = at(source, y + r + 1);
+                        const float* leave = at(source, y - r);
+                        for (size_t x = 0; x < strip; ++x) {
+                            out[x] = static_cast<float>(sums[x] * scale);
+                            sums[x] += enter[x] - leave[x];
+                        }
+                    }
+                    std::swap(source, target);
+                }
+                // Three passes leave the result in scratch
+                for (size_t y = 0; y < height; ++y) {
+                    simd::narrow(source + y * width + start_col, image_transformed.row(channel, y) + start_col, strip, upper_bound);
+                }
+            });
+    }
+}
+
+template<typename T>
+SeparableConvolution<T>::SeparableConvolution(std::vector<float> horizontal, std::vector<float> vertical, bool absolute)
+: horizontal_{std::move(horizontal)}
+, vertical_{std::move(vertical)}
+, absolute_{absolute}
+{
+    if (horizontal_.size() % 2 == 0 || vertical_.size() % 2 == 0) {
         throw InvalidKernelSizeException();
     }
+}
 
-    std::vector<std::vector<double>> kernel(size, std::vector<double>(size));
-    int half = size / 2;
-    double sum = 0.0;
+template<typename T>
+SeparableConvolution<T> SeparableConvolution<T>::box(size_t size)
+{
+    float weight = size == 0 ? 0.0f : 1.0f / static_cast<float>(size);
+    return SeparableConvolution{std::vector<float>(size, weight), std::vector<float>(size, weight)};
+}
 
-    for (int y = -half; y <= half; ++y) {
-        for (int x = -half; x <= half; ++x) {
-            double exponent = -(x * x + y * y) / (2.0 * sigma * sigma);
-            double value = std::exp(exponent) / (2.0 * M_PI * sigma * sigma);
-            kernel[y + half][x + half] = value;
-            sum += value;
+template<typename T>
+SeparableConvolution<T> SeparableConvolution<T>::sharpen(float amount)
+{
+    std::vector<float> kernel{-amount, 1.0f + 2.0f * amount, -amount};
+    return SeparableConvolution{kernel, kernel};
+}
+
+template<typename T>
+SeparableConvolution<T> SeparableConvolution<T>::sobel_x()
+{
+    return SeparableConvolution{{-0.25f, 0.0f, 0.25f}, {1.0f, 2.0f, 1.0f}, true};
+}
+
+template<typename T>
+SeparableConvolution<T> SeparableConvolution<T>::sobel_y()
+{
+    return SeparableConvolution{{1.0f, 2.0f, 1.0f}, {-0.25f, 0.0f, 0.25f}, true};
+}
+
+template<typename T>
+Image<T> SeparableConvolution<T>::transform_image(Image<T> const& original_image, size_t threads)
+{
+    Image<T> image_transformed;
+    transform_into(original_image, image_transformed, threads);
+    return image_transformed;
+}
+
+template<typename T>
+void SeparableConvolution<T>::transform_into(Image<T> const& original_image, Image<T>& out, size_t threads)
+{
+    size_t height = original_image.height();
+    size_t width = original_image.width();
+    out.resize(height, width, original_image.max_color());
+
+    auto shape = TileScheduler::tile_shape_for(height, width, sizeof(float), halo());
+    TileScheduler::shared().run_tiles(height, width, shape, halo(), threads, [&](Tile const& tile) {
+        auto src = original_image.view().subview(tile.halo_row_begin, tile.halo_col_begin,
+                                                 tile.halo_row_end - tile.halo_row_begin, tile.halo_col_end - tile.halo_col_begin);
+        auto dst = out.view().subview(tile.row_begin, tile.col_begin,
+                                      tile.row_end - tile.row_begin, tile.col_end - tile.col_begin);
+        transform_tile(src, tile, dst, original_image.max_color());
+    });
+}
+
+template<typename T>
+size_t SeparableConvolution<T>::halo() const noexcept
+{
+    return std::max(horizontal_.size(), vertical_.size()) / 2;
+}
+
+template<typename T>
+bool SeparableConvolution<T>::tileable() const noexcept
+{
+    return true;
+}
+
+template<typename T>
+void SeparableConvolution<T>::transform_tile(ImageView<const RGB<T>> src, Tile const& tile, ImageView<RGB<T>> dst,
+                                             size_t max_color) const
+{
+    detail::convolve_interleaved(src, tile, dst, max_color, horizontal_, vertical_, absolute_);
+}
+
+template<typename T>
+Resize<T>::Resize(size_t height, size_t width, ResizeFilter filter)
+: height_{height}
+, width_{width}
+, filter_{filter}
+{
+    if (height == 0 || width == 0) {
+        throw InvalidDimensionsException();
+    }
+}
+
+template<typename T>
+double Resize<T>::filter_radius(ResizeFilter filter) noexcept
+{
+    switch (filter) {
+    case ResizeFilter::Bilinear:
+        return 1.0;
+    case ResizeFilter::Bicubic:
+        return 2.0;
+    case ResizeFilter::Lanczos3:
+        return 3.0;
+    }
+    return 1.0;
+}
+
+template<typename T>
+double Resize<T>::filter_weight(ResizeFilter filter, double x) noexcept
+{
+    constexpr double pi = 3.14159265358979323846;
+    x = std::fabs(x);
+    switch (filter) {
+    case ResizeFilter::Bilinear:
+        return x < 1.0 ? 1.0 - x : 0.0;
+    case ResizeFilter::Bicubic: {
+        constexpr double a = -0.5;
+        if (x < 1.0) {
+            return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+        }
+        return x < 2.0 ? ((a * x - 5.0 * a) * x + 8.0 * a) * x - 4.0 * a : 0.0;
+    }
+    case ResizeFilter::Lanczos3:
+        if (x < 1e-8) {
+            return 1.0;
         }
+        return x < 3.0 ? 3.0 * std::sin(pi * x) * std::sin(pi * x / 3.0) / (pi * pi * x * x) : 0.0;
     }
+    return 0.0;
+}
 
-    // Normalize kernel
-    for (auto& row : kernel) {
-        for (auto& val : row) {
-            val /= sum;
+template<typename T>
+typename Resize<T>::Taps Resize<T>::compute_taps(size_t source_size, size_t target_size, ResizeFilter filter)
+{
+    double scale = static_cast<double>(source_size) / static_cast<double>(target_size);
+    double stretch = std::max(scale, 1.0);          // widen the filter when shrinking
+    double radius = filter_radius(filter) * stretch;
+
+    Taps taps;
+    taps.count = static_cast<size_t>(std::ceil(2.0 * radius)) + 1;
+    taps.index.resize(target_size * taps.count);
+    taps.weight.resize(target_size * taps.count);
+
+    std::vector<double> weights(taps.count);
+    long last = static_cast<long>(source_size) - 1;
+    for (size_t target = 0; target < target_size; ++target) {
+        double center = (static_cast<double>(target) + 0.5) * scale - 0.5;
+        long first = static_cast<long>(std::floor(center - radius)) + 1;
+        double sum = 0.0;
+        for (size_t k = 0; k < taps.count; ++k) {
+            long source = first + static_cast<long>(k);
+            weights[k] = filter_weight(filter, (static_cast<double>(source) - center) / stretch);
+            sum += weights[k];
+            taps.index[target * taps.count + k] = static_cast<size_t>(std::clamp(source, 0L, last));
+        }
+        for (size_t k = 0; k < taps.count; ++k) {
+            taps.weight[target * taps.count + k] = static_cast<float>(weights[k] / sum);
         }
     }
+    return taps;
+}
 
-    return kernel;
+template<typename T>
+Image<T> Resize<T>::transform_image(Image<T> const& original_image, size_t threads)
+{
+    Image<T> image_transformed;
+    transform_into(original_image, image_transformed, threads);
+    return image_transformed;
 }
 
+template<typename T>
+void Resize<T>::transform_into(Image<T> const& original_image, Image<T>& out, size_t threads)
+{
+    out.resize(height_, width_, original_image.max_color());
+    size_t source_height = original_image.height();
+    size_t source_width = original_image.width();
+    if (original_image.size() == 0) {
+        return;
+    }
+
+    Taps columns = compute_taps(source_width, width_, filter_);
+    Taps rows = compute_taps(source_height, height_, filter_);
+
+    // Horizontal pass: every source row into three float channel planes of width_ columns
+    std::vector<float> planes(3 * source_height * width_);
+    ThreadWorker horizontal(threads);
+    horizontal.run(source_height, [&](std::size_t start_row, std::size_t end_row) {
+        for (size_t y = start_row; y < end_row; ++y) {
+            const RGB<T>* src = original_image.row_ptr(y);
+            float* r = planes.data() + y * width_;
+            float* g = r + source_height * width_;
+            float* b = g + source_height * width_;
+            for (size_t x = 0; x < width_; ++x) {
+                const size_t* index = &columns.index[x * columns.count];
+                const float* weight = &columns.weight[x * columns.count];
+                float sum_r = 0.0f;
+                float sum_g = 0.0f;
+                float sum_b = 0.0f;
+                for (size_t k = 0; k < columns.count; ++k) {
+                    RGB<T> const& px = src[index[k]];
+                    sum_r += weight[k] * static_cast<float>(px.r);
+                    sum_g += weight[k] * static_cast<float>(px.g);
+                    sum_b += weight[k] * static_cast<float>(px.b);
+                }
+                r[x] = sum_r;
+                g[x] = sum_g;
+                b[x] = sum_b;
+            }
+        }
+    });
+
+    // Vertical pass: each output row is a weighted sum of whole plane rows
+    float upper_bound = static_cast<float>(original_image.max_color());
+    ThreadWorker vertical(threads);
+    vertical.run(height_, [&](std::size_t start_row, std::size_t end_row) {
+        static constexpr T RGB<T>::* channels[] = {&RGB<T>::r, &RGB<T>::g, &RGB<T>::b};
+        std::vector<float> sums(width_);
+        std::vector<T> narrowed(width_);
+        for (size_t y = start_row; y < end_row; ++y) {
+            RGB<T>* dst = out.row_ptr(y);
+            for (size_t channel = 0; channel < 3; ++channel) {
+                const float* plane = planes.data() + channel * source_height * width_;
+                std::fill(sums.begin(), sums.end(), 0.0f);
+                for (size_t k = 0; k < rows.count; ++k) {
+                    size_t source = rows.index[y * rows.count + k];
+                    simd::multiply_add(sums.data(), plane + source * width_, rows.weight[y * rows.count + k], width_);
+                }
+                simd::narrow(sums.data(), narrowed.data(), width_, upper_bound);
+                for (size_t x = 0; x < width_; ++x) {
+                    dst[x].*channels[channel] = narrowed[x];
+                }
+            }
+        }
+    });
+}
+
+template<typename T>
+Image<T> HistogramEqualization<T>::transform_image(Image<T> const& original_image, size_t threads)
+{
+    Image<T> image_transformed;
+    transform_into(original_image, image_transformed, threads);
+    return image_transformed;
+}
 
 template<typename T>
-RGB<T> GaussianBlur<T>::apply_kernel_to_pixel(Image<T> const& image, std::vector<std::vector<double>> const& kernel, int y, int x, int half_k) const
+void HistogramEqualization<T>::transform_into(Image<T> const& original_image, Image<T>& out, size_t threads)
 {
-    double r_sum = 0.0, g_sum = 0.0, b_sum = 0.0;
-    int width = static_cast<int>(image.width());
-    int height = static_cast<int>(image.height());
+    size_t height = original_image.height();
+    size_t width = original_image.width();
+    size_t max_color = original_image.max_color();
+    out.resize(height, width, max_color);
+    if (original_image.size() == 0) {
+        return;
+    }
 
-    for (int ky = -(half_k); ky <= (half_k); ++ky) {
-        for (int kx = -(half_k); kx <= (half_k); ++kx) {
-            int sy = std::clamp(y + ky, 0, height - 1);
-            int sx = std::clamp(x + kx, 0, width - 1);
+    // One r, g, b histogram triple per part; each part is counted by a single thread
+    size_t bins = max_color + 1;
+    size_t parts = std::clamp<size_t>(threads, 1, height);
+    std::vector<uint64_t> histograms(parts * 3 * bins);
+    TileScheduler::shared().parallel_for(parts, threads, [&](size_t part) {
+        uint64_t* r = histograms.data() + part * 3 * bins;
+        uint64_t* g = r + bins;
+        uint64_t* b = g + bins;
+        size_t first = height * part / parts;
+        size_t last = height * (part + 1) / parts;
+        for (size_t i = first * width; i < last * width; ++i) {
+            RGB<T> const& px = original_image[i];
+            ++r[std::min<size_t>(px.r, max_color)];
+            ++g[std::min<size_t>(px.g, max_color)];
+            ++b[std::min<size_t>(px.b, max_color)];
+        }
+    });
+    for (size_t part = 1; part < parts; ++part) {
+        const uint64_t* counts = histograms.data() + part * 3 * bins;
+        for (size_t i = 0; i < 3 * bins; ++i) {
+            histograms[i] += counts[i];
+        }
+    }
 
-            RGB<T> px = image(static_cast<size_t>(sy), static_cast<size_t>(sx));
-            double weight = kernel[ky + half_k][kx + half_k];
+    std::vector<T> red = equalization_table(histograms.data(), original_image.size(), max_color);
+    std::vector<T> green = equalization_table(histograms.data() + bins, original_image.size(), max_color);
+    std::vector<T> blue = equalization_table(histograms.data() + 2 * bins, original_image.size(), max_color);
+
+    auto shape = TileScheduler::tile_shape_for(height, width, sizeof(RGB<T>));
+    TileScheduler::shared().run_tiles(height, width, shape, 0, threads, [&](Tile const& tile) {
+        for (size_t row = tile.row_begin; row < tile.row_end; ++row) {
+            const RGB<T>* src = original_image.row_ptr(row);
+            RGB<T>* dst = out.row_ptr(row);
+            for (size_t col = tile.col_begin; col < tile.col_end; ++col) {
+                dst[col] = RGB<T>{
+                    red[std::min<size_t>(src[col].r, max_color)],
+                    green[std::min<size_t>(src[col].g, max_color)],
+                    blue[std::min<size_t>(src[col].b, max_color)]
+                };
+            }
+        }
+    });
+}
 
-            r_sum += static_cast<double>(px.r) * weight;
-            g_sum += static_cast<double>(px.g) * weight;
-            b_sum += static_cast<double>(px.b) * weight;
+template<typename T>
+std::vector<T> HistogramEqualization<T>::equalization_table(const uint64_t* histogram, size_t pixels, size_t max_color)
+{
+    std::vector<T> table(max_color + 1);
+    uint64_t lowest = 0;        // count of the smallest value present, which maps to 0
+    for (size_t value = 0; value <= max_color && lowest == 0; ++value) {
+        lowest = histogram[value];
+    }
+    if (lowest == pixels) {
+        // A single value: nothing to spread
+        for (size_t value = 0; value <= max_color; ++value) {
+            table[value] = static_cast<T>(value);
         }
+        return table;
     }
-    double upper_bound = static_cast<double>(image.max_color());
-    return RGB<T>{
-        static_cast<T>(std::clamp(r_sum, 0.0, upper_bound)),//255.0
-        static_cast<T>(std::clamp(g_sum, 0.0, upper_bound)),//255.0
-        static_cast<T>(std::clamp(b_sum, 0.0, upper_bound)),//255.0
-    };
+
+    double scale = static_cast<double>(max_color) / static_cast<double>(pixels - lowest);
+    uint64_t cumulative = 0;
+    for (size_t value = 0; value <= max_color; ++value) {
+        cumulative += histogram[value];
+        uint64_t above = cumulative > lowest ? cumulative - lowest : 0;
+        table[value] = static_cast<T>(std::lround(static_cast<double>(above) * scale));
+    }
+    return table;
 }
 
 } // namespace img_proc
@@ -4,10 +4,15 @@
 #include <thread>
 
 #include "img_proc/image.hpp"
+#include "img_proc/tile_scheduler.hpp"
 
 namespace img_proc {
     
-using image::Image;    
+using image::Image;
+using image::Image8;
+using image::Interleaved;
+using image::Planar;
+using image::ImageView;
 /**
  * @brief Interface for image transformation strategies (strategy pattern).
  */
@@ -23,6 +28,85 @@ public:
      * @param threads Number of threads to use.
      */
     virtual Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) = 0;
+
+    /**
+     * @brief Writes the transformation of original_image into out, reusing out's pixel buffer.
+     *
+     * out is resized to the output's dimensions; when it already holds that many pixels no
+     * allocation takes place, so a caller processing a stream of same-sized frames can keep one
+     * output image (or take it from an ImagePool). out must not be original_image, except for
+     * point-wise transformers. The default moves the result of transform_image into out.
+     */
+    virtual void transform_into(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency());
+};
+
+/**
+ * @brief A transformer whose output pixel depends only on the input pixel at the same position.
+ *
+ * Exposing the per-pixel work as a span kernel lets a Pipeline fuse consecutive point-wise
+ * stages into one pass over the image.
+ */
+template<typename T>
+class PointwiseTransformer : public ImageTransformer<T> {
+public:
+    /**
+     * @brief Builds the per-image state (bins, tables) for images with the given max color.
+     */
+    virtual void prepare(size_t max_color) = 0;
+
+    /**
+     * @brief Transforms count pixels; src and dst may be the same span. Requires prepare().
+     */
+    virtual void transform_span(const RGB<T>* src, RGB<T>* dst, size_t count) const = 0;
+
+    /**
+     * @brief Prepares for the image, then transforms it tile by tile.
+     */
+    Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+
+    /**
+     * @brief As transform_image, into out; out may be original_image.
+     */
+    void transform_into(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency()) override;
+
+    /**
+     * @brief Transforms the image over itself, without a second buffer.
+     */
+    void transform_in_place(Image<T>& image, size_t threads = std::thread::hardware_concurrency());
 };
 
-} // namespace img_proc
\ No newline at end of file
+/**
+ * @brief A transformer whose output pixel depends on a bounded neighbourhood of the input.
+ *
+ * A tileable stencil can produce any tile of its output from the tile's halo rectangle alone,
+ * which lets a Pipeline evaluate it tile by tile on intermediates that stay in cache.
+ */
+template<typename T>
+class StencilTransformer : public ImageTransformer<T> {
+public:
+    /**
+     * @brief Returns the neighbourhood radius the stencil reads around each pixel.
+     */
+    virtual size_t halo() const noexcept = 0;
+
+    /**
+     * @brief Returns whether transform_tile is available with the current parameters.
+     */
+    virtual bool tileable() const noexcept = 0;
+
+    /**
+     * @brief Computes the tile's own pixels from its halo rectangle.
+     *
+     * Pixels outside the image replicate the nearest edge pixel, which is the nearest pixel of
+     * the halo rectangle since that rectangle is clipped to the image.
+     *
+     * @param src The halo rectangle; its (0, 0) is pixel (halo_row_begin, halo_col_begin).
+     * @param dst The tile's own output pixels; its (0, 0) is pixel (row_begin, col_begin).
+     */
+    virtual void transform_tile(ImageView<const RGB<T>> src, Tile const& tile, ImageView<RGB<T>> dst,
+                                size_t max_color) const = 0;
+};
+
+} // namespace img_proc
+
+#include "img_proc/image_proc_interface.inl"
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "img_proc/image_proc_interface.hpp"
+
+namespace img_proc {
+
+template<typename T>
+void ImageTransformer<T>::transform_into(Image<T> const& original_image, Image<T>& out, size_t threads)
+{
+    out = transform_image(original_image, threads);
+}
+
+template<typename T>
+Image<T> PointwiseTransformer<T>::transform_image(Image<T> const& original_image, size_t threads)
+{
+    Image<T> image_transformed;
+    transform_into(original_image, image_transformed, threads);
+    return image_transformed;
+}
+
+template<typename T>
+void PointwiseTransformer<T>::transform_into(Image<T> const& original_image, Image<T>& out, size_t threads)
+{
+    size_t height = original_image.height();
+    size_t width = original_image.width();
+    out.resize(height, width, original_image.max_color());
+    prepare(original_image.max_color());
+
+    auto shape = TileScheduler::tile_shape_for(height, width, sizeof(RGB<T>));
+    TileScheduler::shared().run_tiles(height, width, shape, 0, threads,
+        [&](Tile const& tile) {
+            for (size_t row = tile.row_begin; row < tile.row_end; ++row) {
+                transform_span(original_image.row_ptr(row) + tile.col_begin, out.row_ptr(row) + tile.col_begin,
+                               tile.col_end - tile.col_begin);
+            }
+        });
+}
+
+template<typename T>
+void PointwiseTransformer<T>::transform_in_place(Image<T>& image, size_t threads)
+{
+    transform_into(image, image, threads);
+}
+
+} // namespace img_proc
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace img_proc::image {
+
+/**
+ * @brief Non-owning run of size contiguous pixels (a C++17 stand-in for std::span).
+ *
+ * @tparam P Pixel type: RGB<T> for a mutable span, const RGB<T> for a read-only one.
+ */
+template<typename P>
+class Span {
+public:
+    Span() = default;
+    Span(P* data, std::size_t size) noexcept;
+
+    P* data() const noexcept;
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    P* begin() const noexcept;
+    P* end() const noexcept;
+
+    /**
+     * @brief Unchecked access to the index-th pixel.
+     */
+    P& operator[](std::size_t index) const noexcept;
+
+private:
+    P* data_{nullptr};
+    std::size_t size_{0};
+};
+
+/**
+ * @brief Non-owning 2D window of pixels whose rows start stride pixels apart.
+ *
+ * A view of a whole image has stride == width; a view of a tile or band keeps the stride of
+ * the buffer it points into. Access is unchecked, so loops over a view compile to plain
+ * pointer arithmetic.
+ *
+ * @tparam P Pixel type: RGB<T> for a mutable view, const RGB<T> for a read-only one.
+ */
+template<typename P>
+class ImageView {
+public:
+    ImageView() = default;
+    ImageView(P* data, std::size_t height, std::size_t width, std::size_t stride) noexcept;
+
+    /**
+     * @brief A mutable view converts to a read-only one.
+     */
+    template<typename Q = P, typename = std::enable_if_t<!std::is_const_v<Q>>>
+    operator ImageView<const Q>() const noexcept;
+
+    /**
+     * @brief Returns the first pixel of the given row.
+     */
+    P* row_ptr(std::size_t row) const noexcept;
+
+    /**
+     * @brief Returns the width pixels of the given row.
+     */
+    Span<P> row(std::size_t row) const noexcept;
+
+    P& at_unchecked(std::size_t row, std::size_t column) const noexcept;
+
+    /**
+     * @brief Returns the height × width window whose top-left pixel is (row, column).
+     */
+    ImageView subview(std::size_t row, std::size_t column, std::size_t height, std::size_t width) const noexcept;
+
+    std::size_t height() const noexcept;
+    std::size_t width() const noexcept;
+    std::size_t stride() const noexcept;
+
+private:
+    P* data_{nullptr};
+    std::size_t height_{0};
+    std::size_t width_{0};
+    std::size_t stride_{0};
+};
+
+} // namespace img_proc::image
+
+#include "img_proc/image_view.inl"
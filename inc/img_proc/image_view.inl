@@ -0,0 +1,108 @@
+#pragma once
+
+#include "img_proc/image_view.hpp"
+
+namespace img_proc::image {
+
+template<typename P>
+Span<P>::Span(P* data, std::size_t size) noexcept
+: data_{data}
+, size_{size}
+{
+}
+
+template<typename P>
+P* Span<P>::data() const noexcept
+{
+    return data_;
+}
+
+template<typename P>
+std::size_t Span<P>::size() const noexcept
+{
+    return size_;
+}
+
+template<typename P>
+bool Span<P>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template<typename P>
+P* Span<P>::begin() const noexcept
+{
+    return data_;
+}
+
+template<typename P>
+P* Span<P>::end() const noexcept
+{
+    return data_ + size_;
+}
+
+template<typename P>
+P& Span<P>::operator[](std::size_t index) const noexcept
+{
+    return data_[index];
+}
+
+template<typename P>
+ImageView<P>::ImageView(P* data, std::size_t height, std::size_t width, std::size_t stride) noexcept
+: data_{data}
+, height_{height}
+, width_{width}
+, stride_{stride}
+{
+}
+
+template<typename P>
+template<typename Q, typename>
+ImageView<P>::operator ImageView<const Q>() const noexcept
+{
+    return ImageView<const Q>{data_, height_, width_, stride_};
+}
+
+template<typename P>
+P* ImageView<P>::row_ptr(std::size_t row) const noexcept
+{
+    return data_ + row * stride_;
+}
+
+template<typename P>
+Span<P> ImageView<P>::row(std::size_t row) const noexcept
+{
+    return Span<P>{row_ptr(row), width_};
+}
+
+template<typename P>
+P& ImageView<P>::at_unchecked(std::size_t row, std::size_t column) const noexcept
+{
+    return data_[row * stride_ + column];
+}
+
+template<typename P>
+ImageView<P> ImageView<P>::subview(std::size_t row, std::size_t column, std::size_t height, std::size_t width) const noexcept
+{
+    return ImageView{row_ptr(row) + column, height, width, stride_};
+}
+
+template<typename P>
+std::size_t ImageView<P>::height() const noexcept
+{
+    return height_;
+}
+
+template<typename P>
+std::size_t ImageView<P>::width() const noexcept
+{
+    return width_;
+}
+
+template<typename P>
+std::size_t ImageView<P>::stride() const noexcept
+{
+    return stride_;
+}
+
+} // namespace img_proc::image
@@ -37,7 +37,7 @@ public:
 };
 
 /**
- * @brief Thrown when a PPM file is not in ASCII P3 format.
+ * @brief Thrown when a file is not one of the supported Netpbm formats (P3, P4, P5, P6).
  * @throws std::invalid_argument
  */
 class FileASCIIException : public std::invalid_argument {
@@ -58,7 +58,7 @@ public:
 };
 
 /**
- * @brief Thrown when an invalid kernel size is given for Gaussian blur.
+ * @brief Thrown when an even or empty kernel is given to a convolution.
  * @throws std::invalid_argument
  */
 class InvalidKernelSizeException : public std::invalid_argument {
@@ -66,11 +66,38 @@ public:
     explicit InvalidKernelSizeException();
 };
 
+/**
+ * @brief Thrown when a zero height or width is requested for a resized image.
+ * @throws std::invalid_argument
+ */
+class InvalidDimensionsException : public std::invalid_argument {
+public:
+    explicit InvalidDimensionsException();
+};
+
+/**
+ * @brief Thrown when a palette of zero colors is requested.
+ * @throws std::invalid_argument
+ */
+class InvalidPaletteSizeException : public std::invalid_argument {
+public:
+    explicit InvalidPaletteSizeException();
+};
+
 class OutOfBoundsException : public std::out_of_range {
 public:
     explicit OutOfBoundsException();
 };
 
+/**
+ * @brief Thrown when a transformer that needs the whole image is given to stream_transform.
+ * @throws std::invalid_argument
+ */
+class StreamingUnsupportedException : public std::invalid_argument {
+public:
+    explicit StreamingUnsupportedException();
+};
+
 /*---------------------------------------------------------*/
 /*                      Implementations                    */
 /*---------------------------------------------------------*/
@@ -91,7 +118,7 @@ inline OutputStreamException::OutputStreamException()
 }
 
 inline FileASCIIException::FileASCIIException()
-: std::invalid_argument("Only P3 PPM (ASCII) is supported")
+: std::invalid_argument("Only P3, P4, P5 and P6 Netpbm images are supported")
 {
 }
 
@@ -101,7 +128,17 @@ inline FileFormatException::FileFormatException()
 }
 
 inline InvalidKernelSizeException::InvalidKernelSizeException()
-: std::invalid_argument("Gaussian kernel size must be odd (3,5,7,9...)")
+: std::invalid_argument("Kernel size must be odd (3,5,7,9...)")
+{
+}
+
+inline InvalidDimensionsException::InvalidDimensionsException()
+: std::invalid_argument("Image height and width must be positive")
+{
+}
+
+inline InvalidPaletteSizeException::InvalidPaletteSizeException()
+: std::invalid_argument("Palette must hold at least one color")
 {
 }
 
@@ -110,4 +147,9 @@ inline OutOfBoundsException::OutOfBoundsException()
 {
 }
 
+inline StreamingUnsupportedException::StreamingUnsupportedException()
+: std::invalid_argument("Only point-wise and tileable stencil transformers can be streamed")
+{
+}
+
 } // namespace img_proc
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace img_proc {
+
+/**
+ * @brief An image file mapped read-only into memory.
+ *
+ * Loaders decode straight from the mapped pages into the pixel buffer, so the file is
+ * never copied into an intermediate string or stream buffer. An empty file has no mapping.
+ *
+ * Members:
+ * - const char* data_: Start of the mapping, or nullptr for an empty file.
+ * - size_t size_: Length of the file in bytes.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Opens and maps the file.
+     * @param path Path of the image file.
+     * @throws FileOpenException if the file cannot be opened, inspected or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    /**
+     * @brief Returns the first byte of the file.
+     */
+    const char* data() const noexcept;
+
+    /**
+     * @brief Returns the length of the file in bytes.
+     */
+    std::size_t size() const noexcept;
+
+private:
+    const char* data_;
+    std::size_t size_;
+};
+
+} // namespace img_proc
+
+#include "img_proc/mapped_file.inl"
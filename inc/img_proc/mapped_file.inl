@@ -0,0 +1,58 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "img_proc/mapped_file.hpp"
+#include "img_proc/img_proc_exceptions.hpp"
+
+namespace img_proc {
+
+inline MappedFile::MappedFile(const std::string& path)
+: data_{nullptr}
+, size_{0}
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw FileOpenException(path);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw FileOpenException(path);
+    }
+
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ > 0) {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw FileOpenException(path);
+        }
+        ::madvise(mapping, size_, MADV_SEQUENTIAL);   // a hint only - failure is harmless
+        data_ = static_cast<const char*>(mapping);
+    }
+    ::close(fd);    // the mapping keeps the file alive
+}
+
+inline MappedFile::~MappedFile()
+{
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+inline const char* MappedFile::data() const noexcept
+{
+    return data_;
+}
+
+inline std::size_t MappedFile::size() const noexcept
+{
+    return size_;
+}
+
+} // namespace img_proc
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <thread>
+
+#include "img_proc/image_proc_interface.hpp"
+#include "img_proc/image_pool.hpp"
+
+namespace img_proc {
+
+/**
+ * @brief Chains transformers and runs the chain with as few full-image passes as possible.
+ *
+ * Stages are grouped into passes when the chain is run:
+ * - consecutive PointwiseTransformers are fused into one pass over each row span;
+ * - a tileable StencilTransformer joins the point-wise stages around it: for every output tile
+ *   the stages before it run on the tile's halo rectangle into a tile-local buffer, the stencil
+ *   reads that buffer, and the stages after it run on the tile's output rows while still cached;
+ * - any other transformer is run on its own through transform_into.
+ *
+ * Intermediate images between passes are taken from, and returned to, an ImagePool owned by
+ * the pipeline, and the last pass writes into the caller's image, so repeated transform_into
+ * calls on frames of one size stop allocating.
+ *
+ * Members:
+ * - stages_: The transformers, in the order they are applied.
+ * - pool_: Intermediate images waiting for reuse.
+ */
+template<typename T>
+class Pipeline : public ImageTransformer<T> {
+public:
+    Pipeline() = default;
+
+    /**
+     * @brief Appends a stage to the chain.
+     * @return The pipeline, for chaining.
+     */
+    Pipeline& add(std::shared_ptr<ImageTransformer<T>> stage);
+
+    /**
+     * @brief Runs every stage in order. An empty pipeline copies the image.
+     */
+    Image<T> transform_image(Image<T> const& original_image, size_t threads = std::thread::hardware_concurrency()) override;
+
+    /**
+     * @brief Runs every stage in order into out; out must not be original_image.
+     */
+    void transform_into(Image<T> const& original_image, Image<T>& out, size_t threads = std::thread::hardware_concurrency()) override;
+
+    /**
+     * @brief Returns the number of stages.
+     */
+    size_t stages() const noexcept;
+
+    /**
+     * @brief Returns the number of fused passes the chain runs as.
+     */
+    size_t passes() const;
+
+    /**
+     * @brief Returns the number of intermediate images kept for reuse.
+     */
+    size_t pooled_images() const;
+
+private:
+    /**
+     * @brief Stages [begin, end) that run as one pass; stencil is null for a point-wise pass,
+     * and opaque is set for a stage that runs on its own.
+     */
+    struct Pass {
+        size_t begin;
+        size_t end;
+        StencilTransformer<T>* stencil;
+        ImageTransformer<T>* opaque;
+    };
+
+    std::vector<Pass> plan() const;
+    void run_pass(Pass const& pass, Image<T> const& input, Image<T>& output, size_t threads) const;
+
+private:
+    std::vector<std::shared_ptr<ImageTransformer<T>>> stages_;
+    ImagePool<T> pool_;
+};
+
+} // namespace img_proc
+
+#include "img_proc/pipeline.inl"
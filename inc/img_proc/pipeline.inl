@@ -0,0 +1,180 @@
+#pragma once
+
+#include "img_proc/pipeline.hpp"
+
+namespace img_proc {
+
+template<typename T>
+Pipeline<T>& Pipeline<T>::add(std::shared_ptr<ImageTransformer<T>> stage)
+{
+    stages_.push_back(std::move(stage));
+    return *this;
+}
+
+template<typename T>
+size_t Pipeline<T>::stages() const noexcept
+{
+    return stages_.size();
+}
+
+template<typename T>
+size_t Pipeline<T>::passes() const
+{
+    return plan().size();
+}
+
+template<typename T>
+size_t Pipeline<T>::pooled_images() const
+{
+    return pool_.size();
+}
+
+template<typename T>
+std::vector<typename Pipeline<T>::Pass> Pipeline<T>::plan() const
+{
+    auto pointwise = [this](size_t i) {
+        return dynamic_cast<PointwiseTransformer<T>*>(stages_[i].get()) != nullptr;
+    };
+
+    std::vector<Pass> passes;
+    size_t i = 0;
+    while (i < stages_.size()) {
+        Pass pass{i, i, nullptr, nullptr};
+        while (pass.end < stages_.size() && pointwise(pass.end)) {
+            ++pass.end;
+        }
+        auto* stencil = pass.end < stages_.size() ? dynamic_cast<StencilTransformer<T>*>(stages_[pass.end].get()) : nullptr;
+        if (stencil != nullptr && stencil->tileable()) {
+            pass.stencil = stencil;
+            ++pass.end;
+            while (pass.end < stages_.size() && pointwise(pass.end)) {
+                ++pass.end;
+            }
+        }
+
+        if (pass.end == pass.begin) {
+            pass.opaque = stages_[pass.begin].get();
+            ++pass.end;
+        }
+        passes.push_back(pass);
+        i = pass.end;
+    }
+    return passes;
+}
+
+template<typename T>
+Image<T> Pipeline<T>::transform_image(Image<T> const& original_image, size_t threads)
+{
+    Image<T> image_transformed;
+    transform_into(original_image, image_transformed, threads);
+    return image_transformed;
+}
+
+template<typename T>
+void Pipeline<T>::transform_into(Image<T> const& original_image, Image<T>& out, size_t threads)
+{
+    auto passes = plan();
+    if (passes.empty()) {
+        out = original_image;
+        return;
+    }
+
+    for (auto const& stage : stages_) {
+        if (auto* pointwise = dynamic_cast<PointwiseTransformer<T>*>(stage.get())) {
+            pointwise->prepare(original_image.max_color());
+        }
+    }
+
+    // Intermediates come from the pool, the last pass writes straight into out
+    Image<T> current;
+    bool owns_current = false;      // false while current has not been produced yet
+    for (size_t i = 0; i < passes.size(); ++i) {
+        Pass const& pass = passes[i];
+        Image<T> const& input = owns_current ? current : original_image;
+        bool last = i + 1 == passes.size();
+        Image<T> output;
+        Image<T>& target = last ? out : output;
+        if (!last) {
+            output = pool_.acquire(input.height(), input.width(), input.max_color());
+        }
+
+        if (pass.opaque != nullptr) {
+            pass.opaque->transform_into(input, target, threads);
+        } else {
+            target.resize(input.height(), input.width(), input.max_color());
+            run_pass(pass, input, target, threads);
+        }
+
+        if (owns_current) {
+            pool_.release(std::move(current));
+        }
+        if (!last) {
+            current = std::move(output);
+            owns_current = true;
+        }
+    }
+}
+
+template<typename T>
+void Pipeline<T>::run_pass(Pass const& pass, Image<T> const& input, Image<T>& output, size_t threads) const
+{
+    size_t height = input.height();
+    size_t width = input.width();
+
+    std::vector<PointwiseTransformer<T>*> before;
+    std::vector<PointwiseTransformer<T>*> after;
+    bool past_stencil = false;
+    for (size_t i = pass.begin; i < pass.end; ++i) {
+        if (stages_[i].get() == pass.stencil) {
+            past_stencil = true;
+        } else {
+            (past_stencil ? after : before).push_back(dynamic_cast<PointwiseTransformer<T>*>(stages_[i].get()));
+        }
+    }
+
+    // Runs a chain of point-wise stages over one span, the first one out of place
+    auto apply = [](std::vector<PointwiseTransformer<T>*> const& chain, const RGB<T>* src, RGB<T>* dst, size_t count) {
+        for (auto* stage : chain) {
+            stage->transform_span(src, dst, count);
+            src = dst;
+        }
+    };
+
+    if (pass.stencil == nullptr) {
+        auto shape = TileScheduler::tile_shape_for(height, width, sizeof(RGB<T>));
+        TileScheduler::shared().run_tiles(height, width, shape, 0, threads, [&](Tile const& tile) {
+            for (size_t row = tile.row_begin; row < tile.row_end; ++row) {
+                apply(before, input.row_ptr(row) + tile.col_begin, output.row_ptr(row) + tile.col_begin, tile.col_end - tile.col_begin);
+            }
+        });
+        return;
+    }
+
+    size_t halo = pass.stencil->halo();
+    auto shape = TileScheduler::tile_shape_for(height, width, sizeof(RGB<T>), halo);
+    TileScheduler::shared().run_tiles(height, width, shape, halo, threads, [&](Tile const& tile) {
+        size_t halo_rows = tile.halo_row_end - tile.halo_row_begin;
+        size_t halo_cols = tile.halo_col_end - tile.halo_col_begin;
+        ImageView<const RGB<T>> src = input.view().subview(tile.halo_row_begin, tile.halo_col_begin, halo_rows, halo_cols);
+
+        std::vector<RGB<T>> staged;
+        if (!before.empty()) {
+            staged.resize(halo_rows * halo_cols);
+            ImageView<RGB<T>> staging{staged.data(), halo_rows, halo_cols, halo_cols};
+            for (size_t row = 0; row < halo_rows; ++row) {
+                apply(before, src.row_ptr(row), staging.row_ptr(row), halo_cols);
+            }
+            src = staging;
+        }
+
+        size_t cols = tile.col_end - tile.col_begin;
+        auto dst = output.view().subview(tile.row_begin, tile.col_begin, tile.row_end - tile.row_begin, cols);
+        pass.stencil->transform_tile(src, tile, dst, input.max_color());
+
+        for (size_t row = 0; row < dst.height(); ++row) {
+            apply(after, dst.row_ptr(row), dst.row_ptr(row), cols);
+        }
+    });
+}
+
+} // namespace img_proc
@@ -46,9 +46,9 @@ struct RGB {
     bool operator==(const RGB<T>& other) const noexcept;
 
     /**
-     * @brief Converts the RGB pixel to a grayscale intensity (0–255 scale).
-     * @return The approximate luminance.
-     * @note used to reduce colors to black and white.
+     * @brief Converts the RGB pixel to a grayscale intensity on the channels' scale.
+     * @return The BT.601 luminance (77 r + 150 g + 29 b + 128) >> 8, in integer arithmetic.
+     * @note The weights add up to 256, so a gray pixel keeps its value exactly.
      */
     T to_intensity() const noexcept;
 
@@ -80,6 +80,11 @@ struct RGB {
 template<typename T>
 std::ostream& operator<<(std::ostream& os, const RGB<T>& rgb);
 
+/**
+ * @brief 8-bit pixel: one byte per channel, for images whose max color is at most 255.
+ */
+using RGB8 = RGB<uint8_t>;
+
 } // namespace img_proc
 
 #include "img_proc/rgb.inl"
@@ -21,7 +21,13 @@ RGB<T>::RGB(T c)
 template<typename T>
 T RGB<T>::to_intensity() const noexcept
 {
-    return static_cast<T>(0.299 * r + 0.587 * g + 0.114 * b);
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(0.299 * r + 0.587 * g + 0.114 * b);
+    } else {
+        // 256 * max + 128 fits in 32 bits for channels of up to 16 bits
+        using Wide = std::conditional_t<(sizeof(T) <= 2), uint32_t, uint64_t>;
+        return static_cast<T>((Wide{77} * r + Wide{150} * g + Wide{29} * b + 128) >> 8);
+    }
 }
 
 template<typename T>
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "img_proc/rgb.hpp"
+
+namespace img_proc::simd {
+
+/**
+ * @brief acc[i] += src[i] * weight for i in [0, count).
+ *
+ * Uses AVX or SSE2 when the compiler targets them and finishes the tail in scalar code.
+ */
+void multiply_add(float* acc, const float* src, float weight, std::size_t count) noexcept;
+
+/**
+ * @brief Converts count samples to float.
+ */
+template<typename T>
+void widen(const T* src, float* dst, std::size_t count) noexcept;
+
+/**
+ * @brief Rounds count floats to the nearest sample value, clamped to [0, max_value].
+ */
+template<typename T>
+void narrow(const float* src, T* dst, std::size_t count, float max_value) noexcept;
+
+/**
+ * @brief dst[i] = src[i].to_intensity() for i in [0, count).
+ *
+ * Integer-only, so the compiler vectorizes it (deinterleaving the channels with byte
+ * shuffles) whenever the target has SSSE3 or better, e.g. with -march=native.
+ */
+template<typename T>
+void intensity(const RGB<T>* src, T* dst, std::size_t count) noexcept;
+
+/**
+ * @brief index[i] = the palette entry nearest to pixel i (squared RGB distance), for i in [0, count).
+ *
+ * Pixels come as three float channel arrays and the palette as three float arrays of entries
+ * values. Pixels run along the vector lanes, so an entry costs three subtractions, three
+ * multiplies and a compare-and-select per 8 (AVX) or 4 (SSE2) pixels. Ties keep the lower entry.
+ */
+void nearest(const float* r, const float* g, const float* b, std::size_t count,
+             const float* palette_r, const float* palette_g, const float* palette_b, std::size_t entries,
+             uint32_t* index) noexcept;
+
+} // namespace img_proc::simd
+
+#include "img_proc/simd.inl"
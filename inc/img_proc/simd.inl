@@ -0,0 +1,121 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#include <limits>
+
+#include "img_proc/simd.hpp"
+
+namespace img_proc::simd {
+
+inline void multiply_add(float* acc, const float* src, float weight, std::size_t count) noexcept
+{
+    std::size_t i = 0;
+#if defined(__AVX__)
+    __m256 weight8 = _mm256_set1_ps(weight);
+    for (; i + 8 <= count; i += 8) {
+        __m256 product = _mm256_mul_ps(_mm256_loadu_ps(src + i), weight8);
+        _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), product));
+    }
+#endif
+#if defined(__SSE2__)
+    __m128 weight4 = _mm_set1_ps(weight);
+    for (; i + 4 <= count; i += 4) {
+        __m128 product = _mm_mul_ps(_mm_loadu_ps(src + i), weight4);
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), product));
+    }
+#endif
+    for (; i < count; ++i) {
+        acc[i] += src[i] * weight;
+    }
+}
+
+inline void nearest(const float* r, const float* g, const float* b, std::size_t count,
+                    const float* palette_r, const float* palette_g, const float* palette_b, std::size_t entries,
+                    uint32_t* index) noexcept
+{
+    std::size_t i = 0;
+#if defined(__AVX__)
+    for (; i + 8 <= count; i += 8) {
+        __m256 pr = _mm256_loadu_ps(r + i);
+        __m256 pg = _mm256_loadu_ps(g + i);
+        __m256 pb = _mm256_loadu_ps(b + i);
+        __m256 best = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+        __m256 best_entry = _mm256_setzero_ps();
+        for (std::size_t e = 0; e < entries; ++e) {
+            __m256 dr = _mm256_sub_ps(pr, _mm256_set1_ps(palette_r[e]));
+            __m256 dg = _mm256_sub_ps(pg, _mm256_set1_ps(palette_g[e]));
+            __m256 db = _mm256_sub_ps(pb, _mm256_set1_ps(palette_b[e]));
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dr, dr), _mm256_mul_ps(dg, dg)), _mm256_mul_ps(db, db));
+            __m256 closer = _mm256_cmp_ps(distance, best, _CMP_LT_OQ);
+            best = _mm256_blendv_ps(best, distance, closer);
+            best_entry = _mm256_blendv_ps(best_entry, _mm256_set1_ps(static_cast<float>(e)), closer);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(index + i), _mm256_cvttps_epi32(best_entry));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        __m128 pr = _mm_loadu_ps(r + i);
+        __m128 pg = _mm_loadu_ps(g + i);
+        __m128 pb = _mm_loadu_ps(b + i);
+        __m128 best = _mm_set1_ps(std::numeric_limits<float>::infinity());
+        __m128 best_entry = _mm_setzero_ps();
+        for (std::size_t e = 0; e < entries; ++e) {
+            __m128 dr = _mm_sub_ps(pr, _mm_set1_ps(palette_r[e]));
+            __m128 dg = _mm_sub_ps(pg, _mm_set1_ps(palette_g[e]));
+            __m128 db = _mm_sub_ps(pb, _mm_set1_ps(palette_b[e]));
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+            __m128 closer = _mm_cmplt_ps(distance, best);
+            best = _mm_or_ps(_mm_and_ps(closer, distance), _mm_andnot_ps(closer, best));
+            best_entry = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(e))), _mm_andnot_ps(closer, best_entry));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index + i), _mm_cvttps_epi32(best_entry));
+    }
+#endif
+    for (; i < count; ++i) {
+        float best = std::numeric_limits<float>::infinity();
+        uint32_t best_entry = 0;
+        for (std::size_t e = 0; e < entries; ++e) {
+            float dr = r[i] - palette_r[e];
+            float dg = g[i] - palette_g[e];
+            float db = b[i] - palette_b[e];
+            float distance = dr * dr + dg * dg + db * db;
+            if (distance < best) {
+                best = distance;
+                best_entry = static_cast<uint32_t>(e);
+            }
+        }
+        index[i] = best_entry;
+    }
+}
+
+template<typename T>
+void widen(const T* src, float* dst, std::size_t count) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+}
+
+template<typename T>
+void narrow(const float* src, T* dst, std::size_t count, float max_value) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        float value = src[i] + 0.5f;
+        value = value < 0.0f ? 0.0f : (value > max_value ? max_value : value);
+        dst[i] = static_cast<T>(value);
+    }
+}
+
+template<typename T>
+void intensity(const RGB<T>* src, T* dst, std::size_t count) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = src[i].to_intensity();
+    }
+}
+
+} // namespace img_proc::simd
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "img_proc/image_proc_interface.hpp"
+
+namespace img_proc {
+
+namespace detail {
+
+/**
+ * @brief Reads a Netpbm image from a stream one band of rows at a time.
+ *
+ * Only a fixed-size window of the encoded file is buffered. P3 samples are parsed from the
+ * part of the window that ends on whitespace, so no sample is split across two refills.
+ *
+ * Members:
+ * - is_: The stream being read.
+ * - header_: Format, dimensions and max color of the image.
+ * - buffer_: Encoded bytes read ahead of the parser.
+ * - pos_, end_: Unparsed bytes are buffer_[pos_, end_).
+ * - safe_: P3 samples are parsed from buffer_[pos_, safe_), which ends on whitespace or EOF.
+ * - rows_read_: Number of rows already returned.
+ */
+template<typename T>
+class RowReader {
+public:
+    /**
+     * @brief Reads and validates the header.
+     * @throws InputStreamException, FileASCIIException or FileFormatException.
+     */
+    explicit RowReader(std::istream& is);
+
+    /**
+     * @brief Decodes the next rows into dst, width pixels per row.
+     * @throws FileFormatException if the raster is truncated or malformed.
+     */
+    void read(RGB<T>* dst, size_t rows);
+
+    image::detail::Header const& header() const noexcept;
+
+private:
+    bool refill();
+    size_t next_sample();
+
+private:
+    std::istream& is_;
+    image::detail::Header header_;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    size_t safe_ = 0;
+    bool eof_ = false;
+    size_t rows_read_ = 0;
+};
+
+/**
+ * @brief Rows of pixels handed between the streaming threads.
+ */
+template<typename T>
+struct Band {
+    std::vector<RGB<T>> pixels;
+    size_t rows = 0;
+};
+
+/**
+ * @brief A blocking FIFO of at most capacity items that can be closed.
+ *
+ * Closing wakes every waiter: push then fails, and pop fails once the queue is empty.
+ *
+ * Members:
+ * - items_: The queued items.
+ * - capacity_: Maximum number of queued items.
+ * - closed_: Set by close().
+ * - mutex_, not_full_, not_empty_: Guard and signal the fields above.
+ */
+template<typename Item>
+class BandQueue {
+public:
+    explicit BandQueue(size_t capacity);
+
+    /**
+     * @brief Blocks while the queue is full, then appends item.
+     * @return false, leaving item unused, if the queue is closed.
+     */
+    bool push(Item&& item);
+
+    /**
+     * @brief Blocks while the queue is empty and open, then removes the oldest item into item.
+     * @return false if the queue is closed and empty.
+     */
+    bool pop(Item& item);
+
+    void close() noexcept;
+
+private:
+    std::deque<Item> items_;
+    size_t capacity_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Transforms a Netpbm image band by band, without holding the whole image in memory.
+ *
+ * The input is decoded band_rows rows at a time and each band is transformed as soon as the
+ * rows below it that the transformer reads (its halo) have arrived. Output rows are encoded
+ * in the input's format and written immediately. One reader thread decodes up to two bands
+ * ahead and one writer thread encodes up to two bands behind while the current band is
+ * computed; band buffers go back and forth through small bounded queues, so memory stays at
+ * a few bands plus twice the halo rows: O(width * (band_rows + kernel)).
+ *
+ * Only transformers that can work on part of an image are supported: PointwiseTransformers
+ * and tileable StencilTransformers (e.g. GaussianBlur below its box blur threshold).
+ *
+ * @param band_rows Rows decoded, transformed and written per step (0 is treated as 1).
+ * @param threads Number of threads computing each band.
+ * @throws StreamingUnsupportedException for any other transformer, plus the loader and saver
+ * exceptions for bad input or output streams.
+ */
+template<typename T>
+void stream_transform(std::istream& is, std::ostream& os, ImageTransformer<T>& transformer,
+                      size_t band_rows = 64, size_t threads = std::thread::hardware_concurrency());
+
+/**
+ * @brief Streams the image file at input_path through the transformer into output_path.
+ * @throws FileOpenException if either file cannot be opened.
+ */
+template<typename T>
+void stream_transform(const std::string& input_path, const std::string& output_path, ImageTransformer<T>& transformer,
+                      size_t band_rows = 64, size_t threads = std::thread::hardware_concurrency());
+
+} // namespace img_proc
+
+#include "img_proc/stream_proc.inl"
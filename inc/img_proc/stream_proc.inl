@@ -0,0 +1,391 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <exception>
+
+#include "img_proc/stream_proc.hpp"
+#include "img_proc/img_proc_exceptions.hpp"
+
+namespace img_proc {
+
+namespace detail {
+
+template<typename T>
+RowReader<T>::RowReader(std::istream& is)
+: is_{is}
+, header_{}
+, buffer_(image::detail::encode_block)
+{
+    if (!is_) {
+        throw InputStreamException();
+    }
+    refill();
+
+    image::detail::Cursor cur{buffer_.data(), buffer_.data() + end_};
+    header_ = image::detail::parse_header<T>(cur);
+    if (cur.pos == cur.end && !eof_) {
+        throw FileFormatException();    // header does not fit in the read window
+    }
+    pos_ = static_cast<size_t>(cur.pos - buffer_.data());
+
+    if (header_.format != image::Format::P3) {
+        // A single whitespace character separates the header from the binary raster
+        if (pos_ == end_ || !image::detail::is_space(buffer_[pos_])) {
+            throw FileFormatException();
+        }
+        ++pos_;
+        buffer_.resize(std::max(buffer_.size(), image::detail::binary_row_bytes(header_)));
+    }
+}
+
+template<typename T>
+image::detail::Header const& RowReader<T>::header() const noexcept
+{
+    return header_;
+}
+
+template<typename T>
+bool RowReader<T>::refill()
+{
+    if (eof_) {
+        return false;
+    }
+
+    std::copy(buffer_.begin() + static_cast<std::ptrdiff_t>(pos_), buffer_.begin() + static_cast<std::ptrdiff_t>(end_), buffer_.begin());
+    end_ -= pos_;
+    pos_ = 0;
+
+    is_.read(buffer_.data() + end_, static_cast<std::streamsize>(buffer_.size() - end_));
+    size_t got = static_cast<size_t>(is_.gcount());
+    end_ += got;
+    if (is_.bad()) {
+        throw InputStreamException();
+    }
+    eof_ = is_.eof();
+
+    safe_ = end_;
+    if (!eof_) {
+        while (safe_ != pos_ && !image::detail::is_space(buffer_[safe_ - 1])) {
+            --safe_;
+        }
+    }
+    return got != 0;
+}
+
+template<typename T>
+size_t RowReader<T>::next_sample()
+{
+    for (;;) {
+        while (pos_ != safe_ && image::detail::is_space(buffer_[pos_])) {
+            ++pos_;
+        }
+        if (pos_ != safe_) {
+            break;
+        }
+        if (!refill()) {
+            throw FileFormatException();
+        }
+    }
+
+    image::detail::Cursor cur{buffer_.data() + pos_, buffer_.data() + safe_};
+    size_t value = image::detail::parse_decimal(cur, header_.max_color);
+    pos_ = static_cast<size_t>(cur.pos - buffer_.data());
+    return value;
+}
+
+template<typename T>
+void RowReader<T>::read(RGB<T>* dst, size_t rows)
+{
+    if (rows > header_.height - rows_read_) {
+        throw FileFormatException();
+    }
+    rows_read_ += rows;
+
+    size_t width = header_.width;
+    if (header_.format == image::Format::P3) {
+        for (size_t i = 0; i < rows * width; ++i) {
+            T r = static_cast<T>(next_sample());
+            T g = static_cast<T>(next_sample());
+            T b = static_cast<T>(next_sample());
+            dst[i] = RGB<T>(r, g, b);
+        }
+        return;
+    }
+
+    size_t row_bytes = image::detail::binary_row_bytes(header_);
+    for (size_t row = 0; row < rows; ++row) {
+        while (end_ - pos_ < row_bytes) {
+            if (!refill()) {
+                throw FileFormatException();
+            }
+        }
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(buffer_.data() + pos_);
+        image::detail::decode_binary_row(src, dst + row * width, header_);
+        pos_ += row_bytes;
+    }
+}
+
+template<typename Item>
+BandQueue<Item>::BandQueue(size_t capacity)
+: items_{}
+, capacity_{std::max<size_t>(capacity, 1)}
+{
+}
+
+template<typename Item>
+bool BandQueue<Item>::push(Item&& item)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+    }
+    not_empty_.notify_one();
+    return true;
+}
+
+template<typename Item>
+bool BandQueue<Item>::pop(Item& item)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+    }
+    not_full_.notify_one();
+    return true;
+}
+
+template<typename Item>
+void BandQueue<Item>::close() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+}
+
+} // namespace detail
+
+template<typename T>
+void stream_transform(std::istream& is, std::ostream& os, ImageTransformer<T>& transformer,
+                      size_t band_rows, size_t threads)
+{
+    auto* pointwise = dynamic_cast<PointwiseTransformer<T>*>(&transformer);
+    auto* stencil = dynamic_cast<StencilTransformer<T>*>(&transformer);
+    if (pointwise == nullptr && (stencil == nullptr || !stencil->tileable())) {
+        throw StreamingUnsupportedException();
+    }
+    if (!os) {
+        throw OutputStreamException();
+    }
+
+    detail::RowReader<T> reader(is);
+    image::detail::Header header = reader.header();
+    if (header.format != image::Format::P3 && header.max_color > 0xFFFF) {
+        throw FileFormatException();
+    }
+    size_t width = header.width;
+    size_t height = header.height;
+    band_rows = std::max<size_t>(band_rows, 1);
+    size_t halo = (pointwise == nullptr) ? stencil->halo() : 0;
+    if (pointwise != nullptr) {
+        pointwise->prepare(header.max_color);
+    }
+
+    // window holds input rows [window_first, window_first + window_rows): the halo rows above
+    // the current band, the band, and the halo rows below it
+    std::vector<RGB<T>> window((band_rows + 2 * halo) * width);
+    size_t window_first = 0;
+    size_t window_rows = std::min(band_rows + halo, height);
+    reader.read(window.data(), window_rows);
+
+    std::string encoded;
+    encoded.reserve(image::detail::encode_block + width * 24);
+    image::detail::append_header(encoded, header);
+    os.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+
+    // Empty bands circulate between the threads: the reader fills read_free bands into read_full,
+    // the computation fills write_free bands into write_full and the writer drains them back
+    constexpr size_t bands_in_flight = 2;
+    detail::BandQueue<detail::Band<T>> read_free{bands_in_flight};
+    detail::BandQueue<detail::Band<T>> read_full{bands_in_flight};
+    detail::BandQueue<detail::Band<T>> write_free{bands_in_flight};
+    detail::BandQueue<detail::Band<T>> write_full{bands_in_flight};
+    for (size_t i = 0; i < bands_in_flight; ++i) {
+        read_free.push(detail::Band<T>{std::vector<RGB<T>>(band_rows * width), 0});
+        write_free.push(detail::Band<T>{std::vector<RGB<T>>(band_rows * width), 0});
+    }
+
+    // A failing thread records its exception before closing its queues, so whoever finds a
+    // queue closed finds the error too
+    std::exception_ptr read_error;
+    std::exception_ptr write_error;
+
+    std::thread read_thread([&, rows_left = height - window_rows]() mutable {
+        try {
+            detail::Band<T> band;
+            while (rows_left != 0 && read_free.pop(band)) {
+                band.rows = std::min(band_rows, rows_left);
+                reader.read(band.pixels.data(), band.rows);
+                rows_left -= band.rows;
+                if (!read_full.push(std::move(band))) {
+                    return;
+                }
+            }
+        } catch (...) {
+            read_error = std::current_exception();
+            read_full.close();
+        }
+    });
+
+    std::thread write_thread([&] {
+        try {
+            detail::Band<T> band;
+            while (write_full.pop(band)) {
+                encoded.clear();
+                for (size_t row = 0; row < band.rows; ++row) {
+                    image::detail::append_row(encoded, band.pixels.data() + row * width, header);
+                    if (encoded.size() >= image::detail::encode_block) {
+                        os.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+                        encoded.clear();
+                    }
+                }
+                os.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+                if (!os) {
+                    throw OutputStreamException();
+                }
+                write_free.push(std::move(band));
+            }
+        } catch (...) {
+            write_error = std::current_exception();
+            write_free.close();
+            write_full.close();
+        }
+    });
+
+    // Stops both threads on every exit; the writer still drains the bands queued before
+    struct Join {
+        std::thread& reader;
+        std::thread& writer;
+        detail::BandQueue<detail::Band<T>>* queues[4];
+        ~Join()
+        {
+            for (auto* queue : queues) {
+                queue->close();
+            }
+            reader.join();
+            if (writer.joinable()) {
+                writer.join();
+            }
+        }
+    } join{read_thread, write_thread, {&read_free, &read_full, &write_free, &write_full}};
+
+    auto shape = TileScheduler::tile_shape_for(band_rows, width, sizeof(RGB<T>), halo);
+    size_t band_end = 0;
+    for (size_t band_begin = 0; band_begin < height; band_begin = band_end) {
+        band_end = std::min(band_begin + band_rows, height);
+        size_t band_height = band_end - band_begin;
+
+        detail::Band<T> result;
+        if (!write_free.pop(result)) {
+            std::rethrow_exception(write_error);
+        }
+
+        // in's row 0 is image row window_first, out's row 0 is image row band_begin
+        ImageView<const RGB<T>> in{window.data(), window_rows, width, width};
+        ImageView<RGB<T>> out{result.pixels.data(), band_height, width, width};
+        if (pointwise != nullptr) {
+            size_t rows_per_task = std::max<size_t>(shape.rows, 1);
+            size_t tasks = (band_height + rows_per_task - 1) / rows_per_task;
+            TileScheduler::shared().parallel_for(tasks, threads, [&](size_t index) {
+                size_t first = index * rows_per_task;
+                size_t last = std::min(first + rows_per_task, band_height);
+                pointwise->transform_span(in.row_ptr(band_begin + first - window_first), out.row_ptr(first), (last - first) * width);
+            });
+        } else {
+            size_t rows = std::max<size_t>(shape.rows, 1);
+            size_t cols = std::max<size_t>(shape.cols, 1);
+            size_t tiles_down = (band_height + rows - 1) / rows;
+            size_t tiles_across = (width + cols - 1) / cols;
+            TileScheduler::shared().parallel_for(tiles_down * tiles_across, threads, [&](size_t index) {
+                Tile tile;
+                tile.row_begin = band_begin + (index / tiles_across) * rows;
+                tile.row_end = std::min(tile.row_begin + rows, band_end);
+                tile.col_begin = (index % tiles_across) * cols;
+                tile.col_end = std::min(tile.col_begin + cols, width);
+                tile.halo_row_begin = tile.row_begin > halo ? tile.row_begin - halo : 0;
+                tile.halo_row_end = std::min(tile.row_end + halo, height);
+                tile.halo_col_begin = tile.col_begin > halo ? tile.col_begin - halo : 0;
+                tile.halo_col_end = std::min(tile.col_end + halo, width);
+
+                auto src = in.subview(tile.halo_row_begin - window_first, tile.halo_col_begin,
+                                      tile.halo_row_end - tile.halo_row_begin, tile.halo_col_end - tile.halo_col_begin);
+                auto dst = out.subview(tile.row_begin - band_begin, tile.col_begin,
+                                       tile.row_end - tile.row_begin, tile.col_end - tile.col_begin);
+                stencil->transform_tile(src, tile, dst, header.max_color);
+            });
+        }
+
+        result.rows = band_height;
+        if (!write_full.push(std::move(result))) {
+            std::rethrow_exception(write_error);
+        }
+
+        // Keep the rows the next band reads above itself, then append the next band read
+        size_t window_end = window_first + window_rows;
+        size_t keep_first = std::max(band_end > halo ? band_end - halo : 0, window_first);
+        std::copy(window.begin() + static_cast<std::ptrdiff_t>((keep_first - window_first) * width),
+                  window.begin() + static_cast<std::ptrdiff_t>((window_end - window_first) * width),
+                  window.begin());
+        size_t next_rows = 0;
+        if (window_end != height) {
+            detail::Band<T> incoming;
+            if (!read_full.pop(incoming)) {
+                std::rethrow_exception(read_error);
+            }
+            next_rows = incoming.rows;
+            std::copy(incoming.pixels.begin(), incoming.pixels.begin() + static_cast<std::ptrdiff_t>(next_rows * width),
+                      window.begin() + static_cast<std::ptrdiff_t>((window_end - keep_first) * width));
+            read_free.push(std::move(incoming));
+        }
+        window_first = keep_first;
+        window_rows = window_end - keep_first + next_rows;
+    }
+
+    write_full.close();
+    write_thread.join();
+    if (write_error) {
+        std::rethrow_exception(write_error);
+    }
+    if (!os) {
+        throw OutputStreamException();
+    }
+}
+
+template<typename T>
+void stream_transform(const std::string& input_path, const std::string& output_path, ImageTransformer<T>& transformer,
+                      size_t band_rows, size_t threads)
+{
+    std::ifstream in(input_path, std::ios::binary);
+    if (!in) {
+        throw FileOpenException(input_path);
+    }
+    std::ofstream out(output_path, std::ios::binary);
+    if (!out) {
+        throw FileOpenException(output_path);
+    }
+    stream_transform(in, out, transformer, band_rows, threads);
+}
+
+} // namespace img_proc
@@ -7,12 +7,16 @@ namespace img_proc {
     
 /**
  * @brief Executes a given task in parallel across multiple threads.
+ *
+ * Runs on the persistent TileScheduler::shared() threads: the row range is cut into several
+ * bands per thread and the threads claim bands dynamically, so no thread is created per call
+ * and an uneven band does not hold the others back.
  */
 class ThreadWorker {
 public:
     /**
      * @brief Constructs a ThreadWorker with a given number of threads.
-     * @param thread_count Number of threads to launch.
+     * @param thread_count Number of threads to use (0 is treated as 1).
      */
     explicit ThreadWorker(std::size_t thread_count);
 
@@ -29,4 +33,4 @@ private:
 
 } // namespace img_proc
 
-#include "img_proc/thread_wrkr.inl"
\ No newline at end of file
+#include "img_proc/thread_wrkr.inl"
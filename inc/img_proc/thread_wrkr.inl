@@ -1,41 +1,31 @@
 #pragma once
 
 #include "img_proc/thread_wrkr.hpp"
+#include "img_proc/tile_scheduler.hpp"
 
-#include <thread>
-#include <vector>
+#include <algorithm>
 
 namespace img_proc {
     
-ThreadWorker::ThreadWorker(std::size_t thread_count)
-: thread_count_(thread_count)
+inline ThreadWorker::ThreadWorker(std::size_t thread_count)
+: thread_count_(std::max<std::size_t>(thread_count, 1))
 {
 }
 
-void ThreadWorker::run(std::size_t total_rows, std::function<void(std::size_t, std::size_t)> task)
+inline void ThreadWorker::run(std::size_t total_rows, std::function<void(std::size_t, std::size_t)> task)
 {
-    std::vector<std::thread> threads;
-    std::size_t rows_per_thread = total_rows / thread_count_;
-
-    // Launch (thread_count_ - 1) threads
-    for (std::size_t i = 1; i < thread_count_; ++i) {
-        std::size_t start = i * rows_per_thread;
-        std::size_t end = (i == thread_count_ - 1) ? total_rows : start + rows_per_thread;
-
-        threads.emplace_back([=]() {
-            task(start, end);
-        });
+    constexpr std::size_t bands_per_thread = 4;
+    std::size_t bands = std::min(total_rows, thread_count_ * bands_per_thread);
+    if (bands == 0) {
+        return;
     }
+    std::size_t rows_per_band = (total_rows + bands - 1) / bands;
+    bands = (total_rows + rows_per_band - 1) / rows_per_band;
 
-    // Main thread does the first chunk itself
-    std::size_t start = 0;
-    std::size_t end = (thread_count_ == 1) ? total_rows : rows_per_thread;
-    task(start, end);
-
-    // Now join the worker threads
-    for (auto& t : threads) {
-        t.join();
-    }
+    TileScheduler::shared().parallel_for(bands, thread_count_, [&](std::size_t band) {
+        std::size_t start = band * rows_per_band;
+        task(start, std::min(start + rows_per_band, total_rows));
+    });
 }
 
 } // namespace img_proc
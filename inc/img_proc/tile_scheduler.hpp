@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+namespace img_proc {
+
+/**
+ * @brief A rectangle of output pixels and the input rectangle a stencil needs to produce it.
+ *
+ * The halo rectangle grows the tile by the stencil radius on every side and is clipped to the
+ * image, so a filter reads exactly [halo_row_begin, halo_row_end) × [halo_col_begin, halo_col_end).
+ */
+struct Tile {
+    size_t row_begin;
+    size_t row_end;
+    size_t col_begin;
+    size_t col_end;
+    size_t halo_row_begin;
+    size_t halo_row_end;
+    size_t halo_col_begin;
+    size_t halo_col_end;
+};
+
+/**
+ * @brief Rows and columns of one tile.
+ */
+struct TileShape {
+    size_t rows;
+    size_t cols;
+};
+
+/**
+ * @brief Persistent worker threads that execute indexed jobs and 2D tile grids.
+ *
+ * Workers are started once and sleep between jobs; a job is a count of work items that the
+ * caller and up to (threads - 1) workers claim one at a time from an atomic counter, so fast
+ * threads simply take more items. One job runs at a time; a job started from inside a running
+ * job executes inline on the calling worker. The first exception thrown by an item stops the
+ * job and is rethrown to the caller. A job asking for more threads than the scheduler has starts
+ * the missing workers, which stay for later jobs: the requested thread count is honored even
+ * beyond hardware_concurrency(), so the shared scheduler is not serial on a single core.
+ *
+ * Members:
+ * - workers_: The persistent threads, only grown by a caller holding submit_mutex_.
+ * - thread_count_: workers_.size() + 1, readable without the lock.
+ * - submit_mutex_: Serializes callers, one job at a time.
+ * - mutex_, wake_, done_: Guard and signal the job fields below.
+ * - task_, count_, next_: The current job and the next unclaimed item.
+ * - seats_: Workers still allowed to join the current job.
+ * - active_: Workers currently inside the current job.
+ * - generation_: Bumped for every job, so a worker joins each job at most once.
+ * - error_: First exception thrown by the current job.
+ */
+class TileScheduler {
+public:
+    /// Input bytes a tile (halo included) should occupy: half of a typical 256 KiB L2
+    static constexpr size_t tile_bytes = 128 * 1024;
+
+    /**
+     * @brief Starts (threads - 1) workers; the caller of a job is the remaining thread.
+     * @param threads Initial thread count, 0 is treated as 1. Jobs may start more workers.
+     */
+    explicit TileScheduler(size_t threads = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Stops and joins the workers.
+     */
+    ~TileScheduler();
+
+    TileScheduler(TileScheduler const&) = delete;
+    TileScheduler& operator=(TileScheduler const&) = delete;
+
+    /**
+     * @brief The process-wide scheduler used by the transformers.
+     */
+    static TileScheduler& shared();
+
+    /**
+     * @brief Returns the number of threads started so far, the caller included.
+     */
+    size_t threads() const noexcept;
+
+    /**
+     * @brief Calls task(i) for every i in [0, count) on at most max_threads threads.
+     *
+     * Starts workers first if fewer than min(max_threads, count) threads exist.
+     */
+    void parallel_for(size_t count, size_t max_threads, std::function<void(size_t)> const& task);
+
+    /**
+     * @brief Covers a height × width image with tiles of the given shape and runs task on each.
+     * @param halo Stencil radius the tiles' halo rectangles are grown by.
+     */
+    void run_tiles(size_t height, size_t width, TileShape shape, size_t halo, size_t max_threads,
+                   std::function<void(Tile const&)> const& task);
+
+    /**
+     * @brief Picks a tile shape whose halo-grown input fits tile_bytes.
+     *
+     * Rows wider than 1024 columns are cut into equal tile widths, so row segments stay long enough to vectorize,
+     * and are at least 2 × halo rows tall, so the recomputed halo never dominates.
+     */
+    static TileShape tile_shape_for(size_t height, size_t width, size_t bytes_per_pixel, size_t halo = 0) noexcept;
+
+private:
+    void grow(size_t threads);
+    void worker_loop();
+    void drain();
+
+private:
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> thread_count_{1};
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    std::function<void(size_t)> const* task_{nullptr};
+    size_t count_{0};
+    std::atomic<size_t> next_{0};
+    size_t seats_{0};
+    size_t active_{0};
+    uint64_t generation_{0};
+    bool stop_{false};
+    std::exception_ptr error_;
+};
+
+} // namespace img_proc
+
+#include "img_proc/tile_scheduler.inl"
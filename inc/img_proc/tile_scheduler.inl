@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+
+#include "img_proc/tile_scheduler.hpp"
+
+namespace img_proc {
+
+namespace detail {
+
+inline thread_local bool inside_tile_job = false;
+
+} // namespace detail
+
+inline TileScheduler::TileScheduler(size_t threads)
+{
+    grow(threads);
+}
+
+inline TileScheduler::~TileScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+inline TileScheduler& TileScheduler::shared()
+{
+    static TileScheduler scheduler;
+    return scheduler;
+}
+
+inline size_t TileScheduler::threads() const noexcept
+{
+    return thread_count_.load(std::memory_order_relaxed);
+}
+
+inline void TileScheduler::parallel_for(size_t count, size_t max_threads, std::function<void(size_t)> const& task)
+{
+    if (count == 0) {
+        return;
+    }
+
+    size_t helpers = std::min(max_threads > 1 ? max_threads - 1 : 0, count - 1);
+    if (helpers == 0 || detail::inside_tile_job) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submit_mutex_);
+    grow(helpers + 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        seats_ = helpers;
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    detail::inside_tile_job = true;
+    drain();
+    detail::inside_tile_job = false;
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        seats_ = 0;     // late wakers must not join a finished job
+        done_.wait(lock, [this] { return active_ == 0; });
+        task_ = nullptr;
+        error = error_;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+inline void TileScheduler::run_tiles(size_t height, size_t width, TileShape shape, size_t halo, size_t max_threads,
+                                     std::function<void(Tile const&)> const& task)
+{
+    if (height == 0 || width == 0) {
+        return;
+    }
+    size_t rows = std::max<size_t>(shape.rows, 1);
+    size_t cols = std::max<size_t>(shape.cols, 1);
+    size_t tiles_down = (height + rows - 1) / rows;
+    size_t tiles_across = (width + cols - 1) / cols;
+
+    parallel_for(tiles_down * tiles_across, max_threads, [&](size_t index) {
+        Tile tile;
+        tile.row_begin = (index / tiles_across) * rows;
+        tile.row_end = std::min(tile.row_begin + rows, height);
+        tile.col_begin = (index % tiles_across) * cols;
+        tile.col_end = std::min(tile.col_begin + cols, width);
+        tile.halo_row_begin = tile.row_begin > halo ? tile.row_begin - halo : 0;
+        tile.halo_row_end = std::min(tile.row_end + halo, height);
+        tile.halo_col_begin = tile.col_begin > halo ? tile.col_begin - halo : 0;
+        tile.halo_col_end = std::min(tile.col_end + halo, width);
+        task(tile);
+    });
+}
+
+inline TileShape TileScheduler::tile_shape_for(size_t height, size_t width, size_t bytes_per_pixel, size_t halo) noexcept
+{
+    constexpr size_t max_cols = 1024;
+    size_t tiles_across = (std::max<size_t>(width, 1) + max_cols - 1) / max_cols;
+    size_t cols = (std::max<size_t>(width, 1) + tiles_across - 1) / tiles_across;     // equal widths, no sliver
+    size_t row_bytes = (cols + 2 * halo) * std::max<size_t>(bytes_per_pixel, 1);
+    size_t rows_in_budget = tile_bytes / row_bytes;
+    size_t rows = rows_in_budget > 2 * halo ? rows_in_budget - 2 * halo : 0;
+    rows = std::max({rows, 2 * halo, size_t{8}});
+    return TileShape{std::min(rows, std::max<size_t>(height, 1)), cols};
+}
+
+inline void TileScheduler::grow(size_t threads)
+{
+    // Callers hold submit_mutex_ or are the constructor, so no job is running
+    workers_.reserve(threads);
+    while (workers_.size() + 1 < threads) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+    thread_count_.store(workers_.size() + 1, std::memory_order_relaxed);
+}
+
+inline void TileScheduler::worker_loop()
+{
+    detail::inside_tile_job = true;
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [&] { return stop_ || (generation_ != seen && seats_ > 0); });
+        if (stop_) {
+            return;
+        }
+        seen = generation_;
+        --seats_;
+        ++active_;
+
+        lock.unlock();
+        drain();
+        lock.lock();
+
+        if (--active_ == 0) {
+            done_.notify_all();
+        }
+    }
+}
+
+inline void TileScheduler::drain()
+{
+    size_t index;
+    while ((index = next_.fetch_add(1, std::memory_order_relaxed)) < count_) {
+        try {
+            (*task_)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            next_.store(count_, std::memory_order_relaxed);    // abandon the remaining items
+        }
+    }
+}
+
+} // namespace img_proc
@@ -731,7 +731,7 @@ ass MT_Tracer:public std::ostream {public:MT_Tracer():std::ostream(std::cout.rdb
 name __V__ T>MT_Tracer bitand trace(T const bitand o){if(!mt__trace_on){return *this;}if(!mt__current_test_was_traced){mt__current_test_was_traced=1;M__FP MT_CLR(KBCYN) "\tTracing    -    " MT_CLR(KBBLU) "%s\n", mt__current_test_name);}std::cout << MT_CLR(KWHT) << o << MT_CLR(KNRM);return *this; %>%>;template<type\
 name T>MT_Tracer bitand operator<<(MT_Tracer bitand mt,T const bitand obj){return mt.trace(obj);}MT_Tracer TRACER;MT_Tracer bitand TOUT = TRACER;cl\
 ass UnKnownException:public std::runtime_error{public:UnKnownException():std::runtime_error("Non C++ Standard Exception Caught!" MT_CLR(KBCYN) "\n\t\t\t\tPlease use std::exception derived classes!")
-<%__V__%>%>;__FUNTASTICUSV MT_SGU2(std::exception const bitand x, struct mt__AssertResult*r){__CITATS char p<:1024:>;0<:p]=0;strcat(p,"Caught C++ Exception of type: " MT_CLR(KBBLU));strcat(p, typeid(x).name());strcat(p, "\n\t\t\t\t" MT_CLR(KGRN) "what: " MT_CLR(KBBLU));strcat(p, x.what());r->message=p;r->youShalN0tPass=MT_XCEPT;}
+<%__V__%>%>;__FUNTASTICUSV MT_SGU2(std::exception const bitand x, struct mt__AssertResult*r){__CITATS char p<:1024:>;0<:p]=0;strcat(p,"Caught C++ Exception of type: " MT_CLR(KBBLU));strcat(p, typeid(x).name());strcat(p, "\n\t\t\t\t" MT_CLR(KGRN) "what: " MT_CLR(KBBLU));strcat(p, x.what());r->message=p;r->youShalN0tPass=MT_XCEPT;r->actual_expected=0;}
 #define MT_TRAXER <% TRACER.verbose(mt__trace_on); %>
 \
 %\
@@ -29,28 +29,25 @@ public:
     
     virtual ~Atbash() override = default;
 
-private:
     /**
-     * @brief Encodes a single character using the Atbash cipher.
+     * @brief Encodes a buffer using the Atbash cipher.
      * 
-     * Looks up the character in the pre-initialized lookup table to get its 
-     * corresponding encoded character.
+     * Mirrors every letter within its case; other characters are copied unchanged.
      * 
-     * @param c The character to encode.
-     * @return The encoded character.
+     * @param in The characters to encode.
+     * @param out Destination of in.size() characters, may be in.data().
      */
-    char encode(char c) override;
+    void encode_into(std::string_view in, char* out) override;
 
     /**
-     * @brief Decodes a single character using the Atbash cipher.
+     * @brief Decodes a buffer using the Atbash cipher.
      * 
-     * Since Atbash is a symmetric cipher, decoding is identical to encoding. 
-     * This method simply returns the result of encode_char for the given character.
+     * Since Atbash is a symmetric cipher, decoding is identical to encoding.
      * 
-     * @param c The character to decode.
-     * @return The decoded character.
+     * @param in The characters to decode.
+     * @param out Destination of in.size() characters, may be in.data().
      */
-    char decode(char c) override;
+    void decode_into(std::string_view in, char* out) override;
 };
 
 }       //  namespace palantir
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace palantir::kernels {
+
+/**
+ * @brief Instruction set a kernel runs with.
+ *
+ * Levels are ordered: each one implies the ones before it. Every kernel below reads in.size()
+ * characters and writes as many to out, which may be in.data(). Letters are the ASCII ranges
+ * A-Z and a-z, classified with byte-range compares rather than the locale-dependent
+ * std::isalpha; the letter ciphers copy every other byte unchanged. An isa above best_isa()
+ * is lowered to it, so tests can run every level the CPU has.
+ */
+enum class Isa {
+    Scalar,     ///< Portable byte-at-a-time loops.
+    SSE2,       ///< 16 bytes per iteration.
+    SSSE3,      ///< SSE2 plus byte shuffles, used to spread Vigenère key shifts.
+    AVX2        ///< 32 bytes per iteration.
+};
+
+/**
+ * @brief Returns the best Isa the running CPU supports, detected once.
+ */
+Isa best_isa() noexcept;
+
+/**
+ * @brief Number of bytes that padded key tables carry past the key period.
+ */
+inline constexpr std::size_t key_padding = 32;
+
+/**
+ * @brief Returns key followed by its first key_padding bytes, repeating key as needed.
+ *
+ * A vector load at any phase below key.size() then reads the key from that phase onwards,
+ * so a kernel walks a key of any length with one unaligned load per block.
+ * An empty key gives an empty table.
+ */
+std::string pad_key(std::string_view key);
+
+/**
+ * @brief Returns the Vigenère shift, in [0, 26), of each character of a lowercase alphabetic key.
+ *
+ * @param direction 1 for the encoding shifts, -1 for the decoding ones.
+ */
+std::string key_shifts(std::string_view key, int direction);
+
+/**
+ * @brief out[i] = in[i] ^ key[i % period], where padded_key = pad_key(key).
+ */
+void xor_key(std::string_view in, char* out, std::string_view padded_key, Isa isa = best_isa());
+
+/**
+ * @brief Rotates every letter by shift places within its case; shift is taken modulo 26.
+ */
+void rotate(std::string_view in, char* out, int shift, Isa isa = best_isa());
+
+/**
+ * @brief Mirrors every letter within its case (A <-> Z, b <-> y).
+ */
+void atbash(std::string_view in, char* out, Isa isa = best_isa());
+
+/**
+ * @brief Rotates each letter by the next key shift; other characters do not consume a shift.
+ *
+ * @param padded_shifts pad_key(key_shifts(key, direction)).
+ */
+void vigenere(std::string_view in, char* out, std::string_view padded_shifts, Isa isa = best_isa());
+
+}       //  namespace palantir::kernels
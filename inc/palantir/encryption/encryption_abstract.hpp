@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <cstddef>
 
 namespace palantir {
 
@@ -21,19 +23,54 @@ public:
 
     /**
      * @brief Encode a string using the implemented encryption algorithm.
+     *
+     * Allocates the result and fills it with encode_into.
      * 
      * @param buffer The string to encode.
      * @return The encoded string.
      */
-    virtual std::string encode(std::string const& buffer) = 0;
+    virtual std::string encode(std::string const& buffer);
 
     /**
      * @brief Decode a string using the implemented encryption algorithm.
+     *
+     * Allocates the result and fills it with decode_into.
      * 
      * @param buffer The string to decode.
      * @return The decoded string.
      */
-    virtual std::string decode(std::string const& buffer) = 0;
+    virtual std::string decode(std::string const& buffer);
+
+    /**
+     * @brief Encode in into out without allocating.
+     *
+     * Every algorithm maps each input character to one output character, so out must
+     * hold in.size() characters. out may point to in.data() to encode in place.
+     * 
+     * @param in The characters to encode.
+     * @param out Destination of in.size() encoded characters.
+     */
+    virtual void encode_into(std::string_view in, char* out) = 0;
+
+    /**
+     * @brief Decode in into out without allocating.
+     *
+     * out must hold in.size() characters and may point to in.data().
+     * 
+     * @param in The characters to decode.
+     * @param out Destination of in.size() decoded characters.
+     */
+    virtual void decode_into(std::string_view in, char* out) = 0;
+
+    /**
+     * @brief Encode the size characters at data in place.
+     */
+    void encode_inplace(char* data, std::size_t size);
+
+    /**
+     * @brief Decode the size characters at data in place.
+     */
+    void decode_inplace(char* data, std::size_t size);
 
 private:
     /**
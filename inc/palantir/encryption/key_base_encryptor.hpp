@@ -10,10 +10,10 @@ namespace palantir {
  * 
  * @brief Abstract base class for character-based encryption algorithms.
  *
- * This class extends EncryptionAbstract to provide a framework for
- * encoding and decoding strings on a character-by-character basis. It 
- * defines pure virtual functions for encoding and decoding individual 
- * characters, which must be implemented by derived classes.
+ * This class extends EncryptionAbstract with the key shared by character-based
+ * algorithms. Derived classes implement encode_into and decode_into as one loop
+ * over the buffer, so the virtual call happens once per buffer, not per character.
+ * Every call starts again from the first character of the key.
  */
 class KeyBaseEncryptor : public EncryptionAbstract {
 public:
@@ -30,62 +30,14 @@ public:
      */
     virtual ~KeyBaseEncryptor() = default;
 
-    /**
-     * Encode a string using the implemented character-based encryption algorithm.
-     * 
-     * Iterates over each character in the string, applies the encode method to each character,
-     * and constructs the encoded string.
-     * 
-     * @param buffer The string to encode.
-     * @return The encoded string.
-     */
-    std::string encode(const std::string& buffer) override;
-
-    /**
-     * Decode a string using the implemented character-based encryption algorithm.
-     * 
-     * Iterates over each character in the string, applies the decode method to each character,
-     * and constructs the decoded string.
-     * 
-     * @param buffer The string to decode.
-     * @return The decoded string.
-     */
-    std::string decode(const std::string& buffer) override;
-
 protected:
     /**
-     * Encode a single character using the derived class's encryption algorithm.
-     * 
-     * Must be implemented by derived classes to define how individual characters
-     * are encoded.
-     * 
-     * @param c The character to encode.
-     * @return The encoded character.
-     */
-    virtual char encode(char c) = 0;
-    
-    /**
-     * Decode a single character using the derived class's decryption algorithm.
-     * 
-     * Must be implemented by derived classes to define how individual characters
-     * are decoded.
-     * 
-     * @param c The character to decode.
-     * @return The decoded character.
-     */
-    virtual char decode(char c) = 0;
-
-    /**
-     * Retrieves the current character from the encryption key and increments the index.
-     * If the end of the key is reached, the index wraps around to the beginning.
-     *
-     * @return The current key character.
+     * Returns the encryption key, empty if none was given.
      */
-    char get_key_char_and_inc_index();
+    std::string const& key() const noexcept;
 
 private:
     std::string key_;
-    size_t key_index_ = 0;
 };
 
 }
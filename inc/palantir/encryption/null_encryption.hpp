@@ -13,7 +13,7 @@ namespace palantir {
  *
  * This class provides a null implementation of the CharEncryptor, meaning that
  * it performs no actual encryption or decryption. The encode and decode functions
- * simply return the input character unchanged. This can be useful in contexts where 
+ * simply return the input unchanged. This can be useful in contexts where 
  * optional encryption is needed, and sometimes no encryption should be applied.
  */
 class NullEncryption : public KeyBaseEncryptor {
@@ -22,23 +22,21 @@ public:
     
     virtual ~NullEncryption() override = default;
 
-private:
     /**
-     * @brief Encodes a character by returning it unchanged.
+     * @brief Copies in to out unchanged.
      *
-     * @param c The character to encode.
-     * @return The unchanged character.
+     * @param in The characters to encode.
+     * @param out Destination of in.size() characters, may be in.data().
      */
-    char encode(char c) override;
+    void encode_into(std::string_view in, char* out) override;
 
     /**
-     * @brief Decodes a character by returning it unchanged.
+     * @brief Copies in to out unchanged.
      *
-     * @param c The character to decode.
-     * @return The unchanged character.
+     * @param in The characters to decode.
+     * @param out Destination of in.size() characters, may be in.data().
      */
-    char decode(char c) override;
-
+    void decode_into(std::string_view in, char* out) override;
 };
 
 }       //  namespace palantir
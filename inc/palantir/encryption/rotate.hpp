@@ -13,7 +13,8 @@ namespace palantir {
  *
  * This class provides methods to encode and decode strings using a rotation-based cipher,
  * where each character in the string is shifted by a set number of places down the alphabet.
- * The class maintains case sensitivity and wraps within the alphabet (A-Z, a-z).
+ * The class maintains case sensitivity and wraps within the alphabet (A-Z, a-z). The
+ * rotation runs through kernels::rotate, 16 or 32 characters at a time where the CPU allows.
  */
 class RotateCharEncryptor : public EncryptionAbstract {
 public:
@@ -22,34 +23,21 @@ public:
     virtual ~RotateCharEncryptor() = default;
 
     /**
-     * @brief Encodes a plaintext string into a ciphertext using character rotation.
+     * @brief Encodes a buffer into ciphertext using character rotation.
      *
-     * @param buffer The plaintext string to encode.
-     * @return The encoded ciphertext string.
+     * @param in The plaintext characters to encode.
+     * @param out Destination of in.size() characters, may be in.data().
      */
-    std::string encode(std::string const& buffer) override;
+    void encode_into(std::string_view in, char* out) override;
 
     /**
-     * @brief Decodes a ciphertext string back into plaintext using the inverse of the
+     * @brief Decodes a buffer back into plaintext using the inverse of the
      *        character rotation used in encoding.
      *
-     * @param buffer The ciphertext string to decode.
-     * @return The decoded plaintext string.
+     * @param in The ciphertext characters to decode.
+     * @param out Destination of in.size() characters, may be in.data().
      */
-    std::string decode(std::string const& buffer) override;
-
-private:
-    /**
-     * @brief Shifts a single character by the specified shift value.
-     *
-     * This method wraps the character shift operation, taking care of alphabet wrapping
-     * and maintaining case sensitivity.
-     *
-     * @param c The character to shift.
-     * @param shift The amount to shift the character.
-     * @return The shifted character.
-     */
-    char shift_element(const char c, int shift);
+    void decode_into(std::string_view in, char* out) override;
 
 private:
     int shift_;
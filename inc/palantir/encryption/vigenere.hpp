@@ -33,22 +33,31 @@ public:
     
     ~Vigenere() override = default;
 
-private:
     /**
-     * @brief Encodes a character using the Vigenère cipher.
+     * @brief Encodes a buffer using the Vigenère cipher.
+     *
+     * Each letter is shifted by the next key letter; non-alphabetic characters are copied
+     * unchanged and do not consume a key letter.
      *
-     * @param c The character to encode.
-     * @return The encoded character.
+     * @param in The characters to encode.
+     * @param out Destination of in.size() characters, may be in.data().
      */
-    char encode(char c) override;
+    void encode_into(std::string_view in, char* out) override;
 
     /**
-     * @brief Decodes a character that was encoded using the Vigenère cipher.
+     * @brief Decodes a buffer that was encoded using the Vigenère cipher.
      *
-     * @param c The character to decode.
-     * @return The decoded character.
+     * @param in The characters to decode.
+     * @param out Destination of in.size() characters, may be in.data().
+     */
+    void decode_into(std::string_view in, char* out) override;
+
+private:
+    /**
+     * @brief Padded kernels::key_shifts of the key, for encoding and for decoding.
      */
-    char decode(char c) override;
+    std::string encode_shifts_;
+    std::string decode_shifts_;
 };
 
 }       //  namespace palantir
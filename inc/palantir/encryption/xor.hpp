@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include "palantir/encryption/key_base_encryptor.hpp"
 
 namespace palantir {
@@ -33,9 +35,21 @@ public:
 
     virtual ~XorEncryptor() override = default;
 
+    /**
+     * @brief XORs each character of in with the key, repeated from its first character.
+     */
+    void encode_into(std::string_view in, char* out) override;
+
+    /**
+     * @brief XOR is its own inverse, so decoding is identical to encoding.
+     */
+    void decode_into(std::string_view in, char* out) override;
+
 private:
-    char encode(char c) override;
-    char decode(char c) override;
+    /**
+     * @brief The key padded by kernels::pad_key, so it can be read a vector at a time.
+     */
+    std::string padded_key_;
 };
 
 }  // namespace palantir
@@ -47,7 +47,8 @@ public:
      *
      * This method retrieves messages from the specified source, applies each encryption in the 
      * sequence defined at construction, and forwards the resulting message to the designated 
-     * destination.
+     * destination. The encryptions run in place on the received message, so the chain
+     * allocates nothing beyond what the source returns.
      *
      * @param src Reference to an implementation of MessageSourceAbstract from which messages are read.
      * @param des Reference to an implementation of MessageDestinationAbstract to which messages are sent.
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bf/analyzer.hpp"
+#include "bf/program.hpp"
+
+namespace bf {
+
+namespace {
+
+constexpr int32_t cell_modulo = 256;
+constexpr int32_t unknown_value = -1;
+constexpr size_t max_known_cells = 256;
+
+int32_t normalize_cell_delta(int32_t delta)
+{
+    return ((delta % cell_modulo) + cell_modulo) % cell_modulo;
+}
+
+std::vector<bool> mark_top_level(Code const& code)
+{
+    std::vector<bool> top_level(code.size());
+    int depth = 0;
+    for (size_t i = 0; i < code.size(); ++i) {
+        top_level[i] = depth == 0;      // a loop's own LoopEnd is inside it
+        if (code[i].op == OpCode::LoopStart) {
+            ++depth;
+        } else if (code[i].op == OpCode::LoopEnd) {
+            --depth;
+        }
+    }
+    return top_level;
+}
+
+/**
+ * Cell values known at compile time, keyed by offset from the data pointer.
+ * Cells missing from the map are zero while the tape is still fresh, unknown afterwards.
+ */
+class KnownCells {
+public:
+    int32_t at(int32_t offset) const
+    {
+        auto it = cells_.find(offset);
+        if (it != cells_.end()) {
+            return it->second;
+        }
+        return fresh_ ? 0 : unknown_value;
+    }
+
+    void set(int32_t offset, int32_t value)
+    {
+        cells_[offset] = value;
+        if (cells_.size() > max_known_cells) {
+            forget();
+        }
+    }
+
+    void add(int32_t offset, int32_t delta)
+    {
+        int32_t value = at(offset);
+        if (value != unknown_value) {
+            set(offset, normalize_cell_delta(value + delta));
+        }
+    }
+
+    void move(int32_t distance)
+    {
+        std::map<int32_t, int32_t> moved;
+        for (auto const& [offset, value] : cells_) {
+            moved.emplace(offset - distance, value);
+        }
+        cells_.swap(moved);
+    }
+
+    void forget()
+    {
+        cells_.clear();
+        fresh_ = false;
+    }
+
+private:
+    std::map<int32_t, int32_t> cells_;
+    bool fresh_ = true;
+};
+
+} // namespace
+
+Code Analyzer::evaluate_constant_prefix(Code const& input)
+{
+    Code code = input;
+    if (!Program::link_loops(code)) {
+        return input;
+    }
+    std::vector<bool> top_level = mark_top_level(code);
+
+    struct State {
+        size_t ip = 0;
+        std::vector<uint8_t> tape = std::vector<uint8_t>(evaluation_window, 0);
+        int64_t position = 0;
+        size_t output_size = 0;
+    };
+    State state;
+    State loop_entry;
+    std::string output;
+    auto in_window = [](int64_t cell) { return cell >= 0 && cell < evaluation_window; };
+
+    size_t steps = 0;
+    bool stopped = false;
+    while (!stopped && state.ip < code.size()) {
+        Instruction const& in = code[state.ip];
+        uint8_t& current = state.tape[static_cast<size_t>(state.position)];
+        int64_t target = state.position + in.offset;
+
+        if (top_level[state.ip] && in.op == OpCode::LoopStart) {
+            loop_entry = state;
+            loop_entry.output_size = output.size();
+        }
+        if (++steps > evaluation_step_limit) {
+            break;
+        }
+
+        switch (in.op) {
+            case OpCode::Increment: ++current; break;
+            case OpCode::Decrement: --current; break;
+            case OpCode::MoveRight:
+            case OpCode::MoveLeft:
+            case OpCode::Move: {
+                int64_t distance = in.op == OpCode::Move ? in.arg : (in.op == OpCode::MoveRight ? 1 : -1);
+                stopped = !in_window(state.position + distance);
+                if (!stopped) {
+                    state.position += distance;
+                }
+                break;
+            }
+            case OpCode::Add:
+            case OpCode::SetZero:
+            case OpCode::MultiplyAdd:
+                stopped = !in_window(target);
+                if (!stopped) {
+                    uint8_t& cell = state.tape[static_cast<size_t>(target)];
+                    if (in.op == OpCode::Add) {
+                        cell = static_cast<uint8_t>(cell + in.arg);
+                    } else if (in.op == OpCode::SetZero) {
+                        cell = 0;
+                    } else {
+                        cell = static_cast<uint8_t>(cell + current * in.arg);
+                    }
+                }
+                break;
+            case OpCode::ScanLeft:
+            case OpCode::ScanRight: {
+                int64_t step = in.op == OpCode::ScanRight ? in.arg : -in.arg;
+                int64_t cell = state.position;
+                while (!stopped && state.tape[static_cast<size_t>(cell)] != 0) {
+                    cell += step;
+                    stopped = !in_window(cell);
+                }
+                if (!stopped) {
+                    state.position = cell;
+                }
+                break;
+            }
+            case OpCode::Output:
+                output.append(static_cast<size_t>(std::max(in.arg, 1)), static_cast<char>(current));
+                break;
+            case OpCode::LoopStart:
+                if (current == 0) {
+                    state.ip = static_cast<size_t>(in.arg);
+                }
+                break;
+            case OpCode::LoopEnd:
+                if (current != 0) {
+                    state.ip = static_cast<size_t>(in.arg);
+                }
+                break;
+            default:    // Input depends on the run, HALT ends the program
+                stopped = true;
+                break;
+        }
+        if (!stopped) {
+            ++state.ip;
+        }
+    }
+
+    if (state.ip < code.size() && !top_level[state.ip]) {
+        state = loop_entry;     // resume at the start of the outermost loop being run
+        output.resize(state.output_size);
+    }
+    if (state.ip == 0) {
+        return input;
+    }
+
+    Code result;
+    int32_t origin = 0;     // value of cell 0 in the emitted code
+    for (size_t i = 0; i < output.size(); ) {
+        size_t run = 1;
+        while (i + run < output.size() && output[i + run] == output[i]) {
+            ++run;
+        }
+        int32_t byte = static_cast<uint8_t>(output[i]);
+        if (byte != origin) {
+            result.push_back(Instruction{OpCode::Add, normalize_cell_delta(byte - origin)});
+            origin = byte;
+        }
+        result.push_back(Instruction{OpCode::Output, run > 1 ? static_cast<int32_t>(run) : 0});
+        i += run;
+    }
+    for (int64_t cell = 0; cell < evaluation_window; ++cell) {
+        int32_t have = cell == 0 ? origin : 0;
+        int32_t want = state.tape[static_cast<size_t>(cell)];
+        if (want != have) {
+            result.push_back(Instruction{OpCode::Add, normalize_cell_delta(want - have), static_cast<int32_t>(cell)});
+        }
+    }
+    if (state.position != 0) {
+        result.push_back(Instruction{OpCode::Move, static_cast<int32_t>(state.position)});
+    }
+    result.insert(result.end(), input.begin() + static_cast<std::ptrdiff_t>(state.ip), input.end());
+    return result;
+}
+
+Code Analyzer::propagate_known_cells(Code const& input)
+{
+    Code code = input;
+    if (!Program::link_loops(code)) {
+        return input;
+    }
+
+    Code result;
+    result.reserve(code.size());
+    KnownCells known;
+    for (size_t ip = 0; ip < code.size(); ++ip) {
+        Instruction in = input[ip];
+        switch (in.op) {
+            case OpCode::Add:
+                known.add(in.offset, in.arg);
+                break;
+            case OpCode::Move:
+                known.move(in.arg);
+                break;
+            case OpCode::SetZero:
+                if (known.at(in.offset) == 0) {
+                    continue;
+                }
+                known.set(in.offset, 0);
+                break;
+            case OpCode::MultiplyAdd: {
+                int32_t factor = known.at(0);
+                if (factor == 0) {
+                    continue;
+                }
+                if (factor != unknown_value) {
+                    in = Instruction{OpCode::Add, normalize_cell_delta(factor * in.arg), in.offset};
+                    known.add(in.offset, in.arg);
+                } else {
+                    known.set(in.offset, unknown_value);
+                }
+                break;
+            }
+            case OpCode::Output:
+            case OpCode::HALT:
+                break;
+            case OpCode::Input:
+                known.set(0, unknown_value);
+                break;
+            case OpCode::LoopStart:
+                if (known.at(0) == 0) {
+                    ip = static_cast<size_t>(code[ip].arg);   // never entered - drop the whole loop
+                    continue;
+                }
+                known.forget();
+                break;
+            case OpCode::LoopEnd:
+            case OpCode::ScanLeft:
+            case OpCode::ScanRight:
+                known.forget();
+                known.set(0, 0);
+                break;
+            default:
+                known.forget();
+                break;
+        }
+        result.push_back(in);
+    }
+    return result;
+}
+
+} // namespace bf
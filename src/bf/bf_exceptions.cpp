@@ -0,0 +1,20 @@
+#include "bf/bf_exceptions.hpp"
+
+namespace bf {
+
+JitException::JitException(const std::string& reason)
+    : std::runtime_error("JIT: " + reason)
+{
+}
+
+TapeException::TapeException(const std::string& reason)
+    : std::runtime_error("Tape: " + reason)
+{
+}
+
+SourceException::SourceException(const std::string& reason)
+    : std::runtime_error("Source: " + reason)
+{
+}
+
+} // namespace bf
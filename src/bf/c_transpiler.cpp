@@ -0,0 +1,142 @@
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "bf/c_transpiler.hpp"
+#include "bf/bf_exceptions.hpp"
+
+namespace bf {
+
+namespace {
+
+// maps a signed distance onto [0, tape size) so a single subtraction wraps it
+long normalize(long distance, long tape_size)
+{
+    return ((distance % tape_size) + tape_size) % tape_size;
+}
+
+// index expression for the cell 'distance' cells away from p
+std::string shifted(long distance, long tape_size, bool wrap)
+{
+    if (wrap) {
+        return "WRAP(p + " + std::to_string(normalize(distance, tape_size)) + "u)";
+    }
+    return "p + (size_t)(" + std::to_string(distance) + "L)";
+}
+
+std::string cell_at(int32_t offset, long tape_size, bool wrap)
+{
+    if (offset == 0) {
+        return "t[p]";
+    }
+    return "t[" + shifted(offset, tape_size, wrap) + "]";
+}
+
+} // namespace
+
+std::string CTranspiler::emit(Code const& code, size_t tape_size, Boundary boundary)
+{
+    const long size = static_cast<long>(tape_size);
+    const bool wrap = boundary == Boundary::Wrap;
+    std::ostringstream out;
+    out << "#include <stddef.h>\n"
+        << "typedef unsigned char cell;\n"
+        << "struct bf_io { void* context; void (*output)(void*, cell); cell (*input)(void*); void (*output_repeat)(void*, cell, size_t); };\n"
+        << "#define SIZE " << tape_size << "u\n"
+        << (wrap ? "#define WRAP(i) ((i) >= SIZE ? (i) - SIZE : (i))\n" : "#define WRAP(i) (i)\n")
+        << "size_t " << entry_symbol << "(cell* t, size_t size, size_t p, struct bf_io* io)\n"
+        << "{\n"
+        << "(void)size;\n";
+
+    for (Instruction const& in : code) {
+        if (in.op == OpCode::HALT) {
+            break;
+        }
+        switch (in.op) {
+            case OpCode::MoveRight: out << "p = " << shifted(1, size, wrap) << ";\n"; break;
+            case OpCode::MoveLeft: out << "p = " << shifted(-1, size, wrap) << ";\n"; break;
+            case OpCode::Increment: out << "++t[p];\n"; break;
+            case OpCode::Decrement: out << "--t[p];\n"; break;
+            case OpCode::Output:
+                if (in.arg > 1) {
+                    out << "io->output_repeat(io->context, t[p], " << in.arg << "u);\n";
+                } else {
+                    out << "io->output(io->context, t[p]);\n";
+                }
+                break;
+            case OpCode::Input: out << "t[p] = io->input(io->context);\n"; break;
+            case OpCode::LoopStart: out << "while (t[p]) {\n"; break;
+            case OpCode::LoopEnd: out << "}\n"; break;
+            case OpCode::Add:
+                out << cell_at(in.offset, size, wrap) << " += " << in.arg << ";\n";
+                break;
+            case OpCode::Move:
+                out << "p = " << shifted(in.arg, size, wrap) << ";\n";
+                break;
+            case OpCode::SetZero:
+                out << cell_at(in.offset, size, wrap) << " = 0;\n";
+                break;
+            case OpCode::MultiplyAdd:
+                out << cell_at(in.offset, size, wrap) << " += (cell)(t[p] * " << in.arg << ");\n";
+                break;
+            case OpCode::ScanLeft:
+                out << "while (t[p]) p = " << shifted(-static_cast<long>(in.arg), size, wrap) << ";\n";
+                break;
+            case OpCode::ScanRight:
+                out << "while (t[p]) p = " << shifted(in.arg, size, wrap) << ";\n";
+                break;
+            default:
+                throw JitException("unsupported instruction");
+        }
+    }
+
+    out << "return p;\n"
+        << "}\n";
+    return out.str();
+}
+
+std::unique_ptr<SharedLibrary> CTranspiler::build(std::string const& source, std::string const& compiler)
+{
+    char dir_template[] = "/tmp/bf_jit_XXXXXX";
+    const char* dir = mkdtemp(dir_template);
+    if (dir == nullptr) {
+        throw JitException("cannot create a temporary directory");
+    }
+    const std::string source_path = std::string(dir) + "/program.c";
+    const std::string library_path = std::string(dir) + "/program.so";
+
+    auto clean_up = [&]() {
+        std::remove(source_path.c_str());
+        std::remove(library_path.c_str());
+        rmdir(dir);
+    };
+
+    {
+        std::ofstream file(source_path);
+        file << source;
+        if (!file) {
+            clean_up();
+            throw JitException("cannot write " + source_path);
+        }
+    }
+
+    const std::string command = compiler + " -O2 -shared -fPIC -w -o " + library_path + " " + source_path;
+    if (std::system(command.c_str()) != 0) {
+        clean_up();
+        throw JitException("'" + command + "' failed");
+    }
+
+    std::unique_ptr<SharedLibrary> library;
+    try {
+        library = std::make_unique<SharedLibrary>(library_path);
+    } catch (...) {
+        clean_up();
+        throw;
+    }
+    clean_up();  // the mapping stays valid after the files are unlinked
+    return library;
+}
+
+} // namespace bf
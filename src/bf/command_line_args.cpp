@@ -1,33 +1,74 @@
 #include <string.h>
 
 #include "bf/command_line_args.hpp"
+#include "bf/source_file.hpp"
+#include "bf/bf_exceptions.hpp"
 
 namespace bf {
 
+namespace {
+
+void print_usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--threaded | --jit | --jit-c] [--grow] [--buffered] <filename.bf> or "
+              << program << " [--threaded | --jit | --jit-c] [--grow] [--buffered] -r <code>\n";
+}
+
+} // namespace
+
 bool CommandLineArgs::get_code_for_compilation(int argc, char* argv[], std::string& code) 
 {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <filename.bf> or " << argv[0] << " -r <code>\n";
+    RunOptions options{};
+    if (!get_code_for_compilation(argc, argv, code, options)) {
         return false;
     }
-    if (strcmp(argv[1], "-r") == 0) {
-        if (argc < 3) {
-            std::cerr << "Usage: " << argv[0] << " -r <code>\n";
+    if (!options.source_path.empty()) {
+        try {
+            SourceFile file{options.source_path};
+            code.assign(file.view());
+        } catch (SourceException const&) {
+            std::cerr << "Error opening file: " << options.source_path << '\n';
             return false;
         }
-        code = argv[2];
-    } else {
-        std::ifstream input_file(argv[1]);
-        if (!input_file.is_open()) {
-            std::cerr << "Error opening file: " << argv[1] << '\n';
+    }
+    return true;
+}
+
+bool CommandLineArgs::get_code_for_compilation(int argc, char* argv[], std::string& code, RunOptions& options)
+{
+    int arg = 1;
+    for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; ++arg) {
+        if (strcmp(argv[arg], "--threaded") == 0) {
+            options.backend = Backend::Threaded;
+        } else if (strcmp(argv[arg], "--jit") == 0) {
+            options.backend = Backend::Jit;
+        } else if (strcmp(argv[arg], "--jit-c") == 0) {
+            options.backend = Backend::JitC;
+        } else if (strcmp(argv[arg], "--grow") == 0) {
+            options.boundary = Boundary::Grow;
+        } else if (strcmp(argv[arg], "--buffered") == 0) {
+            options.console = ConsoleMode::Buffered;
+        } else {
+            std::cerr << "Unknown option: " << argv[arg] << '\n';
+            print_usage(argv[0]);
             return false;
         }
-        std::stringstream buffer;
-        buffer << input_file.rdbuf();
-        code = buffer.str();  // File content
+    }
+
+    if (arg >= argc) {
+        print_usage(argv[0]);
+        return false;
+    }
+    if (strcmp(argv[arg], "-r") == 0) {
+        if (arg + 1 >= argc) {
+            std::cerr << "Usage: " << argv[0] << " -r <code>\n";
+            return false;
+        }
+        code = argv[arg + 1];
+    } else {
+        options.source_path = argv[arg];   // mapped and compiled in place by the caller
     }
     return true;
 }    
 
 }       // namespace bf
-
@@ -1,94 +1,137 @@
-#include <stack>
+#include <array>
 #include <iostream>
+#include <utility>
 
 #include "bf/compiler.hpp"
+#include "bf/analyzer.hpp"
 
 namespace bf {
 
-Program Compiler::compile(const std::string& source)
+namespace {
+
+constexpr std::array<OpCode, 256> make_opcode_table()
 {
-    std::vector<OpCode> instructions  = Compiler::parse(source);
-    std::unordered_map<size_t, size_t> jump_table;
-    Compiler::build_jump_table(instructions , jump_table);
-    return Program(instructions , jump_table);
+    std::array<OpCode, 256> table{};
+    for (OpCode& op : table) {
+        op = OpCode::HALT;
+    }
+    table[static_cast<unsigned char>('>')] = OpCode::MoveRight;
+    table[static_cast<unsigned char>('<')] = OpCode::MoveLeft;
+    table[static_cast<unsigned char>('+')] = OpCode::Increment;
+    table[static_cast<unsigned char>('-')] = OpCode::Decrement;
+    table[static_cast<unsigned char>('.')] = OpCode::Output;
+    table[static_cast<unsigned char>(',')] = OpCode::Input;
+    table[static_cast<unsigned char>('[')] = OpCode::LoopStart;
+    table[static_cast<unsigned char>(']')] = OpCode::LoopEnd;
+    return table;
 }
 
-void Compiler::build_jump_table(const std::vector<OpCode> instructions, std::unordered_map<size_t, size_t>& jump_table) 
+// Same mapping as op_code_map, but one indexed load per source byte instead of a hash lookup.
+constexpr std::array<OpCode, 256> opcode_table = make_opcode_table();
+
+} // namespace
+
+Program Compiler::compile(std::string_view source)
 {
-    std::stack<size_t> loopStack;
-    for (size_t i = 0; i < instructions.size(); ++i) {
-        if (instructions[i] == OpCode::LoopStart) {
-            loopStack.push(i);
-        } else if (instructions[i] == OpCode::LoopEnd) {
-            if (!loopStack.empty()) {
-                size_t start = loopStack.top();
-                loopStack.pop();
-                jump_table[start] = i;
-                jump_table[i] = start;
-            }
-        }
+    Code code;
+    if (!translate_and_link(source, code)) {
+        std::cerr << "Error: Unmatched brackets or invalid operations" << '\n';
+
+        return Program(Code{});
     }
+    return Program(std::move(code));
 }
 
-std::vector<OpCode> Compiler::parse(const std::string& source) 
+Program Compiler::compile_optimized(std::string_view source)
 {
-    std::string filtered = filter(source);
-    std::vector<OpCode> operations;
-    if (!validate(filtered)) {
+    Code code;
+    if (!translate_and_link(source, code)) {
+        std::cerr << "Error: Unmatched brackets or invalid operations" << '\n';
+
+        return Program(Code{});
+    }
+    Optimizer optimizer{};
+    return Program(optimizer.optimize(std::move(code)));
+}
+
+Program Compiler::compile_analyzed(std::string_view source)
+{
+    Code code;
+    if (!translate_and_link(source, code)) {
+        std::cerr << "Error: Unmatched brackets or invalid operations" << '\n';
+
+        return Program(Code{});
+    }
+    Optimizer optimizer{};
+    optimizer.add_pass(&Analyzer::evaluate_constant_prefix);
+    optimizer.add_pass(&Optimizer::fold_offsets);   // the evaluated prefix ends in a Move
+    optimizer.add_pass(&Analyzer::propagate_known_cells);
+    return Program(optimizer.optimize(std::move(code)));
+}
+
+std::vector<OpCode> Compiler::parse(std::string_view source) 
+{
+    Code code;
+    if (!translate_and_link(source, code)) {
         std::cerr << "Error: Unmatched brackets or invalid operations" << '\n';
 
         return {};
     }
-    for (char c : filtered) {
-        OpCode opcode = translate(c);
-        if (opcode != OpCode::HALT) {
-            operations.push_back(opcode);
-        }
+    std::vector<OpCode> operations;
+    operations.reserve(code.size());
+    for (Instruction const& in : code) {
+        operations.push_back(in.op);
     }
-    operations.push_back(OpCode::HALT);
     return operations;
 }
 
-std::string Compiler::filter(const std::string& source) 
+bool Compiler::validate(std::string_view source) const
 {
-    std::string filtered;
+    size_t depth = 0;
     for (char c : source) {
-        std::unordered_map<char, OpCode>::const_iterator it = op_code_map.find(c);
-        if (it != op_code_map.end()) {
-            filtered.push_back(c);
+        OpCode op = opcode_table[static_cast<unsigned char>(c)];
+        if (op == OpCode::LoopStart) {
+            ++depth;
+        } else if (op == OpCode::LoopEnd) {
+            if (depth == 0) {
+                return false;
+            }
+            --depth;
         }
     }
-    return filtered;
+    return depth == 0;
 }
 
-bool Compiler::validate(const std::string& source) 
+bool Compiler::translate_and_link(std::string_view source, Code& code)
 {
-    std::stack<size_t> bracket_stack;
-    size_t index = 0;
+    std::vector<size_t> bracket_stack;
+    code.clear();
+    code.reserve(source.size() + 1);
     for (char c : source) {
-        OpCode op = translate(c);
+        OpCode op = opcode_table[static_cast<unsigned char>(c)];
         switch (op) {
+            case OpCode::HALT:
+                continue;
             case OpCode::LoopStart:
-                bracket_stack.push(index);
+                bracket_stack.push_back(code.size());
                 break;
-            case OpCode::LoopEnd:
+            case OpCode::LoopEnd: {
                 if (bracket_stack.empty()) {
                     return false;
                 }
-                bracket_stack.pop();
-                break;
+                size_t start = bracket_stack.back();
+                bracket_stack.pop_back();
+                code[start].arg = static_cast<int32_t>(code.size());
+                code.push_back(Instruction{op, static_cast<int32_t>(start)});
+                continue;
+            }
             default:
                 break;
         }
-        index++;
+        code.push_back(Instruction{op});
     }
+    code.push_back(Instruction{OpCode::HALT});
     return bracket_stack.empty();
 }
 
-OpCode Compiler::translate(char c) 
-{
-    std::unordered_map<char, OpCode>::const_iterator it = op_code_map.find(c);
-    return it != op_code_map.end() ? it->second : OpCode::HALT;
 }
-
-}
\ No newline at end of file
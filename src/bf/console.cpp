@@ -1,15 +1,41 @@
+#include <algorithm>
+
 #include "bf/console.hpp"
 
 namespace bf {
 
-Console::Console(std::ostream& os, std::istream& is)
+Console::Console(std::ostream& os, std::istream& is, ConsoleMode mode)
 : os_(os)
 , is_(is) 
+, mode_(mode)
+, output_()
+, input_()
+, input_next_(0)
+{
+    if (mode_ == ConsoleMode::Buffered) {
+        output_.reserve(output_threshold);
+        input_.reserve(input_block);
+    }
+}
+
+Console::~Console()
 {
+    if (mode_ == ConsoleMode::Buffered) {
+        flush();
+    }
 }
 
 CellType Console::input_char() 
 {
+    if (mode_ == ConsoleMode::Buffered) {
+        if (input_next_ == input_.size()) {
+            flush();    // make prompts visible before refill can block on input
+            if (!refill()) {
+                return 0;
+            }
+        }
+        return static_cast<CellType>(input_[input_next_++]);
+    }
     char c;
     is_.get(c);
     return c;
@@ -17,7 +43,60 @@ CellType Console::input_char()
 
 void Console::print_char(CellType c) 
 {
+    if (mode_ == ConsoleMode::Buffered) {
+        output_.push_back(static_cast<char>(c));
+        if (output_.size() >= output_threshold) {
+            flush();
+        }
+        return;
+    }
     os_ << c;
 }
 
-}
\ No newline at end of file
+void Console::print_chars(CellType c, size_t count)
+{
+    if (mode_ == ConsoleMode::Buffered) {
+        output_.insert(output_.end(), count, static_cast<char>(c));
+        if (output_.size() >= output_threshold) {
+            flush();
+        }
+        return;
+    }
+    char chunk[256];
+    std::fill(std::begin(chunk), std::end(chunk), static_cast<char>(c));
+    while (count > 0) {
+        size_t n = std::min(count, sizeof(chunk));
+        os_.write(chunk, static_cast<std::streamsize>(n));
+        count -= n;
+    }
+}
+
+void Console::flush()
+{
+    if (!output_.empty()) {
+        os_.write(output_.data(), static_cast<std::streamsize>(output_.size()));
+        output_.clear();
+    }
+    os_.flush();
+}
+
+bool Console::refill()
+{
+    input_.resize(input_block);
+    input_next_ = 0;
+
+    // sgetc blocks only until some input is ready, and a buffered stream (a filebuf, or std::cin
+    // once unsynced from stdio) reads all of it into its buffer; take everything it holds
+    std::streambuf* buffer = is_.rdbuf();
+    std::streamsize read = 0;
+    if (buffer->sgetc() != std::char_traits<char>::eof()) {
+        std::streamsize available = std::max<std::streamsize>(buffer->in_avail(), 1);
+        read = buffer->sgetn(input_.data(), std::min<std::streamsize>(available, input_block));
+    } else {
+        is_.setstate(std::ios::eofbit);
+    }
+    input_.resize(static_cast<size_t>(read));
+    return read > 0;
+}
+
+} // namespace bf
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <sstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+#include "bf/engine.hpp"
+#include "bf/compiler.hpp"
+#include "bf/console.hpp"
+#include "bf/threaded_vm.hpp"
+
+namespace bf {
+
+Engine::CacheEntry::CacheEntry(std::string const& source, std::shared_ptr<const Program> program, uint64_t stamp)
+: source{source}
+, program{std::move(program)}
+, last_used{stamp}
+{
+}
+
+Engine::Engine(size_t workers, size_t cache_capacity)
+: programs_{}
+, programs_mutex_{}
+, cache_capacity_{std::max<size_t>(1, cache_capacity)}
+, clock_{0}
+, tapes_{std::max<size_t>(1, workers), std::max<size_t>(1, workers)}
+, workers_{std::max<size_t>(1, workers)}
+{
+}
+
+Engine::~Engine()
+{
+    workers_.shutdown_graceful();
+}
+
+std::future<RunReport> Engine::submit(std::string const& source, std::string input, size_t step_limit)
+{
+    // std::function must be copyable, so the promise is shared with the task
+    auto report = std::make_shared<std::promise<RunReport>>();
+    std::future<RunReport> future = report->get_future();
+    workers_.submit([this, report, source, input = std::move(input), step_limit]() {
+        try {
+            report->set_value(execute(source, input, step_limit));
+        } catch (...) {
+            report->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+RunReport Engine::run(std::string const& source, std::string input, size_t step_limit)
+{
+    return submit(source, std::move(input), step_limit).get();
+}
+
+size_t Engine::cached_programs() const
+{
+    std::shared_lock<std::shared_mutex> lock(programs_mutex_);
+    return programs_.size();
+}
+
+std::shared_ptr<const Program> Engine::program_for(std::string const& source)
+{
+    const size_t key = std::hash<std::string_view>{}(source);
+    {
+        std::shared_lock<std::shared_mutex> lock(programs_mutex_);
+        auto it = programs_.find(key);
+        if (it != programs_.end() && it->second.source == source) {
+            it->second.last_used.store(clock_.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+            return it->second.program;
+        }
+    }
+
+    // compile outside the lock; two workers racing on a new source both compile, one result is kept
+    Compiler compiler{};
+    std::shared_ptr<const Program> program;
+    if (compiler.validate(source)) {
+        program = std::make_shared<const Program>(compiler.compile_analyzed(source));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(programs_mutex_);
+    auto found = programs_.find(key);
+    if (found != programs_.end()) {
+        // another worker cached it meanwhile; on a hash collision the first source keeps the slot
+        return found->second.source == source ? found->second.program : program;
+    }
+    if (programs_.size() >= cache_capacity_) {
+        auto oldest = std::min_element(programs_.begin(), programs_.end(), [](auto const& a, auto const& b) {
+            return a.second.last_used.load(std::memory_order_relaxed) < b.second.last_used.load(std::memory_order_relaxed);
+        });
+        programs_.erase(oldest);    // runs still holding its program keep it alive
+    }
+    programs_.try_emplace(key, source, program, clock_.fetch_add(1, std::memory_order_relaxed));
+    return program;
+}
+
+RunReport Engine::execute(std::string const& source, std::string const& input, size_t step_limit)
+{
+    std::shared_ptr<const Program> compiled = program_for(source);
+    if (!compiled) {
+        return RunReport{RunStatus::InvalidSource, {}};
+    }
+
+    auto tape = tapes_.get();
+    std::unique_ptr<Memory> spare;
+    Memory* memory = tape.get();
+    if (!memory) {
+        spare = std::make_unique<Memory>(tape_size);   // pool exhausted - run on a private tape
+        memory = spare.get();
+    }
+
+    // Clears the tape before it returns to the pool: the whole tape unless the run completes
+    // and reports the cells it touched, so a run that throws cannot leave stale cells behind
+    struct TapeReset {
+        Memory* memory;
+        Index begin;
+        Index end;
+        ~TapeReset() { memory->reset(begin, end); }
+    } cleanup{memory, 0, memory->size()};
+
+    Program program{*compiled};     // shares the instructions, own instruction pointer
+    std::ostringstream os;
+    std::istringstream is(input);
+    bool halted;
+    {
+        Console console{os, is, ConsoleMode::Buffered};
+        ThreadedVM vm{*memory, program, console};
+        halted = vm.run_for(step_limit == unlimited ? std::numeric_limits<size_t>::max() : step_limit);
+        cleanup.begin = vm.touched_begin();
+        cleanup.end = vm.touched_end();
+    }
+
+    return RunReport{halted ? RunStatus::Halted : RunStatus::StepLimit, os.str()};
+}
+
+} // namespace bf
@@ -0,0 +1,167 @@
+#include <mutex>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "bf/guarded_region.hpp"
+#include "bf/bf_exceptions.hpp"
+
+namespace bf {
+
+namespace {
+
+constexpr uintptr_t claimed = 1;    // slot taken, region not yet published
+
+size_t page_size()
+{
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+uintptr_t round_up(uintptr_t value, uintptr_t multiple)
+{
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
+} // namespace
+
+GuardedRegion::Slot GuardedRegion::slots_[GuardedRegion::max_regions];
+struct sigaction GuardedRegion::previous_action_;
+
+GuardedRegion::GuardedRegion(size_t initial, size_t capacity, size_t guard)
+: mapping_{nullptr}
+, mapping_size_{0}
+, capacity_{round_up(capacity, page_size())}
+, guard_{round_up(guard > page_size() ? guard : page_size(), page_size())}
+, slot_{max_regions}
+{
+    install_handler();
+
+    for (size_t i = 0; i < max_regions; ++i) {
+        uintptr_t expected = 0;
+        if (slots_[i].begin.compare_exchange_strong(expected, claimed)) {
+            slot_ = i;
+            break;
+        }
+    }
+    if (slot_ == max_regions) {
+        throw TapeException("too many guarded regions alive");
+    }
+
+    mapping_size_ = capacity_ + 2 * guard_;
+    void* mapping = mmap(nullptr, mapping_size_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED) {
+        slots_[slot_].begin.store(0);
+        throw TapeException("cannot reserve address space");
+    }
+    mapping_ = static_cast<char*>(mapping);
+
+    Slot& slot = slots_[slot_];
+    uintptr_t begin = reinterpret_cast<uintptr_t>(mapping_ + guard_);
+    slot.end.store(begin + capacity_);
+    slot.committed_end.store(begin);
+    slot.begin.store(begin, std::memory_order_release);
+
+    ensure(initial);
+}
+
+GuardedRegion::~GuardedRegion()
+{
+    slots_[slot_].begin.store(claimed);
+    munmap(mapping_, mapping_size_);
+    slots_[slot_].begin.store(0, std::memory_order_release);
+}
+
+CellType* GuardedRegion::data() const
+{
+    return reinterpret_cast<CellType*>(mapping_ + guard_);
+}
+
+size_t GuardedRegion::capacity() const
+{
+    return capacity_;
+}
+
+size_t GuardedRegion::guard() const
+{
+    return guard_;
+}
+
+size_t GuardedRegion::committed() const
+{
+    return slots_[slot_].committed_end.load() - reinterpret_cast<uintptr_t>(data());
+}
+
+void GuardedRegion::ensure(size_t bytes)
+{
+    Slot& slot = slots_[slot_];
+    uintptr_t target = slot.begin.load() + (bytes < capacity_ ? bytes : capacity_);
+    if (target > slot.committed_end.load() && !commit_up_to(slot, target)) {
+        throw TapeException("cannot commit memory");
+    }
+}
+
+bool GuardedRegion::commit_up_to(Slot& slot, uintptr_t target) noexcept
+{
+    uintptr_t from = slot.committed_end.load();
+    uintptr_t end = slot.end.load();
+    uintptr_t to = round_up(target, growth_chunk);
+    if (to > end) {
+        to = end;
+    }
+    if (to <= from) {
+        return true;
+    }
+    if (mprotect(reinterpret_cast<void*>(from), to - from, PROT_READ | PROT_WRITE) != 0) {
+        return false;
+    }
+    slot.committed_end.store(to);
+    return true;
+}
+
+void GuardedRegion::install_handler()
+{
+    // checked on every region, since other code may have replaced the handler in the meantime
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    struct sigaction current{};
+    sigaction(SIGSEGV, nullptr, &current);
+    if ((current.sa_flags & SA_SIGINFO) && current.sa_sigaction == &GuardedRegion::on_fault) {
+        return;
+    }
+
+    struct sigaction action{};
+    action.sa_sigaction = &GuardedRegion::on_fault;
+    action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, &previous_action_);
+}
+
+void GuardedRegion::on_fault(int signal, siginfo_t* info, void* context)
+{
+    const uintptr_t address = reinterpret_cast<uintptr_t>(info->si_addr);
+    for (Slot& slot : slots_) {
+        uintptr_t begin = slot.begin.load(std::memory_order_acquire);
+        if (begin <= claimed || address < begin || address >= slot.end.load()) {
+            continue;
+        }
+        if (address >= slot.committed_end.load() && commit_up_to(slot, address + 1)) {
+            return;     // the faulting access is retried on the newly committed pages
+        }
+        break;
+    }
+
+    // not a growth fault - hand it to whoever was installed before us
+    if (previous_action_.sa_flags & SA_SIGINFO) {
+        previous_action_.sa_sigaction(signal, info, context);
+    } else if (previous_action_.sa_handler != SIG_IGN && previous_action_.sa_handler != SIG_DFL) {
+        previous_action_.sa_handler(signal);
+    } else {
+        struct sigaction fallback{};
+        fallback.sa_handler = SIG_DFL;
+        sigemptyset(&fallback.sa_mask);
+        sigaction(SIGSEGV, &fallback, nullptr);  // the retried access now takes the default action
+    }
+}
+
+} // namespace bf
@@ -0,0 +1,55 @@
+#include "bf/jit_vm.hpp"
+#include "bf/x86_jit.hpp"
+#include "bf/c_transpiler.hpp"
+#include "bf/bf_exceptions.hpp"
+
+namespace bf {
+
+namespace {
+
+void console_output(void* context, CellType c)
+{
+    static_cast<Console*>(context)->print_char(c);
+}
+
+void console_output_repeat(void* context, CellType c, size_t count)
+{
+    static_cast<Console*>(context)->print_chars(c, count);
+}
+
+CellType console_input(void* context)
+{
+    return static_cast<Console*>(context)->input_char();
+}
+
+} // namespace
+
+JitVM::JitVM(Memory& memory, Program& program, Console& console, JitMode mode)
+: memory_{memory}
+, program_{program}
+, console_{console}
+, entry_{nullptr}
+{
+    if (mode == JitMode::MachineCode) {
+#if defined(__x86_64__)
+        machine_code_ = std::make_unique<ExecutableBuffer>(X86Jit::assemble(program_.get_instructions(), memory_.size(), memory_.boundary()));
+        entry_ = machine_code_->entry();
+#else
+        throw JitException("machine code generation requires an x86-64 host");
+#endif
+    } else {
+        library_ = CTranspiler::build(CTranspiler::emit(program_.get_instructions(), memory_.size(), memory_.boundary()));
+        entry_ = library_->entry(CTranspiler::entry_symbol);
+    }
+}
+
+void JitVM::run()
+{
+    NativeIO io{&console_, &console_output, &console_input, &console_output_repeat};
+    memory_.reserve_guard(program_.reach());
+    memory_.seek(entry_(memory_.data(), memory_.size(), memory_.position(), &io));
+
+    program_.finish();
+}
+
+} // namespace bf
@@ -1,37 +1,72 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 #include "bf/memory.hpp"
 #include <iostream>
 
 namespace bf {
 
-Memory::Memory(size_t size)
-: tape_(size, 0)
+Memory::Memory(size_t size, Boundary boundary)
+: boundary_{boundary}
+, tape_(boundary == Boundary::Wrap ? size : 0, 0)
+, region_{boundary == Boundary::Grow ? std::make_unique<GuardedRegion>(size) : nullptr}
+, cells_{region_ ? region_->data() : tape_.data()}
+, size_{region_ ? region_->capacity() : tape_.size()}
 , pointer_{0}
 {
 }
 
+Memory::Memory(Memory const& other)
+: boundary_{other.boundary_}
+, tape_(other.tape_)
+, region_{other.region_ ? std::make_unique<GuardedRegion>(other.region_->committed(), other.region_->capacity(), other.region_->guard()) : nullptr}
+, cells_{region_ ? region_->data() : tape_.data()}
+, size_{other.size_}
+, pointer_{other.pointer_}
+{
+    if (region_) {
+        std::memcpy(cells_, other.cells_, other.region_->committed());
+    }
+}
+
+Memory& Memory::operator=(Memory const& other)
+{
+    if (this != &other) {
+        Memory copy{other};
+        boundary_ = copy.boundary_;
+        tape_ = std::move(copy.tape_);
+        region_ = std::move(copy.region_);
+        cells_ = region_ ? region_->data() : tape_.data();
+        size_ = copy.size_;
+        pointer_ = copy.pointer_;
+    }
+    return *this;
+}
+
 CellType Memory::read() 
 {
-    return (tape_[pointer_]);
+    return (cells_[pointer_]);
 }
 
 void Memory::write(CellType c) 
 {
-    tape_[pointer_] = c;
+    cells_[pointer_] = c;
 }
 
 void Memory::move_left() 
 {
-    if (pointer_ > 0) {
+    if (pointer_ > 0 || boundary_ == Boundary::Grow) {
         --pointer_;
     }
     else {
-        pointer_ = tape_.size() - 1;
+        pointer_ = size_ - 1;
     }
 }
 
 void Memory::move_right() 
 {
-    if (pointer_ < tape_.size() - 1) {
+    if (pointer_ < size_ - 1 || boundary_ == Boundary::Grow) {
         ++pointer_;
     }
     else {
@@ -39,10 +74,94 @@ void Memory::move_right()
     }
 }
 
+void Memory::move(int32_t distance)
+{
+    pointer_ = locate(distance);
+}
+
+CellType Memory::read_at(int32_t offset)
+{
+    return cells_[locate(offset)];
+}
+
+void Memory::write_at(int32_t offset, CellType c)
+{
+    cells_[locate(offset)] = c;
+}
+
+CellType* Memory::data()
+{
+    return cells_;
+}
+
+size_t Memory::size() const
+{
+    return size_;
+}
+
+Boundary Memory::boundary() const
+{
+    return boundary_;
+}
+
+Index Memory::position() const
+{
+    return pointer_;
+}
+
+void Memory::seek(Index position)
+{
+    pointer_ = position;
+}
+
+void Memory::reset(Index begin, Index end)
+{
+    if (region_) {
+        end = std::min(end, region_->committed());
+    }
+    if (begin < end) {
+        std::memset(cells_ + begin, 0, end - begin);
+    }
+    pointer_ = 0;
+}
+
+void Memory::reserve_guard(size_t cells)
+{
+    if (!region_) {
+        return;
+    }
+    // an Index below cell 0 has wrapped around to the top of the range
+    size_t outside = pointer_ < size_ ? 0 : (pointer_ > SIZE_MAX / 2 ? 0 - pointer_ : pointer_ - size_ + 1);
+    size_t wanted = cells + outside;
+    if (region_->guard() >= wanted) {
+        return;
+    }
+    auto wider = std::make_unique<GuardedRegion>(region_->committed(), region_->capacity(), wanted);
+    std::memcpy(wider->data(), cells_, region_->committed());
+    region_ = std::move(wider);
+    cells_ = region_->data();
+}
+
+Index Memory::locate(int32_t offset) const
+{
+    // a growable tape needs no check: stepping off it lands in a guard zone
+    return boundary_ == Boundary::Grow ? pointer_ + static_cast<Index>(static_cast<ptrdiff_t>(offset)) : wrap(offset);
+}
+
+Index Memory::wrap(int32_t offset) const
+{
+    const long size = static_cast<long>(size_);
+    long index = (static_cast<long>(pointer_) + offset) % size;
+    if (index < 0) {
+        index += size;
+    }
+    return static_cast<Index>(index);
+}
+
 #ifdef BF_DEBUG
 CellType Memory::operator[](Index index) const 
 {
-    return tape_[index];
+    return cells_[index];
 }
 #endif
 
@@ -19,39 +19,67 @@ int Microcode::index(OpCode op)
 }
 
 void Microcode::build_commands() {
-    commands_[index(OpCode::Increment)] = [this](){ memory_.write(memory_.read() + 1); };
-    commands_[index(OpCode::Decrement)] = [this](){ memory_.write(memory_.read() - 1); };
-    commands_[index(OpCode::MoveLeft)] = [this](){ memory_.move_left(); };
-    commands_[index(OpCode::MoveRight)] = [this](){ memory_.move_right(); };
+    commands_[index(OpCode::Increment)] = [this](Instruction const&){ memory_.write(memory_.read() + 1); };
+    commands_[index(OpCode::Decrement)] = [this](Instruction const&){ memory_.write(memory_.read() - 1); };
+    commands_[index(OpCode::MoveLeft)] = [this](Instruction const&){ memory_.move_left(); };
+    commands_[index(OpCode::MoveRight)] = [this](Instruction const&){ memory_.move_right(); };
     
-    commands_[index(OpCode::Output)] = [this](){ 
-        console_.print_char(memory_.read());
+    commands_[index(OpCode::Output)] = [this](Instruction const& in){ 
+        if (in.arg > 1) {
+            console_.print_chars(memory_.read(), static_cast<size_t>(in.arg));
+        } else {
+            console_.print_char(memory_.read());
+        }
     };
-    commands_[index(OpCode::Input)] = [this]() {
+    commands_[index(OpCode::Input)] = [this](Instruction const&) {
         CellType c = console_.input_char();
         memory_.write(c);
     };
 
-    commands_[index(OpCode::LoopStart)] = [this]() {
+    commands_[index(OpCode::LoopStart)] = [this](Instruction const&) {
         if (memory_.read() == 0) {
             program_.jump_forward_to_matching_end();
         }
     };
 
-    commands_[index(OpCode::LoopEnd)] = [this]() {
+    commands_[index(OpCode::LoopEnd)] = [this](Instruction const&) {
         if (memory_.read() != 0) {
             program_.jump_backward_to_matching_start();
         }
     };
 
-    commands_[index(OpCode::HALT)] = [this](){ };
+    commands_[index(OpCode::Add)] = [this](Instruction const& in) {
+        memory_.write_at(in.offset, static_cast<CellType>(memory_.read_at(in.offset) + in.arg));
+    };
+    commands_[index(OpCode::Move)] = [this](Instruction const& in) { memory_.move(in.arg); };
+    commands_[index(OpCode::SetZero)] = [this](Instruction const& in) { memory_.write_at(in.offset, 0); };
+
+    commands_[index(OpCode::MultiplyAdd)] = [this](Instruction const& in) {
+        CellType factor = memory_.read();
+        if (factor != 0) {
+            memory_.write_at(in.offset, static_cast<CellType>(memory_.read_at(in.offset) + factor * in.arg));
+        }
+    };
+
+    commands_[index(OpCode::ScanLeft)] = [this](Instruction const& in) {
+        while (memory_.read() != 0) {
+            memory_.move(-in.arg);
+        }
+    };
+    commands_[index(OpCode::ScanRight)] = [this](Instruction const& in) {
+        while (memory_.read() != 0) {
+            memory_.move(in.arg);
+        }
+    };
+
+    commands_[index(OpCode::HALT)] = [this](Instruction const&){ };
 }
 
-void Microcode::execute(OpCode op) 
+void Microcode::execute(Instruction const& instruction) 
 {
-    int index = Microcode::index(op);
-    commands_[index]();
+    int index = Microcode::index(instruction.op);
+    commands_[index](instruction);
     program_.jump(1);
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,69 @@
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <dlfcn.h>
+
+#include "bf/native_code.hpp"
+#include "bf/bf_exceptions.hpp"
+
+namespace bf {
+
+ExecutableBuffer::ExecutableBuffer(std::vector<uint8_t> const& code)
+: buffer_{nullptr}
+, size_{0}
+{
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_ = ((code.size() + page - 1) / page) * page;
+    if (size_ == 0) {
+        size_ = page;
+    }
+
+    buffer_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer_ == MAP_FAILED) {
+        buffer_ = nullptr;
+        throw JitException("cannot map memory for generated code");
+    }
+    std::memcpy(buffer_, code.data(), code.size());
+    if (mprotect(buffer_, size_, PROT_READ | PROT_EXEC) != 0) {
+        munmap(buffer_, size_);
+        buffer_ = nullptr;
+        throw JitException("cannot make generated code executable");
+    }
+}
+
+ExecutableBuffer::~ExecutableBuffer()
+{
+    if (buffer_ != nullptr) {
+        munmap(buffer_, size_);
+    }
+}
+
+NativeEntry ExecutableBuffer::entry() const
+{
+    return reinterpret_cast<NativeEntry>(buffer_);
+}
+
+SharedLibrary::SharedLibrary(std::string const& path)
+: handle_{dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)}
+{
+    if (handle_ == nullptr) {
+        const char* error = dlerror();
+        throw JitException("cannot load " + path + (error ? std::string(": ") + error : std::string()));
+    }
+}
+
+SharedLibrary::~SharedLibrary()
+{
+    dlclose(handle_);
+}
+
+NativeEntry SharedLibrary::entry(std::string const& symbol) const
+{
+    void* address = dlsym(handle_, symbol.c_str());
+    if (address == nullptr) {
+        throw JitException("missing symbol " + symbol);
+    }
+    return reinterpret_cast<NativeEntry>(address);
+}
+
+} // namespace bf
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "bf/optimizer.hpp"
+#include "bf/program.hpp"
+
+namespace bf {
+
+namespace {
+
+constexpr int32_t cell_modulo = 256;
+
+int32_t normalize_cell_delta(int32_t delta)
+{
+    return ((delta % cell_modulo) + cell_modulo) % cell_modulo;
+}
+
+bool is_folded_add(Instruction const& in)
+{
+    return in.op == OpCode::Add && in.offset == 0;
+}
+
+} // namespace
+
+Optimizer::Optimizer()
+{
+    build_pipeline();
+}
+
+void Optimizer::build_pipeline()
+{
+    passes_.push_back(&Optimizer::fold_runs);
+    passes_.push_back(&Optimizer::lower_clear_loops);
+    passes_.push_back(&Optimizer::lower_scan_loops);
+    passes_.push_back(&Optimizer::fold_offsets);     // after the scans, which need their Move
+    passes_.push_back(&Optimizer::lower_multiply_loops);
+}
+
+void Optimizer::add_pass(Pass pass)
+{
+    passes_.push_back(std::move(pass));
+}
+
+Code Optimizer::optimize(Code code) const
+{
+    for (Pass const& pass : passes_) {
+        code = pass(code);
+    }
+    Program::link_loops(code);  // passes shift instruction indices, so jump targets are resolved last
+    return code;
+}
+
+Code Optimizer::fold_runs(Code const& code)
+{
+    Code folded;
+    folded.reserve(code.size());
+    for (Instruction in : code) {
+        switch (in.op) {
+            case OpCode::Increment:
+                in = Instruction{OpCode::Add, 1};
+                break;
+            case OpCode::Decrement:
+                in = Instruction{OpCode::Add, -1};
+                break;
+            case OpCode::MoveRight:
+                in = Instruction{OpCode::Move, 1};
+                break;
+            case OpCode::MoveLeft:
+                in = Instruction{OpCode::Move, -1};
+                break;
+            default:
+                break;
+        }
+
+        if (!folded.empty() && is_folded_add(in) && is_folded_add(folded.back())) {
+            folded.back().arg += in.arg;
+        } else if (!folded.empty() && in.op == OpCode::Move && folded.back().op == OpCode::Move) {
+            folded.back().arg += in.arg;
+        } else if (!folded.empty() && in.op == OpCode::Output && folded.back().op == OpCode::Output) {
+            folded.back().arg = std::max(folded.back().arg, 1) + 1;    // "..." prints the same cell n times
+        } else {
+            folded.push_back(in);
+        }
+
+        Instruction& last = folded.back();
+        if (last.op == OpCode::Add) {
+            last.arg = normalize_cell_delta(last.arg);
+        }
+        if ((last.op == OpCode::Add || last.op == OpCode::Move) && last.arg == 0) {
+            folded.pop_back();
+        }
+    }
+    return folded;
+}
+
+Code Optimizer::lower_clear_loops(Code const& code)
+{
+    return rewrite_innermost_loops(code, [](Code const& body, Code& replacement) {
+        if (body.size() != 1 || !is_folded_add(body[0]) || body[0].arg % 2 == 0) {
+            return false;
+        }
+        replacement.push_back(Instruction{OpCode::SetZero});
+        return true;
+    });
+}
+
+Code Optimizer::lower_scan_loops(Code const& code)
+{
+    return rewrite_innermost_loops(code, [](Code const& body, Code& replacement) {
+        if (body.size() != 1 || body[0].op != OpCode::Move) {
+            return false;
+        }
+        int32_t distance = body[0].arg;
+        replacement.push_back(distance > 0 ? Instruction{OpCode::ScanRight, distance}
+                                           : Instruction{OpCode::ScanLeft, -distance});
+        return true;
+    });
+}
+
+Code Optimizer::lower_multiply_loops(Code const& code)
+{
+    return rewrite_innermost_loops(code, [](Code const& body, Code& replacement) {
+        std::map<int32_t, int32_t> deltas;
+        int32_t position = 0;
+        for (Instruction const& in : body) {
+            if (in.op == OpCode::Add) {
+                deltas[position + in.offset] += in.arg;
+            } else if (in.op == OpCode::Move) {
+                position += in.arg;
+            } else {
+                return false;
+            }
+        }
+        if (position != 0) {
+            return false;
+        }
+
+        int32_t step = normalize_cell_delta(deltas[0]);
+        if (step != 1 && step != cell_modulo - 1) {
+            return false;
+        }
+
+        // a counter stepping by -1 runs 'value' times, one stepping by +1 runs '256 - value' times
+        for (auto const& [offset, delta] : deltas) {
+            int32_t factor = normalize_cell_delta(step == 1 ? -delta : delta);
+            if (offset != 0 && factor != 0) {
+                replacement.push_back(Instruction{OpCode::MultiplyAdd, factor, offset});
+            }
+        }
+        replacement.push_back(Instruction{OpCode::SetZero});
+        return true;
+    });
+}
+
+Code Optimizer::fold_offsets(Code const& code)
+{
+    Code folded;
+    folded.reserve(code.size());
+    int32_t pending = 0;
+    for (Instruction in : code) {
+        switch (in.op) {
+            case OpCode::Move:
+                pending += in.arg;
+                continue;
+            case OpCode::Add:
+                in.offset += pending;
+                if (!folded.empty() && folded.back().op == OpCode::Add && folded.back().offset == in.offset) {
+                    folded.back().arg = normalize_cell_delta(folded.back().arg + in.arg);
+                    if (folded.back().arg == 0) {
+                        folded.pop_back();
+                    }
+                    continue;
+                }
+                break;
+            case OpCode::SetZero:
+                in.offset += pending;
+                break;
+            default:
+                if (pending != 0) {
+                    folded.push_back(Instruction{OpCode::Move, pending});
+                    pending = 0;
+                }
+                break;
+        }
+        folded.push_back(in);
+    }
+    if (pending != 0) {
+        folded.push_back(Instruction{OpCode::Move, pending});
+    }
+    return folded;
+}
+
+Code Optimizer::rewrite_innermost_loops(Code const& code, std::function<bool(Code const&, Code&)> const& rewrite)
+{
+    Code result;
+    result.reserve(code.size());
+    size_t innermost_start = 0;
+    bool in_innermost = false;
+
+    for (Instruction const& in : code) {
+        if (in.op == OpCode::LoopStart) {
+            innermost_start = result.size();
+            in_innermost = true;
+        } else if (in.op == OpCode::LoopEnd && in_innermost) {
+            in_innermost = false;
+            Code body(result.begin() + innermost_start + 1, result.end());
+            Code replacement;
+            if (rewrite(body, replacement)) {
+                result.resize(innermost_start);
+                result.insert(result.end(), replacement.begin(), replacement.end());
+                continue;
+            }
+        }
+        result.push_back(in);
+    }
+    return result;
+}
+
+} // namespace bf
@@ -1,39 +1,58 @@
-#include <string>
-#include <sstream>
+#include <algorithm>
+#include <cstdlib>
 #include <stack>
-#include <iostream>
+#include <utility>
 
 #include "bf/program.hpp"
 
 namespace bf {
 
 Program::Program(std::vector<OpCode> source)
-: instructions_{source}
+: instructions_{}
 , ip_{0}
+, reach_{0}
 {
-    build_jump_table();
-    instructions_.push_back(OpCode::HALT); // in case we forgot halt at the end
+    Code code = to_code(source);
+    link_loops(code);
+    code.push_back(Instruction{OpCode::HALT}); // in case we forgot halt at the end
+    reach_ = measure_reach(code);
+    instructions_ = std::make_shared<const Code>(std::move(code));
 }
 
-Program::Program(std::vector<OpCode> source, std::unordered_map<size_t, size_t> jump_t)
-: instructions_{source}
+Program::Program(Code code)
+: instructions_{}
 , ip_{0}
-, jump_table_{jump_t}
+, reach_{0}
 {
+    if (code.empty() || code.back().op != OpCode::HALT) {
+        code.push_back(Instruction{OpCode::HALT});
+    }
+    reach_ = measure_reach(code);
+    instructions_ = std::make_shared<const Code>(std::move(code));
+}
+
+Code Program::to_code(std::vector<OpCode> const& source)
+{
+    Code code;
+    code.reserve(source.size() + 1);
+    for (OpCode op : source) {
+        code.push_back(Instruction{op});
+    }
+    return code;
 }
 
 void Program::jump(int offset) 
 {
     int new_ip = (static_cast<int>(ip_) + offset);
-    if (new_ip >= 0 && static_cast<size_t>(new_ip) < instructions_.size()) {
+    if (new_ip >= 0 && static_cast<size_t>(new_ip) < instructions_->size()) {
         ip_ = static_cast<size_t>(new_ip);
     }
 }
 
 OpCode Program::fetch_next() 
 {
-    if (ip_ < instructions_.size()) {
-        return instructions_[ip_++];
+    if (ip_ < instructions_->size()) {
+        return (*instructions_)[ip_++].op;
     } else {
         return OpCode::HALT;
     }
@@ -41,54 +60,100 @@ OpCode Program::fetch_next()
 
 OpCode Program::fetch_current() 
 {
-    return instructions_[ip_];
+    return (*instructions_)[ip_].op;
+}
+
+const Instruction& Program::current() const
+{
+    return (*instructions_)[ip_];
+}
+
+void Program::finish()
+{
+    ip_ = instructions_->size() - 1;     // every constructor leaves a HALT last
 }
 
 bool Program::is_done() const 
 {
-    return instructions_[ip_] == OpCode::HALT;
+    return (*instructions_)[ip_].op == OpCode::HALT;
 }
 
-void Program::build_jump_table() 
+bool Program::link_loops(Code& code)
 {
+    // an unmatched bracket targets itself, so taking its branch is a no-op
     std::stack<size_t> loopStack;
-    for (size_t i = 0; i < instructions_.size(); ++i) {
-        if (instructions_[i] == OpCode::LoopStart) {
+    bool matched = true;
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (code[i].op == OpCode::LoopStart) {
+            code[i].arg = static_cast<int32_t>(i);
             loopStack.push(i);
-        } else if (instructions_[i] == OpCode::LoopEnd) {
-            if (!loopStack.empty()) {
-                size_t start = loopStack.top();
-                loopStack.pop();
-                jump_table_[start] = i;
-                jump_table_[i] = start;
+        } else if (code[i].op == OpCode::LoopEnd) {
+            code[i].arg = static_cast<int32_t>(i);
+            if (loopStack.empty()) {
+                matched = false;
+                continue;
             }
+            size_t start = loopStack.top();
+            loopStack.pop();
+            code[start].arg = static_cast<int32_t>(i);
+            code[i].arg = static_cast<int32_t>(start);
         }
     }
+    return matched && loopStack.empty();
 }
 
 void Program::jump_forward_to_matching_end() 
 {
-    if (jump_table_.find(ip_) != jump_table_.end()) {
-        ip_ = jump_table_[ip_];
-    }
+    ip_ = static_cast<size_t>((*instructions_)[ip_].arg);
 }
 
 void Program::jump_backward_to_matching_start() 
 {
-    if (jump_table_.find(ip_) != jump_table_.end()) {
-        ip_ = jump_table_[ip_];
-    }
+    ip_ = static_cast<size_t>((*instructions_)[ip_].arg);
 }
 
-// for debug
-const std::vector<OpCode>& Program::get_instructions() const 
+size_t Program::reach() const
+{
+    return reach_;
+}
+
+size_t Program::measure_reach(Code const& code)
 {
-    return instructions_;
+    auto magnitude = [](int32_t value) { return static_cast<size_t>(std::llabs(value)); };
+
+    size_t widest_offset = 0;
+    size_t longest_drift = 0;
+    size_t drift = 0;   // cells moved since the last instruction that touched the tape
+    for (Instruction const& in : code) {
+        switch (in.op) {
+        case OpCode::MoveLeft:
+        case OpCode::MoveRight:
+            drift += 1;
+            break;
+        case OpCode::Move:
+            drift += magnitude(in.arg);
+            break;
+        case OpCode::HALT:
+        case OpCode::END:
+            break;
+        case OpCode::ScanLeft:
+        case OpCode::ScanRight:
+            longest_drift = std::max(longest_drift, magnitude(in.arg));
+            [[fallthrough]];
+        default:
+            longest_drift = std::max(longest_drift, drift);
+            widest_offset = std::max(widest_offset, magnitude(in.offset));
+            drift = 0;
+            break;
+        }
+    }
+    return std::max(longest_drift, drift) + 2 * widest_offset;
 }
 
-const std::unordered_map<size_t, size_t>& Program::get_jump_table() const 
+// for debug
+const Code& Program::get_instructions() const 
 {
-    return jump_table_;
+    return *instructions_;
 }
 
 }
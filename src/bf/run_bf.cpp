@@ -1,33 +1,73 @@
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <string_view>
 #include <string.h>
 
 #include "bf/command_line_args.hpp"
 #include "bf/compiler.hpp"
 #include "bf/console.hpp"
 #include "bf/vm.hpp"
+#include "bf/threaded_vm.hpp"
+#include "bf/jit_vm.hpp"
+#include "bf/bf_exceptions.hpp"
 #include "bf/operations.hpp"
 #include "bf/mem_arg_types.hpp"
 #include "bf/memory.hpp"
+#include "bf/source_file.hpp"
 
 /*
 ./run_bf -r "++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++."
+./run_bf --threaded program.bf
+./run_bf --jit program.bf
+./run_bf --jit --buffered program.bf
 */
 
 int main(int argc, char *argv[]) 
 {
+    // Unsynced, std::cin reads stdin in blocks, which is what a buffered Console refills from
+    std::ios::sync_with_stdio(false);
+
     std::string input_code;
-    if (!bf::CommandLineArgs::get_code_for_compilation(argc, argv, input_code)) {
+    bf::RunOptions options{};
+    if (!bf::CommandLineArgs::get_code_for_compilation(argc, argv, input_code, options)) {
         return 1;
     }
 
+    std::unique_ptr<bf::SourceFile> source_file;
+    std::string_view source = input_code;
+    if (!options.source_path.empty()) {
+        try {
+            source_file = std::make_unique<bf::SourceFile>(options.source_path);
+            source = source_file->view();
+        } catch (bf::SourceException const& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    }
+
     bf::Compiler compiler{};
-    bf::Program program = compiler.compile(input_code);
+    bf::Program program = compiler.compile_analyzed(source);
+    source_file.reset();    // the program no longer refers to the source
 
-    bf::Console console{};
-    bf::Memory tape{};
-    bf::VM vm{tape, program, console};
+    bf::Console console{std::cout, std::cin, options.console};
+    bf::Memory tape{30000, options.boundary};
 
-    vm.run(); 
+    if (options.backend == bf::Backend::Threaded) {
+        bf::ThreadedVM vm{tape, program, console};
+        vm.run();
+    } else if (options.backend == bf::Backend::Jit || options.backend == bf::Backend::JitC) {
+        try {
+            bf::JitVM vm{tape, program, console,
+                         options.backend == bf::Backend::Jit ? bf::JitMode::MachineCode : bf::JitMode::CSource};
+            vm.run();
+        } catch (bf::JitException const& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    } else {
+        bf::VM vm{tape, program, console};
+        vm.run(); 
+    }
 
 }
\ No newline at end of file
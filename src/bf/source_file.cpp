@@ -0,0 +1,86 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include "bf/source_file.hpp"
+#include "bf/bf_exceptions.hpp"
+
+namespace bf {
+
+SourceFile::SourceFile(const std::string& path)
+: data_{nullptr}
+, size_{0}
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw SourceException("cannot open " + path + ": " + strerror(errno));
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw SourceException("cannot stat " + path + ": " + strerror(error));
+    }
+
+    if (!S_ISREG(info.st_mode)) {
+        // no size to map: read until end of input
+        char block[1 << 16];
+        for (;;) {
+            ssize_t got = ::read(fd, block, sizeof(block));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got < 0) {
+                int error = errno;
+                ::close(fd);
+                throw SourceException("cannot read " + path + ": " + strerror(error));
+            }
+            if (got == 0) {
+                break;
+            }
+            streamed_.append(block, static_cast<size_t>(got));
+        }
+        ::close(fd);
+        size_ = streamed_.size();
+        return;
+    }
+
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw SourceException("cannot map " + path + ": " + strerror(error));
+        }
+        ::madvise(mapping, size_, MADV_SEQUENTIAL);   // a hint only - failure is harmless
+        data_ = static_cast<const char*>(mapping);
+    }
+    ::close(fd);    // the mapping keeps the file alive
+}
+
+SourceFile::~SourceFile()
+{
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+std::string_view SourceFile::view() const
+{
+    if (data_ == nullptr) {
+        return streamed_;
+    }
+    return std::string_view{data_, size_};
+}
+
+size_t SourceFile::size() const
+{
+    return size_;
+}
+
+} // namespace bf
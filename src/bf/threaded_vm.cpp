@@ -0,0 +1,312 @@
+#include <cstddef>
+#include <algorithm>
+
+#include "bf/threaded_vm.hpp"
+
+#if defined(__GNUC__) && !defined(BF_NO_COMPUTED_GOTO)
+#define BF_COMPUTED_GOTO
+#endif
+
+#ifdef BF_COMPUTED_GOTO
+// labels as values ('&&label', 'goto *') are a GNU extension: -Wpedantic is silenced around
+// the handler table and each indirect jump only, not the rest of the file
+#define BF_GNU_EXTENSION_BEGIN _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wpedantic\"")
+#define BF_GNU_EXTENSION_END _Pragma("GCC diagnostic pop")
+#define BF_TARGET(op) op_##op:
+#define BF_DISPATCH() BF_GNU_EXTENSION_BEGIN goto *threaded[pc]; BF_GNU_EXTENSION_END do {} while (0)
+#else
+#define BF_TARGET(op) case OpCode::op:
+#define BF_DISPATCH() continue
+#endif
+
+#define BF_NEXT() ++pc; BF_DISPATCH()
+
+namespace bf {
+
+namespace {
+
+/**
+ * @brief Moves a tape index by 'delta' cells, wrapping around the tape edges.
+ *
+ * The common case (the result is still on the tape) costs a single unsigned compare.
+ */
+inline size_t wrap_index(size_t index, int32_t delta, size_t size)
+{
+    size_t moved = index + static_cast<size_t>(static_cast<ptrdiff_t>(delta));
+    if (moved < size) {
+        return moved;
+    }
+    ptrdiff_t wrapped = (static_cast<ptrdiff_t>(index) + delta) % static_cast<ptrdiff_t>(size);
+    return static_cast<size_t>(wrapped < 0 ? wrapped + static_cast<ptrdiff_t>(size) : wrapped);
+}
+
+/**
+ * @brief Tape policy for Boundary::Wrap - moves and offsets wrap around the tape edges.
+ */
+struct WrappingTape {
+    static size_t step(size_t index, int32_t delta, size_t size)
+    {
+        return wrap_index(index, delta, size);
+    }
+};
+
+/**
+ * @brief Tape policy for Boundary::Grow - no checks, the guard zones catch runaway pointers.
+ */
+struct UnboundedTape {
+    static size_t step(size_t index, int32_t delta, size_t)
+    {
+        return index + static_cast<size_t>(static_cast<ptrdiff_t>(delta));
+    }
+};
+
+/**
+ * @brief Meter for run() - no budget, nothing recorded; compiles away entirely.
+ */
+struct Unmetered {
+    bool tick() { return true; }
+    void visit(size_t) {}
+};
+
+/**
+ * @brief Meter for run_for() - spends the step budget and records the data pointer range.
+ */
+struct Metered {
+    bool tick()
+    {
+        if (budget == 0) {
+            return false;
+        }
+        --budget;
+        return true;
+    }
+
+    void visit(size_t index)
+    {
+        lowest = std::min(lowest, index);
+        highest = std::max(highest, index);
+    }
+
+    size_t budget;
+    size_t lowest;
+    size_t highest;
+};
+
+} // namespace
+
+ThreadedVM::ThreadedVM(Memory& memory, Program& program, Console& console)
+: memory_{memory}
+, program_{program}
+, console_{console}
+, lowest_{memory.position()}
+, highest_{memory.position()}
+, touched_begin_{memory.position()}
+, touched_end_{memory.position()}
+{
+}
+
+void ThreadedVM::run()
+{
+    Unmetered meter{};
+    if (memory_.boundary() == Boundary::Grow) {
+        memory_.reserve_guard(program_.reach());
+        execute<UnboundedTape>(meter);
+    } else {
+        execute<WrappingTape>(meter);
+    }
+}
+
+bool ThreadedVM::run_for(size_t step_limit)
+{
+    memory_.reserve_guard(program_.reach());
+    Metered meter{step_limit, lowest_, highest_};
+    meter.visit(memory_.position());
+    bool halted = memory_.boundary() == Boundary::Grow ? execute<UnboundedTape>(meter)
+                                                       : execute<WrappingTape>(meter);
+    lowest_ = meter.lowest;
+    highest_ = meter.highest;
+    update_touched();
+    return halted;
+}
+
+Index ThreadedVM::touched_begin() const
+{
+    return touched_begin_;
+}
+
+Index ThreadedVM::touched_end() const
+{
+    return touched_end_;
+}
+
+void ThreadedVM::update_touched()
+{
+    int64_t low_offset = 0;
+    int64_t high_offset = 0;
+    for (Instruction const& in : program_.get_instructions()) {
+        if (in.op == OpCode::Add || in.op == OpCode::SetZero || in.op == OpCode::MultiplyAdd) {
+            low_offset = std::min<int64_t>(low_offset, in.offset);
+            high_offset = std::max<int64_t>(high_offset, in.offset);
+        }
+    }
+
+    int64_t begin = static_cast<int64_t>(lowest_) + low_offset;
+    int64_t end = static_cast<int64_t>(highest_) + high_offset + 1;
+    if (begin < 0 || end > static_cast<int64_t>(memory_.size())) {
+        begin = 0;      // some write wrapped around the tape edge
+        end = static_cast<int64_t>(memory_.size());
+    }
+    touched_begin_ = static_cast<Index>(begin);
+    touched_end_ = static_cast<Index>(end);
+}
+
+template <typename Tape, typename Meter>
+bool ThreadedVM::execute(Meter& meter)
+{
+    const Instruction* const code = program_.get_instructions().data();
+    const size_t start = static_cast<size_t>(&program_.current() - code);
+    size_t pc = start;
+
+    CellType* const tape = memory_.data();
+    const size_t size = memory_.size();
+    size_t dp = memory_.position();
+
+#ifdef BF_COMPUTED_GOTO
+    BF_GNU_EXTENSION_BEGIN
+    const void* handlers[static_cast<size_t>(OpCode::END) + 1];
+    handlers[static_cast<size_t>(OpCode::MoveRight)] = &&op_MoveRight;
+    handlers[static_cast<size_t>(OpCode::MoveLeft)] = &&op_MoveLeft;
+    handlers[static_cast<size_t>(OpCode::Increment)] = &&op_Increment;
+    handlers[static_cast<size_t>(OpCode::Decrement)] = &&op_Decrement;
+    handlers[static_cast<size_t>(OpCode::Output)] = &&op_Output;
+    handlers[static_cast<size_t>(OpCode::Input)] = &&op_Input;
+    handlers[static_cast<size_t>(OpCode::LoopStart)] = &&op_LoopStart;
+    handlers[static_cast<size_t>(OpCode::LoopEnd)] = &&op_LoopEnd;
+    handlers[static_cast<size_t>(OpCode::Add)] = &&op_Add;
+    handlers[static_cast<size_t>(OpCode::Move)] = &&op_Move;
+    handlers[static_cast<size_t>(OpCode::SetZero)] = &&op_SetZero;
+    handlers[static_cast<size_t>(OpCode::MultiplyAdd)] = &&op_MultiplyAdd;
+    handlers[static_cast<size_t>(OpCode::ScanLeft)] = &&op_ScanLeft;
+    handlers[static_cast<size_t>(OpCode::ScanRight)] = &&op_ScanRight;
+    handlers[static_cast<size_t>(OpCode::HALT)] = &&op_HALT;
+    handlers[static_cast<size_t>(OpCode::END)] = &&op_HALT;
+    BF_GNU_EXTENSION_END
+
+    // direct threading: resolve every instruction's handler address once, up front
+    const size_t length = program_.get_instructions().size();
+    std::vector<const void*> threaded(length);
+    for (size_t i = 0; i < length; ++i) {
+        threaded[i] = handlers[static_cast<size_t>(code[i].op)];
+    }
+
+    BF_DISPATCH();
+#else
+    for (;;) {
+    switch (code[pc].op) {
+#endif
+
+    BF_TARGET(MoveRight)
+        dp = Tape::step(dp, 1, size);
+        meter.visit(dp);
+        BF_NEXT();
+
+    BF_TARGET(MoveLeft)
+        dp = Tape::step(dp, -1, size);
+        meter.visit(dp);
+        BF_NEXT();
+
+    BF_TARGET(Increment)
+        ++tape[dp];
+        BF_NEXT();
+
+    BF_TARGET(Decrement)
+        --tape[dp];
+        BF_NEXT();
+
+    BF_TARGET(Output)
+        if (code[pc].arg > 1) {
+            console_.print_chars(tape[dp], static_cast<size_t>(code[pc].arg));
+        } else {
+            console_.print_char(tape[dp]);
+        }
+        BF_NEXT();
+
+    BF_TARGET(Input)
+        tape[dp] = console_.input_char();
+        BF_NEXT();
+
+    BF_TARGET(LoopStart)
+        if (tape[dp] == 0) {
+            pc = static_cast<size_t>(code[pc].arg);
+        }
+        BF_NEXT();
+
+    BF_TARGET(LoopEnd)
+        if (tape[dp] != 0) {
+            if (!meter.tick()) {
+                goto done;      // resumes at this LoopEnd
+            }
+            pc = static_cast<size_t>(code[pc].arg);
+        }
+        BF_NEXT();
+
+    BF_TARGET(Add)
+        {
+            CellType& cell = tape[Tape::step(dp, code[pc].offset, size)];
+            cell = static_cast<CellType>(cell + code[pc].arg);
+        }
+        BF_NEXT();
+
+    BF_TARGET(Move)
+        dp = Tape::step(dp, code[pc].arg, size);
+        meter.visit(dp);
+        BF_NEXT();
+
+    BF_TARGET(SetZero)
+        tape[Tape::step(dp, code[pc].offset, size)] = 0;
+        BF_NEXT();
+
+    BF_TARGET(MultiplyAdd)
+        if (tape[dp] != 0) {
+            CellType& cell = tape[Tape::step(dp, code[pc].offset, size)];
+            cell = static_cast<CellType>(cell + tape[dp] * code[pc].arg);
+        }
+        BF_NEXT();
+
+    BF_TARGET(ScanLeft)
+        while (tape[dp] != 0) {
+            if (!meter.tick()) {
+                goto done;      // resumes the scan from here
+            }
+            dp = Tape::step(dp, -code[pc].arg, size);
+        }
+        meter.visit(dp);
+        BF_NEXT();
+
+    BF_TARGET(ScanRight)
+        while (tape[dp] != 0) {
+            if (!meter.tick()) {
+                goto done;      // resumes the scan from here
+            }
+            dp = Tape::step(dp, code[pc].arg, size);
+        }
+        meter.visit(dp);
+        BF_NEXT();
+
+    BF_TARGET(HALT)
+        goto done;
+
+#ifndef BF_COMPUTED_GOTO
+    default:
+        goto done;
+    }
+    }
+#endif
+
+done:
+    memory_.seek(dp);
+    program_.jump(static_cast<int>(pc - start));
+    return code[pc].op == OpCode::HALT || code[pc].op == OpCode::END;
+}
+
+} // namespace bf
@@ -12,9 +12,9 @@ VM::VM(Memory& memory ,Program& program, Console& console)
 
 void VM::run()
 {
+  memory_.reserve_guard(program_.reach());
   while(!program_.is_done()) {
-    OpCode instruction = program_.fetch_current();
-    microcode_.execute(instruction);
+    microcode_.execute(program_.current());
   }
 }
 
@@ -0,0 +1,271 @@
+#include <stack>
+#include <utility>
+#include <initializer_list>
+
+#include "bf/x86_jit.hpp"
+#include "bf/bf_exceptions.hpp"
+
+namespace bf {
+
+namespace {
+
+/**
+ * @brief Emits the handful of x86-64 instruction forms the translation needs.
+ *
+ * Cells are addressed as [rbx + r12] (the current cell) or [rbx + rax] (a cell
+ * at an offset, after load_wrapped_index()).
+ */
+class Assembler {
+public:
+    Assembler(size_t tape_size, bool wrap)
+    : tape_size_{static_cast<int64_t>(tape_size)}
+    , wrap_{wrap}
+    {
+    }
+
+    std::vector<uint8_t> take() { return std::move(bytes_); }
+
+    size_t size() const { return bytes_.size(); }
+
+    void prologue()
+    {
+        emit({0x53});                   // push rbx
+        emit({0x41, 0x54});             // push r12
+        emit({0x41, 0x55});             // push r13
+        emit({0x41, 0x56});             // push r14
+        emit({0x41, 0x57});             // push r15 - keeps rsp 16-byte aligned for calls
+        emit({0x48, 0x89, 0xFB});       // mov rbx, rdi
+        emit({0x49, 0x89, 0xF5});       // mov r13, rsi
+        emit({0x49, 0x89, 0xD4});       // mov r12, rdx
+        emit({0x49, 0x89, 0xCE});       // mov r14, rcx
+    }
+
+    void epilogue()
+    {
+        emit({0x4C, 0x89, 0xE0});       // mov rax, r12
+        emit({0x41, 0x5F});             // pop r15
+        emit({0x41, 0x5E});             // pop r14
+        emit({0x41, 0x5D});             // pop r13
+        emit({0x41, 0x5C});             // pop r12
+        emit({0x5B});                   // pop rbx
+        emit({0xC3});                   // ret
+    }
+
+    void move(int64_t distance)
+    {
+        int32_t step = normalize(distance);
+        if (step == 0) {
+            return;
+        }
+        emit({0x49, 0x81, 0xC4});       // add r12, imm32
+        emit32(step);
+        if (!wrap_) {
+            return;
+        }
+        emit({0x4D, 0x39, 0xEC});       // cmp r12, r13
+        emit({0x72, 0x03});             // jb +3
+        emit({0x4D, 0x29, 0xEC});       // sub r12, r13
+    }
+
+    void add_cell(int32_t offset, uint8_t value)
+    {
+        if (offset == 0) {
+            emit({0x42, 0x80, 0x04, 0x23, value});  // add byte [rbx + r12], imm8
+        } else {
+            load_wrapped_index(offset);
+            emit({0x80, 0x04, 0x03, value});        // add byte [rbx + rax], imm8
+        }
+    }
+
+    void set_cell(int32_t offset, uint8_t value)
+    {
+        if (offset == 0) {
+            emit({0x42, 0xC6, 0x04, 0x23, value});  // mov byte [rbx + r12], imm8
+        } else {
+            load_wrapped_index(offset);
+            emit({0xC6, 0x04, 0x03, value});        // mov byte [rbx + rax], imm8
+        }
+    }
+
+    void multiply_add(int32_t offset, int32_t factor)
+    {
+        emit({0x42, 0x0F, 0xB6, 0x0C, 0x23});       // movzx ecx, byte [rbx + r12]
+        emit({0x69, 0xC9});                         // imul ecx, ecx, imm32
+        emit32(factor);
+        load_wrapped_index(offset);
+        emit({0x00, 0x0C, 0x03});                   // add byte [rbx + rax], cl
+    }
+
+    void compare_cell_to_zero()
+    {
+        emit({0x42, 0x80, 0x3C, 0x23, 0x00});       // cmp byte [rbx + r12], 0
+    }
+
+    size_t jump_if_zero()
+    {
+        emit({0x0F, 0x84});                         // je rel32
+        return emit32(0);
+    }
+
+    size_t jump_if_not_zero()
+    {
+        emit({0x0F, 0x85});                         // jne rel32
+        return emit32(0);
+    }
+
+    size_t jump()
+    {
+        emit({0xE9});                               // jmp rel32
+        return emit32(0);
+    }
+
+    void patch(size_t displacement_at, size_t target)
+    {
+        int64_t relative = static_cast<int64_t>(target) - static_cast<int64_t>(displacement_at + 4);
+        uint32_t value = static_cast<uint32_t>(static_cast<int32_t>(relative));
+        for (size_t i = 0; i < 4; ++i) {
+            bytes_[displacement_at + i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void output(int32_t count)
+    {
+        emit({0x49, 0x8B, 0x3E});                   // mov rdi, [r14]          - io->context
+        emit({0x42, 0x0F, 0xB6, 0x34, 0x23});       // movzx esi, byte [rbx + r12]
+        if (count > 1) {
+            emit({0xBA});                           // mov edx, count
+            emit32(count);
+            emit({0x41, 0xFF, 0x56, 0x18});         // call [r14 + 24]         - io->output_repeat
+        } else {
+            emit({0x41, 0xFF, 0x56, 0x08});         // call [r14 + 8]          - io->output
+        }
+    }
+
+    void input()
+    {
+        emit({0x49, 0x8B, 0x3E});                   // mov rdi, [r14]          - io->context
+        emit({0x41, 0xFF, 0x56, 0x10});             // call [r14 + 16]         - io->input
+        emit({0x42, 0x88, 0x04, 0x23});             // mov byte [rbx + r12], al
+    }
+
+private:
+    void emit(std::initializer_list<uint8_t> bytes)
+    {
+        bytes_.insert(bytes_.end(), bytes.begin(), bytes.end());
+    }
+
+    size_t emit32(int32_t value)
+    {
+        size_t at = bytes_.size();
+        uint32_t bits = static_cast<uint32_t>(value);
+        for (size_t i = 0; i < 4; ++i) {
+            bytes_.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+        }
+        return at;
+    }
+
+    // rax = (r12 + offset) wrapped around the tape
+    void load_wrapped_index(int32_t offset)
+    {
+        emit({0x4C, 0x89, 0xE0});                   // mov rax, r12
+        emit({0x48, 0x05});                         // add rax, imm32
+        emit32(normalize(offset));
+        if (!wrap_) {
+            return;
+        }
+        emit({0x4C, 0x39, 0xE8});                   // cmp rax, r13
+        emit({0x72, 0x03});                         // jb +3
+        emit({0x4C, 0x29, 0xE8});                   // sub rax, r13
+    }
+
+    // maps a signed distance onto [0, tape size) so a single subtraction wraps it
+    int32_t normalize(int64_t distance) const
+    {
+        if (!wrap_) {
+            return static_cast<int32_t>(distance);
+        }
+        return static_cast<int32_t>(((distance % tape_size_) + tape_size_) % tape_size_);
+    }
+
+private:
+    int64_t tape_size_;
+    bool wrap_;
+    std::vector<uint8_t> bytes_;
+};
+
+} // namespace
+
+std::vector<uint8_t> X86Jit::assemble(Code const& code, size_t tape_size, Boundary boundary)
+{
+    const bool wrap = boundary == Boundary::Wrap;
+    if (wrap && (tape_size == 0 || tape_size > static_cast<size_t>(INT32_MAX))) {
+        throw JitException("unsupported tape size");
+    }
+
+    struct OpenLoop {
+        size_t body;        // address of the first body instruction
+        size_t exit_patch;  // displacement of the forward 'je'
+    };
+
+    Assembler as{tape_size, wrap};
+    std::stack<OpenLoop> loops;
+    as.prologue();
+
+    for (Instruction const& in : code) {
+        if (in.op == OpCode::HALT) {
+            break;
+        }
+        switch (in.op) {
+            case OpCode::MoveRight: as.move(1); break;
+            case OpCode::MoveLeft: as.move(-1); break;
+            case OpCode::Increment: as.add_cell(0, 1); break;
+            case OpCode::Decrement: as.add_cell(0, 0xFF); break;
+            case OpCode::Output: as.output(in.arg); break;
+            case OpCode::Input: as.input(); break;
+            case OpCode::Add: as.add_cell(in.offset, static_cast<uint8_t>(in.arg)); break;
+            case OpCode::Move: as.move(in.arg); break;
+            case OpCode::SetZero: as.set_cell(in.offset, 0); break;
+            case OpCode::MultiplyAdd: as.multiply_add(in.offset, in.arg); break;
+
+            case OpCode::LoopStart: {
+                as.compare_cell_to_zero();
+                size_t exit_patch = as.jump_if_zero();
+                loops.push(OpenLoop{as.size(), exit_patch});
+                break;
+            }
+            case OpCode::LoopEnd: {
+                if (loops.empty()) {
+                    throw JitException("unmatched loop end");
+                }
+                OpenLoop loop = loops.top();
+                loops.pop();
+                as.compare_cell_to_zero();
+                as.patch(as.jump_if_not_zero(), loop.body);
+                as.patch(loop.exit_patch, as.size());
+                break;
+            }
+
+            case OpCode::ScanLeft:
+            case OpCode::ScanRight: {
+                size_t top = as.size();
+                as.compare_cell_to_zero();
+                size_t exit_patch = as.jump_if_zero();
+                as.move(in.op == OpCode::ScanRight ? in.arg : -static_cast<int64_t>(in.arg));
+                as.patch(as.jump(), top);
+                as.patch(exit_patch, as.size());
+                break;
+            }
+
+            default:
+                throw JitException("unsupported instruction");
+        }
+    }
+    if (!loops.empty()) {
+        throw JitException("unmatched loop start");
+    }
+
+    as.epilogue();
+    return as.take();
+}
+
+} // namespace bf
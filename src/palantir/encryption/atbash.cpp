@@ -1,21 +1,16 @@
 #include "palantir/encryption/atbash.hpp"
+#include "palantir/encryption/cipher_kernels.hpp"
 
 namespace palantir {
 
-char Atbash::encode(char c) 
+void Atbash::encode_into(std::string_view in, char* out)
 {
-    if (isalpha(c)) {
-        if (isupper(c)) {
-            return 'Z' - (c - 'A');
-        } 
-        return 'z' - (c - 'a');
-    }
-    return c;
+    kernels::atbash(in, out);
 }
 
-char Atbash::decode(char c) 
+void Atbash::decode_into(std::string_view in, char* out)
 {
-    return encode(c);
+    kernels::atbash(in, out);
 }
 
 }       // namespace palantir
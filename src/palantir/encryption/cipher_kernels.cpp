@@ -0,0 +1,426 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "palantir/encryption/cipher_kernels.hpp"
+
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define PALANTIR_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace palantir::kernels {
+
+namespace {
+
+// Scalar kernels, also used for the tails the vector loops leave
+
+// index of the letter within its case, 26 or more for any other byte
+unsigned letter_index(unsigned char c)
+{
+    return static_cast<unsigned char>((c | 0x20) - 'a');
+}
+
+char shift_letter(char c, unsigned shift)
+{
+    unsigned char u = static_cast<unsigned char>(c);
+    unsigned index = letter_index(u);
+    if (index >= 26) {
+        return c;
+    }
+    return static_cast<char>(u + shift - (index + shift >= 26 ? 26 : 0));
+}
+
+void xor_scalar(const char* in, char* out, std::size_t size, const char* key, std::size_t period, std::size_t phase)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<char>(in[i] ^ key[phase]);
+        phase = (phase + 1 == period) ? 0 : phase + 1;
+    }
+}
+
+void rotate_scalar(const char* in, char* out, std::size_t size, unsigned shift)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        out[i] = shift_letter(in[i], shift);
+    }
+}
+
+void atbash_scalar(const char* in, char* out, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        unsigned char u = static_cast<unsigned char>(in[i]);
+        // 'A' + 'Z' == 155 and 'a' + 'z' == 219 == 155 + 2 * 0x20
+        out[i] = letter_index(u) < 26 ? static_cast<char>(155 + 2 * (u & 0x20) - u) : in[i];
+    }
+}
+
+void vigenere_scalar(const char* in, char* out, std::size_t size, const char* shifts, std::size_t period, std::size_t phase)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        char c = in[i];
+        if (letter_index(static_cast<unsigned char>(c)) < 26) {
+            c = shift_letter(c, static_cast<unsigned char>(shifts[phase]));
+            phase = (phase + 1 == period) ? 0 : phase + 1;
+        }
+        out[i] = c;
+    }
+}
+
+// Moves phase forward by step < period within the key period
+std::size_t advance(std::size_t phase, std::size_t step, std::size_t period)
+{
+    phase += step;
+    return phase >= period ? phase - period : phase;
+}
+
+// Letters per vector block are at most 32: the vector Vigenère loops reduce each count modulo
+// the period through this table, instead of dividing once per block
+struct PeriodSteps {
+    explicit PeriodSteps(std::size_t period)
+    : period{period}
+    {
+        for (std::size_t count = 0; count <= 32; ++count) {
+            step[count] = count % period;
+        }
+    }
+
+    std::size_t period;
+    std::size_t step[33];
+};
+
+#ifdef PALANTIR_X86_KERNELS
+
+// Vector kernels: letters are found with one signed compare on (c | 0x20) - 'a', biased by
+// 0x80 so that the unsigned test index < 26 becomes a signed one
+
+__m128i letter_mask(__m128i c, __m128i& index)
+{
+    index = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i biased = _mm_xor_si128(index, _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_cmplt_epi8(biased, _mm_set1_epi8(static_cast<char>(26 - 0x80)));
+}
+
+// shift holds a shift in [0, 26) per byte; bytes that are not letters keep their value
+__m128i shift_letters(__m128i c, __m128i shift)
+{
+    __m128i index;
+    __m128i letter = letter_mask(c, index);
+    __m128i wrap = _mm_cmpgt_epi8(_mm_add_epi8(index, shift), _mm_set1_epi8(25));
+    __m128i delta = _mm_sub_epi8(shift, _mm_and_si128(wrap, _mm_set1_epi8(26)));
+    return _mm_add_epi8(c, _mm_and_si128(letter, delta));
+}
+
+__m128i mirror_letters(__m128i c)
+{
+    __m128i index;
+    __m128i letter = letter_mask(c, index);
+    __m128i lower = _mm_and_si128(c, _mm_set1_epi8(0x20));
+    __m128i base = _mm_add_epi8(_mm_set1_epi8(static_cast<char>(155)), _mm_add_epi8(lower, lower));
+    __m128i mirrored = _mm_sub_epi8(base, c);
+    return _mm_or_si128(_mm_and_si128(letter, mirrored), _mm_andnot_si128(letter, c));
+}
+
+std::size_t xor_sse2(const char* in, char* out, std::size_t size, const char* key, std::size_t period, std::size_t& phase)
+{
+    std::size_t step = 16 % period;
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + phase));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(c, k));
+        phase = advance(phase, step, period);
+    }
+    return i;
+}
+
+std::size_t rotate_sse2(const char* in, char* out, std::size_t size, unsigned shift)
+{
+    __m128i s = _mm_set1_epi8(static_cast<char>(shift));
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), shift_letters(c, s));
+    }
+    return i;
+}
+
+std::size_t atbash_sse2(const char* in, char* out, std::size_t size)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), mirror_letters(c));
+    }
+    return i;
+}
+
+// Exclusive prefix count of the letters before each byte of its 16-byte lane
+__attribute__((target("ssse3")))
+__m128i letters_before(__m128i letter)
+{
+    __m128i ones = _mm_and_si128(letter, _mm_set1_epi8(1));
+    __m128i sum = _mm_add_epi8(ones, _mm_slli_si128(ones, 1));
+    sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 2));
+    sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 4));
+    sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 8));
+    return _mm_sub_epi8(sum, ones);
+}
+
+// Each block takes its key shifts from the padded table at the current phase; byte i reads the
+// entry for the letters before it, so a single shuffle skips the key over non-letters
+__attribute__((target("ssse3")))
+std::size_t vigenere_ssse3(const char* in, char* out, std::size_t size, const char* shifts, PeriodSteps const& steps, std::size_t& phase)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i index;
+        __m128i letter = letter_mask(c, index);
+        __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shifts + phase));
+        __m128i shift = _mm_shuffle_epi8(key, letters_before(letter));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), shift_letters(c, shift));
+        phase = advance(phase, steps.step[__builtin_popcount(_mm_movemask_epi8(letter))], steps.period);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+__m256i letter_mask(__m256i c, __m256i& index)
+{
+    index = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i biased = _mm256_xor_si256(index, _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(26 - 0x80)), biased);
+}
+
+__attribute__((target("avx2")))
+__m256i shift_letters(__m256i c, __m256i shift)
+{
+    __m256i index;
+    __m256i letter = letter_mask(c, index);
+    __m256i wrap = _mm256_cmpgt_epi8(_mm256_add_epi8(index, shift), _mm256_set1_epi8(25));
+    __m256i delta = _mm256_sub_epi8(shift, _mm256_and_si256(wrap, _mm256_set1_epi8(26)));
+    return _mm256_add_epi8(c, _mm256_and_si256(letter, delta));
+}
+
+__attribute__((target("avx2")))
+std::size_t xor_avx2(const char* in, char* out, std::size_t size, const char* key, std::size_t period, std::size_t& phase)
+{
+    std::size_t step = 32 % period;
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + phase));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(c, k));
+        phase = advance(phase, step, period);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+std::size_t rotate_avx2(const char* in, char* out, std::size_t size, unsigned shift)
+{
+    __m256i s = _mm256_set1_epi8(static_cast<char>(shift));
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), shift_letters(c, s));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+std::size_t atbash_avx2(const char* in, char* out, std::size_t size)
+{
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i index;
+        __m256i letter = letter_mask(c, index);
+        __m256i lower = _mm256_and_si256(c, _mm256_set1_epi8(0x20));
+        __m256i base = _mm256_add_epi8(_mm256_set1_epi8(static_cast<char>(155)), _mm256_add_epi8(lower, lower));
+        __m256i mirrored = _mm256_sub_epi8(base, c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_blendv_epi8(c, mirrored, letter));
+    }
+    return i;
+}
+
+// As vigenere_ssse3, with the two 16-byte lanes reading the key at their own phases:
+// byte shifts and shuffles stay within a lane, so the prefix count does too
+__attribute__((target("avx2,popcnt")))
+std::size_t vigenere_avx2(const char* in, char* out, std::size_t size, const char* shifts, PeriodSteps const& steps, std::size_t& phase)
+{
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i index;
+        __m256i letter = letter_mask(c, index);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(letter));
+        std::size_t high_phase = advance(phase, steps.step[__builtin_popcount(mask & 0xFFFF)], steps.period);
+
+        __m256i ones = _mm256_and_si256(letter, _mm256_set1_epi8(1));
+        __m256i sum = _mm256_add_epi8(ones, _mm256_slli_si256(ones, 1));
+        sum = _mm256_add_epi8(sum, _mm256_slli_si256(sum, 2));
+        sum = _mm256_add_epi8(sum, _mm256_slli_si256(sum, 4));
+        sum = _mm256_add_epi8(sum, _mm256_slli_si256(sum, 8));
+        __m256i before = _mm256_sub_epi8(sum, ones);
+
+        __m256i key = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shifts + phase))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(shifts + high_phase)), 1);
+        __m256i shift = _mm256_shuffle_epi8(key, before);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), shift_letters(c, shift));
+        phase = advance(high_phase, steps.step[__builtin_popcount(mask >> 16)], steps.period);
+    }
+    return i;
+}
+
+#endif // PALANTIR_X86_KERNELS
+
+}       // namespace
+
+Isa best_isa() noexcept
+{
+#ifdef PALANTIR_X86_KERNELS
+    static const Isa best = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+            return Isa::AVX2;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            return Isa::SSSE3;
+        }
+        return Isa::SSE2;
+    }();
+    return best;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+std::string pad_key(std::string_view key)
+{
+    std::string padded;
+    if (key.empty()) {
+        return padded;
+    }
+    padded.reserve(key.size() + key_padding);
+    padded.append(key);
+    while (padded.size() < key.size() + key_padding) {
+        padded.push_back(key[(padded.size() - key.size()) % key.size()]);
+    }
+    return padded;
+}
+
+std::string key_shifts(std::string_view key, int direction)
+{
+    std::string shifts(key.size(), '\0');
+    for (std::size_t i = 0; i < key.size(); ++i) {
+        int shift = (direction * (key[i] - 'a')) % 26;
+        shifts[i] = static_cast<char>(shift < 0 ? shift + 26 : shift);
+    }
+    return shifts;
+}
+
+void xor_key(std::string_view in, char* out, std::string_view padded_key, Isa isa)
+{
+    if (padded_key.size() <= key_padding) {
+        if (out != in.data()) {
+            std::copy(in.begin(), in.end(), out);
+        }
+        return;
+    }
+    std::size_t period = padded_key.size() - key_padding;
+    std::size_t phase = 0;
+    std::size_t done = 0;
+#ifdef PALANTIR_X86_KERNELS
+    switch (std::min(isa, best_isa())) {
+    case Isa::AVX2:
+        done = xor_avx2(in.data(), out, in.size(), padded_key.data(), period, phase);
+        break;
+    case Isa::SSSE3:
+    case Isa::SSE2:
+        done = xor_sse2(in.data(), out, in.size(), padded_key.data(), period, phase);
+        break;
+    case Isa::Scalar:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    xor_scalar(in.data() + done, out + done, in.size() - done, padded_key.data(), period, phase);
+}
+
+void rotate(std::string_view in, char* out, int shift, Isa isa)
+{
+    shift %= 26;
+    unsigned s = static_cast<unsigned>(shift < 0 ? shift + 26 : shift);
+    std::size_t done = 0;
+#ifdef PALANTIR_X86_KERNELS
+    switch (std::min(isa, best_isa())) {
+    case Isa::AVX2:
+        done = rotate_avx2(in.data(), out, in.size(), s);
+        break;
+    case Isa::SSSE3:
+    case Isa::SSE2:
+        done = rotate_sse2(in.data(), out, in.size(), s);
+        break;
+    case Isa::Scalar:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    rotate_scalar(in.data() + done, out + done, in.size() - done, s);
+}
+
+void atbash(std::string_view in, char* out, Isa isa)
+{
+    std::size_t done = 0;
+#ifdef PALANTIR_X86_KERNELS
+    switch (std::min(isa, best_isa())) {
+    case Isa::AVX2:
+        done = atbash_avx2(in.data(), out, in.size());
+        break;
+    case Isa::SSSE3:
+    case Isa::SSE2:
+        done = atbash_sse2(in.data(), out, in.size());
+        break;
+    case Isa::Scalar:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    atbash_scalar(in.data() + done, out + done, in.size() - done);
+}
+
+void vigenere(std::string_view in, char* out, std::string_view padded_shifts, Isa isa)
+{
+    if (padded_shifts.size() <= key_padding) {
+        if (out != in.data()) {
+            std::copy(in.begin(), in.end(), out);
+        }
+        return;
+    }
+    std::size_t period = padded_shifts.size() - key_padding;
+    std::size_t phase = 0;
+    std::size_t done = 0;
+#ifdef PALANTIR_X86_KERNELS
+    switch (std::min(isa, best_isa())) {
+    case Isa::AVX2:
+        done = vigenere_avx2(in.data(), out, in.size(), padded_shifts.data(), PeriodSteps{period}, phase);
+        break;
+    case Isa::SSSE3:
+        done = vigenere_ssse3(in.data(), out, in.size(), padded_shifts.data(), PeriodSteps{period}, phase);
+        break;
+    case Isa::SSE2:
+    case Isa::Scalar:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    vigenere_scalar(in.data() + done, out + done, in.size() - done, padded_shifts.data(), period, phase);
+}
+
+}       //  namespace palantir::kernels
@@ -0,0 +1,29 @@
+#include "palantir/encryption/encryption_abstract.hpp"
+
+namespace palantir {
+
+std::string EncryptionAbstract::encode(std::string const& buffer)
+{
+    std::string encoded(buffer.size(), '\0');
+    encode_into(buffer, encoded.data());
+    return encoded;
+}
+
+std::string EncryptionAbstract::decode(std::string const& buffer)
+{
+    std::string decoded(buffer.size(), '\0');
+    decode_into(buffer, decoded.data());
+    return decoded;
+}
+
+void EncryptionAbstract::encode_inplace(char* data, std::size_t size)
+{
+    encode_into(std::string_view{data, size}, data);
+}
+
+void EncryptionAbstract::decode_inplace(char* data, std::size_t size)
+{
+    decode_into(std::string_view{data, size}, data);
+}
+
+}       //  namespace palantir
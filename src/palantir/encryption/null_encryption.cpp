@@ -1,15 +1,19 @@
+#include <algorithm>
+
 #include "palantir/encryption/null_encryption.hpp"
 
 namespace palantir {
     
-char NullEncryption::encode(char c) 
+void NullEncryption::encode_into(std::string_view in, char* out)
 {
-    return c;
+    if (out != in.data()) {
+        std::copy(in.begin(), in.end(), out);
+    }
 }
 
-char NullEncryption::decode(char c) 
+void NullEncryption::decode_into(std::string_view in, char* out)
 {
-    return c;
+    encode_into(in, out);
 }
 
 }       // namespace palantir
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include <string>
-#include <cctype>  // For isalpha(), isupper()
 
 #include "palantir/encryption/rotate.hpp"
+#include "palantir/encryption/cipher_kernels.hpp"
 
 namespace palantir {
 
@@ -10,20 +10,14 @@ RotateCharEncryptor::RotateCharEncryptor(int shift)
 {
 }
 
-std::string RotateCharEncryptor::encode(std::string const& buffer) {
-    std::string decoded;
-    for (char c : buffer) {
-        decoded.push_back(shift_element(c, shift_));
-    }
-    return decoded;
+void RotateCharEncryptor::encode_into(std::string_view in, char* out)
+{
+    kernels::rotate(in, out, shift_);
 }
 
-std::string RotateCharEncryptor::decode(std::string const& buffer) {
-    std::string decoded;
-    for (char c : buffer) {
-        decoded.push_back(shift_element(c, -shift_));
-    }
-    return decoded;
+void RotateCharEncryptor::decode_into(std::string_view in, char* out)
+{
+    kernels::rotate(in, out, -shift_);
 }
 
 // void RotateCharEncryptor::set_shift(int shift)
@@ -31,13 +25,4 @@ std::string RotateCharEncryptor::decode(std::string const& buffer) {
 //     shift_ = shift;
 // }
 
-char RotateCharEncryptor::shift_element(const char c, int shift) 
-{
-    if (std::isalpha(c)) {
-        char base = std::isupper(c) ? 'A' : 'a';
-        return (base + (c - base + shift + 26) % 26);
-    } 
-    return c;
-}
-
 }
@@ -4,6 +4,7 @@
 #include <algorithm> // For std::transform
 
 #include "palantir/encryption/vigenere.hpp"
+#include "palantir/encryption/cipher_kernels.hpp"
 
 namespace palantir {
 
@@ -14,29 +15,19 @@ Vigenere::Vigenere(std::string key)
     std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
     return lower;
 }())
+, encode_shifts_{kernels::pad_key(kernels::key_shifts(this->key(), 1))}
+, decode_shifts_{kernels::pad_key(kernels::key_shifts(this->key(), -1))}
 {
 }
 
-char Vigenere::encode(char c) 
+void Vigenere::encode_into(std::string_view in, char* out)
 {
-    if (std::isalpha(c)) {
-        int key_shift = get_key_char_and_inc_index() - 'a';
-        char base = std::isupper(c) ? 'A' : 'a';
-        //++key_index_;
-        return base + (c - base + key_shift + 26) % 26;
-    }
-    return c;
+    kernels::vigenere(in, out, encode_shifts_);
 }
 
-char Vigenere::decode(char c) 
+void Vigenere::decode_into(std::string_view in, char* out)
 {
-    if (std::isalpha(c)) {
-        int key_shift = -(get_key_char_and_inc_index() - 'a'); //key_[key_index_ % key_.size()]
-        char base = std::isupper(c) ? 'A' : 'a';
-        //++key_index_;
-        return base + (26 + c - base + key_shift) % 26;
-    }
-    return c;
+    kernels::vigenere(in, out, decode_shifts_);
 }
 
 }       // namespace palantir
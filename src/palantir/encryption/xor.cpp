@@ -1,21 +1,23 @@
 #include "palantir/encryption/xor.hpp"
+#include "palantir/encryption/cipher_kernels.hpp"
 
 namespace palantir {
 
 XorEncryptor::XorEncryptor(std::string key)
 //: key_{key}
 : KeyBaseEncryptor(key)
+, padded_key_{kernels::pad_key(this->key())}
 {
 }
 
-char XorEncryptor::encode(char c) 
+void XorEncryptor::encode_into(std::string_view in, char* out)
 {
-    return c ^ get_key_char_and_inc_index();
+    kernels::xor_key(in, out, padded_key_);
 }
 
-char XorEncryptor::decode(char c) 
+void XorEncryptor::decode_into(std::string_view in, char* out)
 {
-    return c ^ get_key_char_and_inc_index();
+    encode_into(in, out);
 }
 
 }  // namespace palantir
@@ -30,9 +30,9 @@ void Messenger::process(MessageSourceAbstract& src, MessageDestinationAbstract&
         try {
             std::string message = src.get_message();  // Receive message
 
-            // Apply all encryptions
+            // Apply all encryptions in place, one virtual call per layer
             for (EncryptionAbstract* encryption : encryptions_) {
-                message = encryption->encode(message);
+                encryption->encode_inplace(message.data(), message.size());
             }
 
             des.send_message(message);  // Send message
@@ -1,15 +1,27 @@
 #include <iostream>
 #include <vector>
+#include <chrono>
 
 #include "mu_test.h"
 #include "bf/compiler.hpp"
 #include "bf/console.hpp"
 #include "bf/vm.hpp"
+#include "bf/threaded_vm.hpp"
+#include "bf/jit_vm.hpp"
 #include "bf/operations.hpp"
 #include "bf/mem_arg_types.hpp"
 //#define BF_DEBUG
 #include "bf/memory.hpp"
+#include "bf/source_file.hpp"
+#include "bf/analyzer.hpp"
+#include "bf/engine.hpp"
+#include "bf/bf_exceptions.hpp"
+#include <fstream>
 #include <stack>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <signal.h>
 
 bf::OpCode translate(char c) 
 {
@@ -109,8 +121,7 @@ BEGIN_TEST(test_program_jump_forward_and_backward)
         bf::OpCode::LoopEnd,   // 2
         bf::OpCode::Decrement  // 3
     };
-    std::unordered_map<size_t, size_t> jump_table = {{0, 2}, {2, 0}};
-    bf::Program program(code, jump_table);
+    bf::Program program(code);
 
     program.jump_forward_to_matching_end();
     ASSERT_EQUAL(static_cast<int>(program.fetch_current()), static_cast<int>(bf::OpCode::LoopEnd)); // Check if jumped to LoopEnd
@@ -127,6 +138,11 @@ BEGIN_TEST(test_program_is_done)
     program.fetch_next();
     program.fetch_next();
     ASSERT_THAT(program.is_done());
+
+    bf::Program jumped = bf::Compiler{}.compile_optimized("+[->+<]>.");
+    ASSERT_THAT(!jumped.is_done());
+    jumped.finish();
+    ASSERT_THAT(jumped.is_done());
 END_TEST
 
 /*-------------------------------------------------------------------------------------------------*/
@@ -136,10 +152,10 @@ BEGIN_TEST(test_jump_table_construction)
     std::string program_source = "[->+<]";
     bf::Program compiled_program = compiler.compile(program_source);
     
-    const std::unordered_map<size_t, size_t>& jump_table = compiled_program.get_jump_table(); // Assume get_jump_table() exposes this data
+    const bf::Code& instructions = compiled_program.get_instructions(); // jump targets are stored inline
     
-    ASSERT_EQUAL(jump_table.at(0), 5);  // Start of loop '[' at index 0 jumps to ']' at index 5
-    ASSERT_EQUAL(jump_table.at(5), 0);  // End of loop ']' at index 5 jumps back to '[' at index 0
+    ASSERT_EQUAL(instructions[0].arg, 5);  // Start of loop '[' at index 0 jumps to ']' at index 5
+    ASSERT_EQUAL(instructions[5].arg, 0);  // End of loop ']' at index 5 jumps back to '[' at index 0
 END_TEST
 
 BEGIN_TEST(test_opcode_vector_construction)
@@ -147,15 +163,34 @@ BEGIN_TEST(test_opcode_vector_construction)
     std::string program_source = "[->+<]";
     bf::Program compiled_program = compiler.compile(program_source);
     
-    const std::vector<bf::OpCode>& opcodes = compiled_program.get_instructions();
+    const bf::Code& opcodes = compiled_program.get_instructions();
     
-    ASSERT_EQUAL(static_cast<int>(opcodes[0]), static_cast<int>(bf::OpCode::LoopStart));
-    ASSERT_EQUAL(static_cast<int>(opcodes[1]), static_cast<int>(bf::OpCode::Decrement));
-    ASSERT_EQUAL(static_cast<int>(opcodes[2]), static_cast<int>(bf::OpCode::MoveRight));
-    ASSERT_EQUAL(static_cast<int>(opcodes[3]), static_cast<int>(bf::OpCode::Increment));
-    ASSERT_EQUAL(static_cast<int>(opcodes[4]), static_cast<int>(bf::OpCode::MoveLeft));
-    ASSERT_EQUAL(static_cast<int>(opcodes[5]), static_cast<int>(bf::OpCode::LoopEnd));
-    ASSERT_EQUAL(static_cast<int>(opcodes[6]), static_cast<int>(bf::OpCode::HALT));  // Ensure HALT is added
+    ASSERT_EQUAL(static_cast<int>(opcodes[0].op), static_cast<int>(bf::OpCode::LoopStart));
+    ASSERT_EQUAL(static_cast<int>(opcodes[1].op), static_cast<int>(bf::OpCode::Decrement));
+    ASSERT_EQUAL(static_cast<int>(opcodes[2].op), static_cast<int>(bf::OpCode::MoveRight));
+    ASSERT_EQUAL(static_cast<int>(opcodes[3].op), static_cast<int>(bf::OpCode::Increment));
+    ASSERT_EQUAL(static_cast<int>(opcodes[4].op), static_cast<int>(bf::OpCode::MoveLeft));
+    ASSERT_EQUAL(static_cast<int>(opcodes[5].op), static_cast<int>(bf::OpCode::LoopEnd));
+    ASSERT_EQUAL(static_cast<int>(opcodes[6].op), static_cast<int>(bf::OpCode::HALT));  // Ensure HALT is added
+END_TEST
+
+BEGIN_TEST(test_nested_jump_targets)
+    bf::Compiler compiler;
+    bf::Program compiled_program = compiler.compile("+[>[-]<-]");
+    const bf::Code& instructions = compiled_program.get_instructions();
+
+    ASSERT_EQUAL(instructions[1].arg, 8);
+    ASSERT_EQUAL(instructions[8].arg, 1);
+    ASSERT_EQUAL(instructions[3].arg, 5);
+    ASSERT_EQUAL(instructions[5].arg, 3);
+END_TEST
+
+BEGIN_TEST(test_unmatched_brackets_compile_to_halt)
+    bf::Compiler compiler;
+    bf::Program compiled_program = compiler.compile("+[->+<");
+
+    ASSERT_EQUAL(compiled_program.get_instructions().size(), 1);
+    ASSERT_THAT(compiled_program.is_done());
 END_TEST
 
 BEGIN_TEST(test_bracket_validation)
@@ -244,6 +279,778 @@ BEGIN_TEST(test_echo_program)
     ASSERT_EQUAL(os.str(), "x");
 END_TEST
 
+/*-------------------------------------------------------------------------------------------------*/
+
+std::string run_source(const std::string& bf_source, bool optimize, const std::string& input = "")
+{
+    bf::Compiler compiler{};
+    bf::Program program = optimize ? compiler.compile_optimized(bf_source) : compiler.compile(bf_source);
+
+    std::ostringstream os;
+    std::istringstream is(input);
+
+    bf::Console console{os, is};
+    bf::Memory tape{};
+    bf::VM vm{tape, program, console};
+
+    vm.run();
+    return os.str();
+}
+
+std::string run_threaded(const std::string& bf_source, bool optimize, const std::string& input = "")
+{
+    bf::Compiler compiler{};
+    bf::Program program = optimize ? compiler.compile_optimized(bf_source) : compiler.compile(bf_source);
+
+    std::ostringstream os;
+    std::istringstream is(input);
+
+    bf::Console console{os, is};
+    bf::Memory tape{};
+    bf::ThreadedVM vm{tape, program, console};
+
+    vm.run();
+    return os.str();
+}
+
+struct RunResult {
+    std::string output;
+    std::vector<int> cells;
+    bf::Index position;
+};
+
+RunResult run_jit(const std::string& bf_source, bool optimize, bf::JitMode mode, const std::string& input = "")
+{
+    bf::Compiler compiler{};
+    bf::Program program = optimize ? compiler.compile_optimized(bf_source) : compiler.compile(bf_source);
+
+    std::ostringstream os;
+    std::istringstream is(input);
+
+    bf::Console console{os, is};
+    bf::Memory tape{};
+    bf::JitVM vm{tape, program, console, mode};
+    vm.run();
+
+    RunResult result{os.str(), {}, tape.position()};
+    for (bf::Index i = 0; i < 8; ++i) {
+        result.cells.push_back(tape[i]);
+    }
+    result.cells.push_back(tape[29999]);
+    return result;
+}
+
+RunResult run_reference(const std::string& bf_source, const std::string& input = "")
+{
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile(bf_source);
+
+    std::ostringstream os;
+    std::istringstream is(input);
+
+    bf::Console console{os, is};
+    bf::Memory tape{};
+    bf::VM vm{tape, program, console};
+    vm.run();
+
+    RunResult result{os.str(), {}, tape.position()};
+    for (bf::Index i = 0; i < 8; ++i) {
+        result.cells.push_back(tape[i]);
+    }
+    result.cells.push_back(tape[29999]);
+    return result;
+}
+
+RunResult run_analyzed(const std::string& bf_source, const std::string& input = "")
+{
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile_analyzed(bf_source);
+
+    std::ostringstream os;
+    std::istringstream is(input);
+
+    bf::Console console{os, is};
+    bf::Memory tape{};
+    bf::ThreadedVM vm{tape, program, console};
+    vm.run();
+
+    RunResult result{os.str(), {}, tape.position()};
+    for (bf::Index i = 0; i < 8; ++i) {
+        result.cells.push_back(tape[i]);
+    }
+    result.cells.push_back(tape[29999]);
+    return result;
+}
+
+bool has_loops(bf::Code const& code)
+{
+    for (bf::Instruction const& in : code) {
+        if (in.op == bf::OpCode::LoopStart) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<std::pair<std::string, std::string>> differential_cases = {
+    {"+++", ""},
+    {std::string(68, '+'), ""},
+    {",.++", "x"},
+    {"++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++.", ""},
+    {"+++++[->++>---<<]<++[>+<-]", ""},
+    {"<<+++[->++<]", ""},
+    {",[->+>+<<]>>[-<<+>>]<[->++++<]>[-<+>]<.>+[->-[>+<-]>[-<+<+>>]<<]>>.<<+[>+<+]>.", "A"},
+    {"+[>+]<[-<]++++++[>++++++++<-]>.", ""},
+    {"++++++[>+++++++<-]>..........,...", "z"},
+};
+
+bool same_result(RunResult const& a, RunResult const& b)
+{
+    return a.output == b.output && a.cells == b.cells && a.position == b.position;
+}
+
+BEGIN_TEST(test_compile_from_mapped_source_file)
+    std::string body = "Hello program: ++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++.\n";
+    std::string text;
+    for (int i = 0; i < 1000; ++i) {
+        text += "[ comment block ]\n";    // skipped loops, they never run
+    }
+    text += body;
+    std::string path = "/tmp/bf_utest_source.bf";
+    {
+        std::ofstream file(path);
+        file << text;
+    }
+
+    bf::SourceFile source{path};
+    ASSERT_EQUAL(source.size(), text.size());
+    ASSERT_THAT(source.view() == text);
+
+    bf::Compiler compiler{};
+    bf::Program mapped = compiler.compile(source.view());
+    bf::Program copied = compiler.compile(text);
+    ASSERT_EQUAL(mapped.get_instructions().size(), copied.get_instructions().size());
+    ASSERT_EQUAL(mapped.get_instructions().size(), 2000 + 106 + 1);
+    ASSERT_EQUAL(run_source(std::string(source.view()), true), "Hello World!\n");
+
+    std::ofstream{path, std::ios::trunc};
+    bf::SourceFile empty{path};
+    ASSERT_EQUAL(empty.size(), 0);
+    ASSERT_EQUAL(compiler.compile(empty.view()).get_instructions().size(), 1);
+    unlink(path.c_str());
+
+    bool thrown = false;
+    try {
+        bf::SourceFile missing{path};
+    } catch (bf::SourceException const&) {
+        thrown = true;
+    }
+    ASSERT_THAT(thrown);
+END_TEST
+
+BEGIN_TEST(test_source_file_reads_pipes)
+    // A pipe reports no size, as with <(...) or /dev/stdin: it must be read, not mapped
+    std::string program = "++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++.";
+    int fds[2];
+    ASSERT_EQUAL(pipe(fds), 0);
+    ASSERT_EQUAL(write(fds[1], program.data(), program.size()), static_cast<ssize_t>(program.size()));
+    close(fds[1]);
+
+    bf::SourceFile source{"/dev/fd/" + std::to_string(fds[0])};
+    close(fds[0]);
+    ASSERT_EQUAL(source.size(), program.size());
+    ASSERT_THAT(source.view() == program);
+    ASSERT_EQUAL(run_source(std::string(source.view()), true), "Hello World!\n");
+END_TEST
+
+BEGIN_TEST(test_optimizer_folds_runs)
+    bf::Code code = bf::Program::to_code({
+        bf::OpCode::Increment, bf::OpCode::Increment, bf::OpCode::Increment,
+        bf::OpCode::MoveRight, bf::OpCode::MoveRight, bf::OpCode::MoveLeft,
+        bf::OpCode::Decrement, bf::OpCode::Increment
+    });
+    bf::Code folded = bf::Optimizer::fold_runs(code);
+
+    ASSERT_EQUAL(folded.size(), 2);
+    ASSERT_EQUAL(static_cast<int>(folded[0].op), static_cast<int>(bf::OpCode::Add));
+    ASSERT_EQUAL(folded[0].arg, 3);
+    ASSERT_EQUAL(static_cast<int>(folded[1].op), static_cast<int>(bf::OpCode::Move));
+    ASSERT_EQUAL(folded[1].arg, 1);
+END_TEST
+
+BEGIN_TEST(test_optimizer_lowers_clear_and_scan_loops)
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile_optimized("+[-]>[<]");
+    const bf::Code& code = program.get_instructions();
+
+    ASSERT_EQUAL(code.size(), 5);
+    ASSERT_EQUAL(static_cast<int>(code[0].op), static_cast<int>(bf::OpCode::Add));
+    ASSERT_EQUAL(static_cast<int>(code[1].op), static_cast<int>(bf::OpCode::SetZero));
+    ASSERT_EQUAL(static_cast<int>(code[2].op), static_cast<int>(bf::OpCode::Move));
+    ASSERT_EQUAL(static_cast<int>(code[3].op), static_cast<int>(bf::OpCode::ScanLeft));
+    ASSERT_EQUAL(code[3].arg, 1);
+    ASSERT_EQUAL(static_cast<int>(code[4].op), static_cast<int>(bf::OpCode::HALT));
+END_TEST
+
+BEGIN_TEST(test_optimizer_lowers_multiply_loops)
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile_optimized("[->+>+++<<]");
+    const bf::Code& code = program.get_instructions();
+
+    ASSERT_EQUAL(code.size(), 4);
+    ASSERT_EQUAL(static_cast<int>(code[0].op), static_cast<int>(bf::OpCode::MultiplyAdd));
+    ASSERT_EQUAL(code[0].offset, 1);
+    ASSERT_EQUAL(code[0].arg, 1);
+    ASSERT_EQUAL(static_cast<int>(code[1].op), static_cast<int>(bf::OpCode::MultiplyAdd));
+    ASSERT_EQUAL(code[1].offset, 2);
+    ASSERT_EQUAL(code[1].arg, 3);
+    ASSERT_EQUAL(static_cast<int>(code[2].op), static_cast<int>(bf::OpCode::SetZero));
+END_TEST
+
+BEGIN_TEST(test_optimized_multiply_execution)
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile_optimized("+++++[->++>---<<]<++[>+<-]");
+
+    std::ostringstream os;
+    std::istringstream is("");
+    bf::Console console{os, is};
+    bf::Memory tape{};
+    bf::VM vm{tape, program, console};
+    vm.run();
+
+    ASSERT_EQUAL(tape[0], 2);
+    ASSERT_EQUAL(tape[1], 10);
+    ASSERT_EQUAL(tape[2], 256 - 15);
+    ASSERT_EQUAL(tape[29999], 0);
+END_TEST
+
+BEGIN_TEST(test_optimized_hello_world)
+    std::string bf_source = "++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++.";
+    ASSERT_EQUAL(run_source(bf_source, true), "Hello World!\n");
+END_TEST
+
+BEGIN_TEST(test_optimized_matches_plain)
+    // nested loops, copy loops with wrap-around counters and input
+    std::string bf_source = ",[->+>+<<]>>[-<<+>>]<[->++++<]>[-<+>]<.>+[->-[>+<-]>[-<+<+>>]<<]>>.<<+[>+<+]>.";
+    ASSERT_EQUAL(run_source(bf_source, true, "A"), run_source(bf_source, false, "A"));
+END_TEST
+
+BEGIN_TEST(test_multiply_loops_lowered_from_offset_form)
+    bf::Compiler compiler{};
+    bf::Code plain = bf::Optimizer::fold_runs(bf::Program::to_code(compiler.parse("[->+>+++<<]")));
+    bf::Code offset_form = bf::Optimizer::fold_offsets(plain);
+
+    // LoopStart, the counter Add, two Adds at offsets 1 and 2, LoopEnd and HALT: no Move left
+    ASSERT_EQUAL(offset_form.size(), 6);
+    for (bf::Instruction const& in : offset_form) {
+        ASSERT_THAT(in.op != bf::OpCode::Move);
+    }
+
+    bf::Code lowered = bf::Optimizer::lower_multiply_loops(offset_form);
+    ASSERT_EQUAL(lowered.size(), 4);
+    ASSERT_EQUAL(static_cast<int>(lowered[0].op), static_cast<int>(bf::OpCode::MultiplyAdd));
+    ASSERT_EQUAL(lowered[0].offset, 1);
+    ASSERT_EQUAL(lowered[0].arg, 1);
+    ASSERT_EQUAL(lowered[1].offset, 2);
+    ASSERT_EQUAL(lowered[1].arg, 3);
+    ASSERT_EQUAL(static_cast<int>(lowered[2].op), static_cast<int>(bf::OpCode::SetZero));
+END_TEST
+
+BEGIN_TEST(test_optimizer_folds_offsets)
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile_optimized(">+>++<<.");
+    const bf::Code& code = program.get_instructions();
+
+    ASSERT_EQUAL(code.size(), 4);
+    ASSERT_EQUAL(static_cast<int>(code[0].op), static_cast<int>(bf::OpCode::Add));
+    ASSERT_EQUAL(code[0].offset, 1);
+    ASSERT_EQUAL(code[1].arg, 2);
+    ASSERT_EQUAL(code[1].offset, 2);
+    ASSERT_EQUAL(static_cast<int>(code[2].op), static_cast<int>(bf::OpCode::Output));
+END_TEST
+
+BEGIN_TEST(test_analysis_evaluates_constant_prefix)
+    bf::Compiler compiler{};
+    std::string hello = "++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++.";
+    bf::Program program = compiler.compile_analyzed(hello);
+    ASSERT_THAT(!has_loops(program.get_instructions()));
+    ASSERT_THAT(same_result(run_analyzed(hello), run_reference(hello)));
+
+    // evaluation stops at the first input; the loop after it stays
+    bf::Program echo = compiler.compile_analyzed("++++++[>++++++++<-]>+.,[.,]");
+    const bf::Code& code = echo.get_instructions();
+    ASSERT_EQUAL(static_cast<int>(code[0].op), static_cast<int>(bf::OpCode::Add));
+    ASSERT_EQUAL(code[0].arg, '1');
+    ASSERT_EQUAL(static_cast<int>(code[1].op), static_cast<int>(bf::OpCode::Output));
+    ASSERT_THAT(has_loops(code));
+    ASSERT_EQUAL(run_analyzed("++++++[>++++++++<-]>+.,[.,]", "ab").output, "1ab");
+
+    // a loop that never ends is left to run time
+    bf::Program endless = compiler.compile_analyzed("+[]");
+    ASSERT_THAT(has_loops(endless.get_instructions()));
+END_TEST
+
+BEGIN_TEST(test_analysis_propagates_known_cells)
+    bf::Code code = bf::Program::to_code({
+        bf::OpCode::Input, bf::OpCode::LoopStart, bf::OpCode::Decrement, bf::OpCode::LoopEnd,
+        bf::OpCode::LoopStart, bf::OpCode::Output, bf::OpCode::LoopEnd, bf::OpCode::HALT
+    });
+    bf::Code propagated = bf::Analyzer::propagate_known_cells(bf::Optimizer{}.optimize(code));
+
+    ASSERT_EQUAL(propagated.size(), 3);     // ',[-]' - the second loop is dead, the clear stays
+    ASSERT_EQUAL(static_cast<int>(propagated[0].op), static_cast<int>(bf::OpCode::Input));
+    ASSERT_EQUAL(static_cast<int>(propagated[1].op), static_cast<int>(bf::OpCode::SetZero));
+    ASSERT_EQUAL(static_cast<int>(propagated[2].op), static_cast<int>(bf::OpCode::HALT));
+END_TEST
+
+BEGIN_TEST(test_analyzed_matches_interpreter)
+    for (auto const& [source, input] : differential_cases) {
+        ASSERT_THAT(same_result(run_analyzed(source, input), run_reference(source, input)));
+    }
+END_TEST
+
+BEGIN_TEST(test_threaded_hello_world)
+    std::string bf_source = "++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++.";
+    ASSERT_EQUAL(run_threaded(bf_source, false), "Hello World!\n");
+    ASSERT_EQUAL(run_threaded(bf_source, true), "Hello World!\n");
+END_TEST
+
+BEGIN_TEST(test_threaded_matches_vm)
+    std::string bf_source = ",[->+>+<<]>>[-<<+>>]<[->++++<]>[-<+>]<.>+[->-[>+<-]>[-<+<+>>]<<]>>.<<+[>+<+]>.";
+    ASSERT_EQUAL(run_threaded(bf_source, false, "A"), run_source(bf_source, false, "A"));
+    ASSERT_EQUAL(run_threaded(bf_source, true, "A"), run_source(bf_source, false, "A"));
+END_TEST
+
+BEGIN_TEST(test_threaded_state_after_run)
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile_optimized("<<+++[->++<]");
+
+    std::ostringstream os;
+    std::istringstream is("");
+    bf::Console console{os, is};
+    bf::Memory tape{};
+    bf::ThreadedVM vm{tape, program, console};
+    vm.run();
+
+    ASSERT_EQUAL(tape.position(), 29998);
+    ASSERT_EQUAL(tape[29999], 6);
+    ASSERT_EQUAL(tape[29998], 0);
+    ASSERT_THAT(program.is_done());
+END_TEST
+
+BEGIN_TEST(test_jit_machine_code_matches_interpreter)
+    for (auto const& [source, input] : differential_cases) {
+        RunResult expected = run_reference(source, input);
+        ASSERT_THAT(same_result(run_jit(source, false, bf::JitMode::MachineCode, input), expected));
+        ASSERT_THAT(same_result(run_jit(source, true, bf::JitMode::MachineCode, input), expected));
+    }
+END_TEST
+
+BEGIN_TEST(test_jit_c_source_matches_interpreter)
+    for (auto const& [source, input] : differential_cases) {
+        RunResult expected = run_reference(source, input);
+        ASSERT_THAT(same_result(run_jit(source, true, bf::JitMode::CSource, input), expected));
+    }
+END_TEST
+
+BEGIN_TEST(test_jit_hello_world)
+    std::string bf_source = "++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++.";
+    ASSERT_EQUAL(run_jit(bf_source, true, bf::JitMode::MachineCode).output, "Hello World!\n");
+    ASSERT_EQUAL(run_jit(bf_source, true, bf::JitMode::CSource).output, "Hello World!\n");
+END_TEST
+
+BEGIN_TEST(test_buffered_console_flushes_on_input_and_destruction)
+    std::ostringstream os;
+    std::istringstream is("ab");
+    {
+        bf::Console console{os, is, bf::ConsoleMode::Buffered};
+        console.print_char('x');
+        console.print_chars('y', 3);
+        ASSERT_EQUAL(os.str(), "");
+        ASSERT_EQUAL(console.input_char(), 'a');
+        ASSERT_EQUAL(os.str(), "xyyy");
+        console.print_char('z');
+        ASSERT_EQUAL(console.input_char(), 'b');
+        ASSERT_EQUAL(console.input_char(), 0);
+        console.print_char('!');
+    }
+    ASSERT_EQUAL(os.str(), "xyyyz!");
+END_TEST
+
+BEGIN_TEST(test_buffered_console_flushes_at_threshold)
+    std::ostringstream os;
+    std::istringstream is;
+    bf::Console console{os, is, bf::ConsoleMode::Buffered};
+    console.print_chars('a', bf::Console::output_threshold - 1);
+    ASSERT_EQUAL(os.str().size(), 0);
+    console.print_char('b');
+    ASSERT_EQUAL(os.str().size(), bf::Console::output_threshold);
+END_TEST
+
+/**
+ * @brief Hands out its data chunk bytes per underflow, like a pipe read through a filebuf.
+ */
+class ChunkedInput : public std::streambuf {
+public:
+    ChunkedInput(std::string data, size_t chunk)
+    : data_{std::move(data)}
+    , chunk_{chunk}
+    {
+    }
+
+    size_t underflows() const { return underflows_; }
+
+protected:
+    int_type underflow() override
+    {
+        if (next_ == data_.size()) {
+            return traits_type::eof();
+        }
+        size_t n = std::min(chunk_, data_.size() - next_);
+        setg(&data_[next_], &data_[next_], &data_[next_] + n);
+        next_ += n;
+        ++underflows_;
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    std::string data_;
+    size_t chunk_;
+    size_t next_ = 0;
+    size_t underflows_ = 0;
+};
+
+BEGIN_TEST(test_buffered_console_refills_in_blocks)
+    std::string data;
+    for (size_t i = 0; i < 1000; ++i) {
+        data.push_back(static_cast<char>('a' + i % 26));
+    }
+    ChunkedInput chunks{data, 100};
+    std::istream is{&chunks};
+    std::ostringstream os;
+    bf::Console console{os, is, bf::ConsoleMode::Buffered};
+
+    ASSERT_EQUAL(console.input_char(), 'a');
+    ASSERT_EQUAL(chunks.in_avail(), 0);     // the first refill took the whole chunk, not one byte
+    std::string read(1, 'a');
+    for (size_t i = 1; i < data.size(); ++i) {
+        read.push_back(static_cast<char>(console.input_char()));
+    }
+    ASSERT_EQUAL(read, data);
+    ASSERT_EQUAL(chunks.underflows(), 10);
+    ASSERT_EQUAL(console.input_char(), 0);
+END_TEST
+
+// Counts the writes and flushes that reach the device
+class CountingOutput : public std::streambuf {
+public:
+    std::string const& data() const { return data_; }
+    size_t writes() const { return writes_; }
+    size_t syncs() const { return syncs_; }
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        data_.append(s, static_cast<size_t>(n));
+        ++writes_;
+        return n;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            data_.push_back(traits_type::to_char_type(c));
+            ++writes_;
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override
+    {
+        ++syncs_;
+        return 0;
+    }
+
+private:
+    std::string data_;
+    size_t writes_ = 0;
+    size_t syncs_ = 0;
+};
+
+BEGIN_TEST(test_buffered_echo_writes_per_refill)
+    std::string data;
+    for (size_t i = 0; i < 1000; ++i) {
+        data.push_back(static_cast<char>('a' + i % 26));
+    }
+    ChunkedInput chunks{data, 100};
+    std::istream is{&chunks};
+    CountingOutput counting;
+    std::ostream os{&counting};
+
+    bf::Program program = bf::Compiler{}.compile_optimized(",[.,]");
+    bf::Memory tape{};
+    {
+        bf::Console console{os, is, bf::ConsoleMode::Buffered};
+        bf::ThreadedVM vm{tape, program, console};
+        vm.run();
+    }
+    ASSERT_EQUAL(counting.data(), data);
+    // one write and flush before each of the 11 refills, plus the final flush - not one per byte
+    ASSERT_THAT(counting.writes() <= 12);
+    ASSERT_THAT(counting.syncs() <= 12);
+END_TEST
+
+BEGIN_TEST(test_folded_output_on_all_backends)
+    std::string bf_source = "++++++[>+++++++<-]>..........";
+    bf::Program folded = bf::Compiler{}.compile_optimized(bf_source);
+    const bf::Code& code = folded.get_instructions();
+    ASSERT_EQUAL(static_cast<int>(code[code.size() - 2].op), static_cast<int>(bf::OpCode::Output));
+    ASSERT_EQUAL(code[code.size() - 2].arg, 10);
+
+    std::string expected(10, '*');
+    ASSERT_EQUAL(run_source(bf_source, true), expected);
+    ASSERT_EQUAL(run_threaded(bf_source, true), expected);
+    ASSERT_EQUAL(run_jit(bf_source, true, bf::JitMode::MachineCode).output, expected);
+    ASSERT_EQUAL(run_jit(bf_source, true, bf::JitMode::CSource).output, expected);
+
+    std::ostringstream os;
+    std::istringstream is;
+    bf::Program program = bf::Compiler{}.compile_optimized(bf_source);
+    bf::Memory tape{};
+    {
+        bf::Console console{os, is, bf::ConsoleMode::Buffered};
+        bf::ThreadedVM vm{tape, program, console};
+        vm.run();
+    }
+    ASSERT_EQUAL(os.str(), expected);
+END_TEST
+
+BEGIN_TEST(test_threaded_step_limit_and_resume)
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile_optimized("+++[>++<-]>.[.-]");
+    std::ostringstream os;
+    std::istringstream is;
+    bf::Console console{os, is};
+    bf::Memory tape{};
+    bf::ThreadedVM vm{tape, program, console};
+
+    ASSERT_THAT(!vm.run_for(2));    // two iterations of '[.-]', stopped before the third
+    ASSERT_EQUAL(os.str(), std::string("\6\6\5\4"));
+    ASSERT_THAT(vm.run_for(10));
+    ASSERT_EQUAL(os.str(), std::string("\6\6\5\4\3\2\1"));
+    ASSERT_EQUAL(vm.touched_begin(), 0);
+    ASSERT_EQUAL(vm.touched_end(), 3);     // cells 0-1, widened by the MultiplyAdd offset
+
+    tape.reset(vm.touched_begin(), vm.touched_end());
+    ASSERT_EQUAL(tape.position(), 0);
+    ASSERT_EQUAL(tape[1], 0);
+END_TEST
+
+BEGIN_TEST(test_program_copies_share_instructions)
+    bf::Compiler compiler{};
+    bf::Program program = compiler.compile("+>+");
+    bf::Program copy = program;
+    copy.jump(2);
+    ASSERT_EQUAL(&program.get_instructions(), &copy.get_instructions());
+    ASSERT_EQUAL(static_cast<int>(program.fetch_current()), static_cast<int>(bf::OpCode::Increment));
+    ASSERT_EQUAL(static_cast<int>(copy.fetch_current()), static_cast<int>(bf::OpCode::Increment));
+    copy.jump(1);
+    ASSERT_THAT(copy.is_done());
+    ASSERT_THAT(!program.is_done());
+END_TEST
+
+BEGIN_TEST(test_engine_runs_cached_programs_concurrently)
+    std::string echo = ",[.,]";
+    std::string hello = "++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.>++.";
+    bf::Engine engine{4};
+
+    std::vector<std::future<bf::RunReport>> reports;
+    for (int i = 0; i < 64; ++i) {
+        reports.push_back(engine.submit(i % 2 ? echo : hello, "run " + std::to_string(i)));
+    }
+    for (int i = 0; i < 64; ++i) {
+        bf::RunReport report = reports[i].get();
+        ASSERT_THAT(report.status == bf::RunStatus::Halted);
+        ASSERT_EQUAL(report.output, i % 2 ? "run " + std::to_string(i) : std::string("Hello World!\n"));
+    }
+    ASSERT_EQUAL(engine.cached_programs(), 2);
+END_TEST
+
+BEGIN_TEST(test_engine_step_limit_and_invalid_source)
+    bf::Engine engine{2};
+    bf::RunReport endless = engine.run("+[>+<]", "", 1000);
+    ASSERT_THAT(endless.status == bf::RunStatus::StepLimit);
+
+    bf::RunReport invalid = engine.run("+[", "");
+    ASSERT_THAT(invalid.status == bf::RunStatus::InvalidSource);
+
+    // the tape used by the endless run comes back clean
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQUAL(engine.run(",>,<.>.", "ab").output, "ab");
+        ASSERT_EQUAL(engine.run(">.<.", "").output, std::string(2, '\0'));
+    }
+END_TEST
+
+BEGIN_TEST(test_engine_cache_evicts_least_recently_used)
+    bf::Engine engine{1, 2};
+    std::string echo = ",[.,]";
+    std::string twice = ",[..,]";
+    std::string bang = "+++++++++++++++++++++++++++++++++.";
+
+    ASSERT_EQUAL(engine.run(echo, "a").output, "a");
+    ASSERT_EQUAL(engine.run(twice, "b").output, "bb");
+    ASSERT_EQUAL(engine.run(echo, "c").output, "c");       // echo is now the most recent
+    ASSERT_EQUAL(engine.run(bang).output, "!");            // evicts twice
+    ASSERT_EQUAL(engine.cached_programs(), 2);
+
+    for (int i = 0; i < 100; ++i) {
+        std::string source = std::string(static_cast<size_t>(i % 50 + 1), '+') + ".";
+        ASSERT_EQUAL(engine.run(source).output, std::string(1, static_cast<char>(i % 50 + 1)));
+        ASSERT_THAT(engine.cached_programs() <= 2);
+    }
+    ASSERT_EQUAL(engine.run(twice, "d").output, "dd");     // compiled again after eviction
+END_TEST
+
+BEGIN_TEST(test_engine_with_zero_workers_still_runs)
+    bf::Engine engine{0};
+    std::future<bf::RunReport> report = engine.submit(",[.,]", "zero");
+    ASSERT_THAT(report.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    ASSERT_EQUAL(report.get().output, "zero");
+END_TEST
+
+BEGIN_TEST(test_growable_memory_basics)
+    bf::Memory memory(16, bf::Boundary::Grow);
+    ASSERT_THAT(memory.boundary() == bf::Boundary::Grow);
+    ASSERT_THAT(memory.size() >= bf::GuardedRegion::default_capacity);
+
+    memory.write(7);
+    memory.move_right();
+    memory.write(9);
+    memory.move(-1);
+    ASSERT_EQUAL(memory.read(), 7);
+    ASSERT_EQUAL(memory.read_at(1), 9);
+    ASSERT_EQUAL(memory[1], 9);
+END_TEST
+
+BEGIN_TEST(test_growable_memory_grows_on_fault)
+    bf::Memory memory(16, bf::Boundary::Grow);
+    const int32_t far = 5 << 20;    // well past the committed prefix
+
+    memory.move(far);
+    ASSERT_EQUAL(memory.read(), 0);
+    memory.write(42);
+    memory.write_at(1, 43);
+    ASSERT_EQUAL(memory[far], 42);
+    ASSERT_EQUAL(memory[far + 1], 43);
+
+    bf::Memory copy{memory};
+    ASSERT_EQUAL(copy[far], 42);
+    ASSERT_EQUAL(copy.position(), static_cast<bf::Index>(far));
+END_TEST
+
+BEGIN_TEST(test_guarded_region_explicit_growth)
+    bf::GuardedRegion region(0, 1 << 24);
+    ASSERT_EQUAL(region.committed(), 0);
+    region.ensure(100000);
+    ASSERT_THAT(region.committed() >= 100000);
+    region.data()[99999] = 1;
+    ASSERT_EQUAL(region.data()[99999], 1);
+END_TEST
+
+BEGIN_TEST(test_growable_tape_on_all_backends)
+    std::string bf_source = std::string(70000, '>') + "+++[-<+>]<[<]>.";
+    for (int backend = 0; backend < 4; ++backend) {
+        bf::Compiler compiler{};
+        bf::Program program = compiler.compile_optimized(bf_source);
+
+        std::ostringstream os;
+        std::istringstream is("");
+        bf::Console console{os, is};
+        bf::Memory tape{30000, bf::Boundary::Grow};
+
+        if (backend == 0) {
+            bf::VM vm{tape, program, console};
+            vm.run();
+        } else if (backend == 1) {
+            bf::ThreadedVM vm{tape, program, console};
+            vm.run();
+        } else {
+            bf::JitVM vm{tape, program, console, backend == 2 ? bf::JitMode::MachineCode : bf::JitMode::CSource};
+            vm.run();
+        }
+        ASSERT_EQUAL(tape[69999], 3);
+        ASSERT_EQUAL(tape.position(), 69999);
+        ASSERT_EQUAL(os.str(), "\x03");
+        ASSERT_THAT(program.is_done());
+    }
+END_TEST
+
+BEGIN_TEST(test_growable_tape_faults_left_of_origin)
+    pid_t child = fork();
+    if (child == 0) {
+        signal(SIGSEGV, SIG_DFL);   // bypass the test framework's handler
+        bf::Compiler compiler{};
+        bf::Program program = compiler.compile_optimized("<+");
+        bf::Console console{};
+        bf::Memory tape{30000, bf::Boundary::Grow};
+        bf::ThreadedVM vm{tape, program, console};
+        vm.run();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    ASSERT_THAT(WIFSIGNALED(status));
+    ASSERT_EQUAL(WTERMSIG(status), SIGSEGV);
+END_TEST
+
+// Runs source on a fresh growable tape in a child, with a writable page planted where a
+// one-page guard would end, and returns how the child ended
+int run_far_below_origin(std::string const& source, int backend)
+{
+    pid_t child = fork();
+    if (child == 0) {
+        signal(SIGSEGV, SIG_DFL);
+        bf::Program program = bf::Compiler{}.compile_optimized(source);
+        bf::Console console{};
+        bf::Memory tape{30000, bf::Boundary::Grow};
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        mmap(tape.data() - 2 * page, page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if (backend == 0) {
+            bf::ThreadedVM vm{tape, program, console};
+            vm.run();
+        } else if (backend == 1) {
+            bf::VM vm{tape, program, console};
+            vm.run();
+        } else {
+            bf::JitVM vm{tape, program, console, bf::JitMode::MachineCode};
+            vm.run();
+        }
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    return status;
+}
+
+BEGIN_TEST(test_growable_tape_guard_covers_program_reach)
+    std::string far_move = std::string(5000, '<') + "+";                        // Move(-5000), Add
+    std::string far_offset = std::string(5000, '<') + "+" + std::string(5000, '>') + "+";    // Add at offset -5000
+    for (std::string const& source : {far_move, far_offset}) {
+        ASSERT_THAT(bf::Compiler{}.compile_optimized(source).reach() >= 5000);
+        for (int backend : {0, 1, 2}) {
+            int status = run_far_below_origin(source, backend);
+            ASSERT_THAT(WIFSIGNALED(status));
+            ASSERT_EQUAL(WTERMSIG(status), SIGSEGV);
+        }
+    }
+
+    // a wider guard keeps the tape's cells
+    bf::Memory tape{16, bf::Boundary::Grow};
+    tape.write(42);
+    tape.reserve_guard(1 << 20);
+    ASSERT_EQUAL(tape.read(), 42);
+END_TEST
+
 BEGIN_SUITE()
     TEST(test_memory_initialization)
     TEST(test_memory_read_write)
@@ -257,10 +1064,56 @@ BEGIN_SUITE()
 
     TEST(test_jump_table_construction)
     TEST(test_opcode_vector_construction)
+    TEST(test_nested_jump_targets)
+    TEST(test_unmatched_brackets_compile_to_halt)
     TEST(test_bracket_validation)
 
     TEST(test_from_scratch) 
     TEST(test_valid)
     TEST(test_hello_world)
     TEST(test_echo_program)
+
+    TEST(test_compile_from_mapped_source_file)
+    TEST(test_source_file_reads_pipes)
+
+    TEST(test_optimizer_folds_runs)
+    TEST(test_optimizer_lowers_clear_and_scan_loops)
+    TEST(test_optimizer_lowers_multiply_loops)
+    TEST(test_optimized_multiply_execution)
+    TEST(test_optimized_hello_world)
+    TEST(test_optimized_matches_plain)
+
+    TEST(test_optimizer_folds_offsets)
+    TEST(test_multiply_loops_lowered_from_offset_form)
+    TEST(test_analysis_evaluates_constant_prefix)
+    TEST(test_analysis_propagates_known_cells)
+    TEST(test_analyzed_matches_interpreter)
+
+    TEST(test_threaded_hello_world)
+    TEST(test_threaded_matches_vm)
+    TEST(test_threaded_state_after_run)
+
+    TEST(test_jit_machine_code_matches_interpreter)
+    TEST(test_jit_c_source_matches_interpreter)
+    TEST(test_jit_hello_world)
+
+    TEST(test_buffered_console_flushes_on_input_and_destruction)
+    TEST(test_buffered_console_flushes_at_threshold)
+    TEST(test_buffered_console_refills_in_blocks)
+    TEST(test_buffered_echo_writes_per_refill)
+    TEST(test_folded_output_on_all_backends)
+
+    TEST(test_threaded_step_limit_and_resume)
+    TEST(test_program_copies_share_instructions)
+    TEST(test_engine_runs_cached_programs_concurrently)
+    TEST(test_engine_step_limit_and_invalid_source)
+    TEST(test_engine_cache_evicts_least_recently_used)
+    TEST(test_engine_with_zero_workers_still_runs)
+
+    TEST(test_growable_memory_basics)
+    TEST(test_growable_memory_grows_on_fault)
+    TEST(test_guarded_region_explicit_growth)
+    TEST(test_growable_tape_on_all_backends)
+    TEST(test_growable_tape_faults_left_of_origin)
+    TEST(test_growable_tape_guard_covers_program_reach)
 END_SUITE
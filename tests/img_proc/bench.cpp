@@ -0,0 +1,92 @@
+#include "img_proc/image.hpp"
+#include "img_proc/image_proc.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <thread>
+
+// Throughput of the transformers on vegetables.ppm tiled to 2240x2240, best of several runs.
+// Build with `make bench`, which compiles with optimizations and -march=native.
+
+namespace {
+
+using Image16 = img_proc::Image<uint16_t>;
+using Image8 = img_proc::Image8;
+
+template<typename T>
+img_proc::Image<T> tiled_input(img_proc::Image<T> const& tile, size_t factor)
+{
+    img_proc::Image<T> image{tile.height() * factor, tile.width() * factor, tile.max_color()};
+    for (size_t y = 0; y < image.height(); ++y) {
+        for (size_t x = 0; x < image.width(); ++x) {
+            image[y * image.width() + x] = tile[(y % tile.height()) * tile.width() + x % tile.width()];
+        }
+    }
+    return image;
+}
+
+template<typename T>
+void report(const char* name, img_proc::Image<T> const& input, size_t threads,
+            std::function<img_proc::Image<T>(img_proc::Image<T> const&, size_t)> const& run)
+{
+    constexpr int runs = 5;
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        img_proc::Image<T> result = run(input, threads);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    double megapixels = static_cast<double>(input.size()) / 1e6;
+    std::printf("%-28s %8.2f ms %10.1f MPix/s\n", name, best * 1e3, megapixels / best);
+}
+
+} // namespace
+
+int main()
+{
+    Image16 input = tiled_input(img_proc::image::image_loader<uint16_t>("vegetables.ppm"), 4);
+    Image8 input8 = tiled_input(img_proc::image::image_loader<uint8_t>("vegetables.ppm"), 4);
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%zux%zu, %zu threads\n", input.width(), input.height(), threads);
+
+    using img_proc::ResizeFilter;
+    struct {
+        const char* name;
+        ResizeFilter filter;
+    } filters[] = {{"bilinear", ResizeFilter::Bilinear}, {"bicubic", ResizeFilter::Bicubic}, {"lanczos3", ResizeFilter::Lanczos3}};
+    for (auto const& f : filters) {
+        char name[64];
+        std::snprintf(name, sizeof name, "resize 1/2 %s", f.name);
+        img_proc::Resize<uint16_t> down{input.height() / 2, input.width() / 2, f.filter};
+        report<uint16_t>(name, input, threads, [&](Image16 const& in, size_t t) { return down.transform_image(in, t); });
+
+        std::snprintf(name, sizeof name, "resize x1.5 %s", f.name);
+        img_proc::Resize<uint16_t> up{input.height() * 3 / 2, input.width() * 3 / 2, f.filter};
+        report<uint16_t>(name, input, threads, [&](Image16 const& in, size_t t) { return up.transform_image(in, t); });
+    }
+
+    auto box = img_proc::SeparableConvolution<uint16_t>::box(5);
+    auto sharpen = img_proc::SeparableConvolution<uint16_t>::sharpen();
+    auto sobel = img_proc::SeparableConvolution<uint16_t>::sobel_x();
+    img_proc::GaussianBlur<uint16_t> gaussian{9, 2.0};
+    img_proc::HistogramEqualization<uint16_t> equalize;
+    report<uint16_t>("convolution box 5x5", input, threads, [&](Image16 const& in, size_t t) { return box.transform_image(in, t); });
+    report<uint16_t>("convolution sharpen 3x3", input, threads, [&](Image16 const& in, size_t t) { return sharpen.transform_image(in, t); });
+    report<uint16_t>("convolution sobel x", input, threads, [&](Image16 const& in, size_t t) { return sobel.transform_image(in, t); });
+    report<uint16_t>("gaussian 9x9", input, threads, [&](Image16 const& in, size_t t) { return gaussian.transform_image(in, t); });
+    report<uint16_t>("histogram equalization", input, threads, [&](Image16 const& in, size_t t) { return equalize.transform_image(in, t); });
+
+    // The same operators on 8-bit channels
+    img_proc::ColorReduction<uint16_t> to_bw;
+    img_proc::ColorReduction<uint8_t> to_bw8;
+    img_proc::GaussianBlur<uint8_t> gaussian8{9, 2.0};
+    img_proc::HistogramEqualization<uint8_t> equalize8;
+    report<uint16_t>("black and white", input, threads, [&](Image16 const& in, size_t t) { return to_bw.transform_to_bw(in, t); });
+    report<uint8_t>("black and white 8-bit", input8, threads, [&](Image8 const& in, size_t t) { return to_bw8.transform_to_bw(in, t); });
+    report<uint8_t>("gaussian 9x9 8-bit", input8, threads, [&](Image8 const& in, size_t t) { return gaussian8.transform_image(in, t); });
+    report<uint8_t>("histogram equalization 8-bit", input8, threads, [&](Image8 const& in, size_t t) { return equalize8.transform_image(in, t); });
+    return 0;
+}
@@ -3,10 +3,19 @@
 #include "img_proc/rgb.hpp"
 #include "img_proc/image.hpp"
 #include "img_proc/image_proc.hpp"
+#include "img_proc/pipeline.hpp"
+#include "img_proc/stream_proc.hpp"
 
 #include <filesystem>
 #include <fstream>
+#include <sstream>
 #include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <thread>
 
 /*------------------------------------------------------------------------------------------------------*/
 
@@ -114,9 +123,1004 @@ END_TEST
 
 /*------------------------------------------------------------------------------------------------------*/
 
+template<typename T>
+bool test_format_round_trip(const std::string& input_file, const std::string& output_file, img_proc::image::Format format)
+{
+    auto original = img_proc::image::image_loader<T>(input_file);
+    img_proc::image::image_saver(output_file, original, format);
+    auto reloaded = img_proc::image::image_loader<T>(output_file);
+    return original == reloaded;
+}
+
+BEGIN_TEST(test_netpbm_formats)
+    using img_proc::image::Format;
+    using img_proc::RGB;
+
+    std::ifstream in("vegetables.ppm");
+    auto streamed = img_proc::image::image_loader<uint16_t>(in);
+    auto mapped = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    ASSERT_THAT(streamed == mapped);
+    ASSERT_EQUAL(mapped.width(), 560);
+
+    ASSERT_THAT(test_format_round_trip<uint16_t>("vegetables.ppm", "p3_vegetables.ppm", Format::P3));
+    ASSERT_THAT(test_format_round_trip<uint16_t>("vegetables.ppm", "p6_vegetables.ppm", Format::P6));
+
+    img_proc::image::Image<uint16_t> deep{2, 3, 1000};
+    deep(0, 0) = RGB<uint16_t>{1000, 0, 256};
+    deep(1, 2) = RGB<uint16_t>{999, 255, 1};
+    std::stringstream deep_stream;
+    img_proc::image::image_saver(deep_stream, deep, Format::P6);
+    ASSERT_THAT(img_proc::image::image_loader<uint16_t>(deep_stream) == deep);
+
+    img_proc::image::Image<uint16_t> gray{1, 9, 255};
+    for (size_t col = 0; col < gray.width(); ++col) {
+        uint16_t level = static_cast<uint16_t>(col * 30);
+        gray(0, col) = RGB<uint16_t>(level, level, level);
+    }
+    std::stringstream gray_stream;
+    img_proc::image::image_saver(gray_stream, gray, Format::P5);
+    ASSERT_THAT(img_proc::image::image_loader<uint16_t>(gray_stream) == gray);
+
+    std::stringstream bit_stream;
+    img_proc::image::image_saver(bit_stream, gray, Format::P4);
+    ASSERT_EQUAL(bit_stream.str().size(), std::string("P4\n9 1\n").size() + 2);
+    auto bitmap = img_proc::image::image_loader<uint16_t>(bit_stream);
+    ASSERT_EQUAL(bitmap.max_color(), 1);
+    ASSERT_THAT(bitmap(0, 4) == RGB<uint16_t>::black());      // 120 is below half of 255
+    ASSERT_THAT(bitmap(0, 5) == RGB<uint16_t>(1, 1, 1));      // 150 is not
+END_TEST
+
+BEGIN_TEST(test_netpbm_invalid_files)
+    std::string comments = "P3\n# a comment\n2 1 # trailing\n255\n1 2 3 4 5 6";
+    auto commented = img_proc::image::image_decoder<uint16_t>(comments.data(), comments.size());
+    ASSERT_THAT(commented(0, 1) == img_proc::RGB<uint16_t>(4, 5, 6));
+
+    std::string jpeg = "\xFF\xD8\xFF";
+    std::string truncated = "P6\n2 2\n255\n\x01\x02\x03";
+    std::string too_bright = "P3\n1 1\n100\n50 101 0";
+    std::string short_plain = "P3\n2 1\n255\n1 2 3";
+
+    bool bad_magic = false;
+    try {
+        img_proc::image::image_decoder<uint16_t>(jpeg.data(), jpeg.size());
+    } catch (img_proc::FileASCIIException const&) {
+        bad_magic = true;
+    }
+    ASSERT_THAT(bad_magic);
+
+    size_t rejected = 0;
+    for (auto const& data : {truncated, too_bright, short_plain}) {
+        try {
+            img_proc::image::image_decoder<uint16_t>(data.data(), data.size());
+        } catch (img_proc::FileFormatException const&) {
+            ++rejected;
+        }
+    }
+    ASSERT_EQUAL(rejected, 3);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_planar_layout)
+    using img_proc::image::Planar;
+
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    auto planar = img_proc::image::to_planar(original);
+
+    ASSERT_EQUAL(planar.stride() % (img_proc::image::Image<uint16_t, Planar>::alignment / sizeof(uint16_t)), 0);
+    ASSERT_THAT(planar.stride() >= planar.width());
+    for (size_t channel = 0; channel < 3; ++channel) {
+        ASSERT_EQUAL(reinterpret_cast<uintptr_t>(planar.row(channel, 17)) % 64, 0);
+    }
+    ASSERT_THAT(planar(3, 5) == original(3, 5));
+    ASSERT_THAT(img_proc::image::to_interleaved(planar) == original);
+
+    for (size_t levels : {2, 4, 5}) {
+        img_proc::ColorReduction<uint16_t> reduction{levels};
+        auto expected = reduction.transform_image(original, 3);
+        ASSERT_THAT(img_proc::image::to_interleaved(reduction.transform_image(planar, 3)) == expected);
+    }
+
+    img_proc::GaussianBlur<uint16_t> blur{5, 1.2};
+    auto blurred = blur.transform_image(original, 4);
+    ASSERT_THAT(img_proc::image::to_interleaved(blur.transform_image(planar, 4)) == blurred);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+// Brute force 2D convolution with clamped borders, rounded to the nearest level
+img_proc::image::Image<uint16_t> reference_blur(img_proc::image::Image<uint16_t> const& image, int kernel_size, double sigma)
+{
+    int half = kernel_size / 2;
+    std::vector<double> weights(kernel_size);
+    double sum = 0.0;
+    for (int i = -half; i <= half; ++i) {
+        weights[i + half] = std::exp(-(i * i) / (2.0 * sigma * sigma));
+        sum += weights[i + half];
+    }
+
+    int height = static_cast<int>(image.height());
+    int width = static_cast<int>(image.width());
+    img_proc::image::Image<uint16_t> blurred{image.height(), image.width(), image.max_color()};
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double r = 0, g = 0, b = 0;
+            for (int ky = -half; ky <= half; ++ky) {
+                for (int kx = -half; kx <= half; ++kx) {
+                    auto px = image(std::clamp(y + ky, 0, height - 1), std::clamp(x + kx, 0, width - 1));
+                    double weight = weights[ky + half] * weights[kx + half] / (sum * sum);
+                    r += px.r * weight;
+                    g += px.g * weight;
+                    b += px.b * weight;
+                }
+            }
+            blurred(y, x) = img_proc::RGB<uint16_t>(r + 0.5, g + 0.5, b + 0.5);
+        }
+    }
+    return blurred;
+}
+
+double mean_channel_error(img_proc::image::Image<uint16_t> const& a, img_proc::image::Image<uint16_t> const& b, int& worst)
+{
+    double total = 0;
+    worst = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (int diff : {a[i].r - b[i].r, a[i].g - b[i].g, a[i].b - b[i].b}) {
+            total += std::abs(diff);
+            worst = std::max(worst, std::abs(diff));
+        }
+    }
+    return total / static_cast<double>(3 * a.size());
+}
+
+BEGIN_TEST(test_separable_gaussian)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    img_proc::image::Image<uint16_t> crop{90, 70, original.max_color()};
+    for (size_t y = 0; y < crop.height(); ++y) {
+        for (size_t x = 0; x < crop.width(); ++x) {
+            crop(y, x) = original(y + 200, x + 200);
+        }
+    }
+
+    int worst = 0;
+    img_proc::GaussianBlur<uint16_t> separable{7, 1.1};
+    mean_channel_error(separable.transform_image(crop, 3), reference_blur(crop, 7, 1.1), worst);
+    ASSERT_THAT(worst <= 1);
+
+    img_proc::GaussianBlur<uint16_t> boxes{41, 5.0};    // wide enough for the three-box approximation
+    double mean = mean_channel_error(boxes.transform_image(crop, 3), reference_blur(crop, 41, 5.0), worst);
+    ASSERT_THAT(mean < 2.0);
+    ASSERT_THAT(worst < 20);
+
+    img_proc::image::Image<uint16_t> flat{33, 47, 255};
+    for (size_t i = 0; i < flat.size(); ++i) {
+        flat[i] = img_proc::RGB<uint16_t>{200, 17, 255};
+    }
+    ASSERT_THAT(separable.transform_image(flat, 2) == flat);
+    ASSERT_THAT(boxes.transform_image(flat, 2) == flat);
+
+    bool rejected = false;
+    try {
+        img_proc::GaussianBlur<uint16_t> even{4, 1.0};
+    } catch (img_proc::InvalidKernelSizeException const&) {
+        rejected = true;
+    }
+    ASSERT_THAT(rejected);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_tile_scheduler)
+    img_proc::TileScheduler scheduler{4};
+    ASSERT_EQUAL(scheduler.threads(), 4);
+
+    size_t height = 301, width = 1203, halo = 3;
+    auto shape = img_proc::TileScheduler::tile_shape_for(height, width, sizeof(float), halo);
+    ASSERT_THAT(shape.cols <= width);
+    ASSERT_THAT(shape.rows >= 2 * halo);
+
+    std::vector<std::atomic<int>> visits(height * width);
+    std::atomic<bool> halos_ok{true};
+    scheduler.run_tiles(height, width, shape, halo, 4, [&](img_proc::Tile const& tile) {
+        bool ok = tile.halo_row_begin == (tile.row_begin > halo ? tile.row_begin - halo : 0)
+               && tile.halo_row_end == std::min(tile.row_end + halo, height)
+               && tile.halo_col_begin == (tile.col_begin > halo ? tile.col_begin - halo : 0)
+               && tile.halo_col_end == std::min(tile.col_end + halo, width);
+        if (!ok) {
+            halos_ok = false;
+        }
+        for (size_t row = tile.row_begin; row < tile.row_end; ++row) {
+            for (size_t col = tile.col_begin; col < tile.col_end; ++col) {
+                ++visits[row * width + col];
+            }
+        }
+    });
+    ASSERT_THAT(halos_ok);
+    ASSERT_THAT(std::all_of(visits.begin(), visits.end(), [](std::atomic<int> const& v) { return v == 1; }));
+
+    // A failing item aborts the job and surfaces in the caller; nested jobs run inline
+    bool thrown = false;
+    try {
+        scheduler.parallel_for(1000, 4, [](size_t i) {
+            if (i == 500) {
+                throw img_proc::OutOfBoundsException();
+            }
+        });
+    } catch (img_proc::OutOfBoundsException const&) {
+        thrown = true;
+    }
+    ASSERT_THAT(thrown);
+
+    std::atomic<size_t> total{0};
+    scheduler.parallel_for(16, 4, [&](size_t) {
+        scheduler.parallel_for(8, 4, [&](size_t) { ++total; });
+    });
+    ASSERT_EQUAL(total.load(), 128);
+
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    img_proc::GaussianBlur<uint16_t> blur{9, 2.0};
+    ASSERT_THAT(blur.transform_image(original, 1) == blur.transform_image(original, 8));
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+// Holds every item until `threads` items are running at once, or a second has passed
+static size_t peak_concurrency(img_proc::TileScheduler& scheduler, size_t threads)
+{
+    std::atomic<size_t> running{0};
+    std::atomic<size_t> peak{0};
+    scheduler.parallel_for(threads, threads, [&](size_t) {
+        size_t now = ++running;
+        size_t seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (peak.load() < threads && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        --running;
+    });
+    return peak.load();
+}
+
+BEGIN_TEST(test_tile_scheduler_honors_thread_count)
+    // Workers are started as asked, whatever hardware_concurrency() reports
+    img_proc::TileScheduler scheduler{4};
+    ASSERT_EQUAL(peak_concurrency(scheduler, 4), 4);
+
+    img_proc::TileScheduler serial{0};
+    ASSERT_EQUAL(serial.threads(), 1);
+    ASSERT_EQUAL(peak_concurrency(serial, 3), 3);
+    ASSERT_EQUAL(serial.threads(), 3);
+
+    ASSERT_EQUAL(peak_concurrency(img_proc::TileScheduler::shared(), 4), 4);
+    ASSERT_THAT(img_proc::TileScheduler::shared().threads() >= 4);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_pipeline)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+
+    auto reduce = std::make_shared<img_proc::ColorReduction<uint16_t>>(4);
+    auto blur = std::make_shared<img_proc::GaussianBlur<uint16_t>>(5, 1.0);
+    auto copy = std::make_shared<img_proc::NullTransformer<uint16_t>>();
+    auto pixelate = std::make_shared<img_proc::Pixelator<uint16_t>>(8);
+    auto to_bw = std::make_shared<img_proc::ColorReduction<uint16_t>>(2);
+
+    img_proc::Pipeline<uint16_t> pipeline;
+    pipeline.add(reduce).add(blur).add(copy).add(pixelate).add(to_bw);
+    ASSERT_EQUAL(pipeline.stages(), 5);
+    ASSERT_EQUAL(pipeline.passes(), 3);     // reduce+blur+copy fused, pixelate alone, to_bw
+
+    auto expected = to_bw->transform_image(
+                        pixelate->transform_image(
+                            copy->transform_image(
+                                blur->transform_image(
+                                    reduce->transform_image(original, 4), 4), 4), 4), 4);
+    ASSERT_THAT(pipeline.transform_image(original, 4) == expected);
+    ASSERT_THAT(pipeline.pooled_images() > 0);
+    ASSERT_THAT(pipeline.transform_image(original, 1) == expected);
+
+    img_proc::Pipeline<uint16_t> boxes;
+    boxes.add(reduce).add(std::make_shared<img_proc::GaussianBlur<uint16_t>>(41, 5.0));
+    ASSERT_EQUAL(boxes.passes(), 2);        // the box blur is not tileable and runs on its own
+
+    img_proc::Pipeline<uint16_t> empty;
+    ASSERT_THAT(empty.transform_image(original, 2) == original);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+// Nearest of the evenly spaced bins, ties to the lower bin
+uint16_t reference_level(uint16_t value, size_t levels, size_t max_color)
+{
+    size_t step = max_color / (levels - 1);
+    std::vector<size_t> bins(levels);
+    for (size_t i = 1; i < levels; ++i) {
+        bins[i] = std::min(max_color, bins[i - 1] + step);
+    }
+    return static_cast<uint16_t>(*std::min_element(bins.begin(), bins.end(), [value](size_t a, size_t b) {
+        return std::abs(static_cast<long>(a) - value) < std::abs(static_cast<long>(b) - value);
+    }));
+}
+
+BEGIN_TEST(test_color_reduction_table)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+
+    for (size_t levels : {3, 7, 256}) {
+        img_proc::ColorReduction<uint16_t> reduction{levels};
+        auto reduced = reduction.transform_image(original, 4);
+        bool same = true;
+        for (size_t i = 0; i < original.size(); ++i) {
+            same = same && reduced[i].r == reference_level(original[i].r, levels, original.max_color())
+                        && reduced[i].g == reference_level(original[i].g, levels, original.max_color())
+                        && reduced[i].b == reference_level(original[i].b, levels, original.max_color());
+        }
+        ASSERT_THAT(same);
+    }
+
+    img_proc::ColorReduction<uint16_t> bw{2};
+    auto parallel = bw.transform_to_bw(original, 4);
+    bool black_and_white = true;
+    for (size_t i = 0; i < original.size(); ++i) {
+        auto expected = original[i].to_intensity() < original.max_color() / 2 ? img_proc::RGB<uint16_t>::black()
+                                                                               : img_proc::RGB<uint16_t>::white();
+        black_and_white = black_and_white && parallel[i] == expected;
+    }
+    ASSERT_THAT(black_and_white);
+    ASSERT_THAT(bw.transform_image(original, 3) == parallel);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+img_proc::image::Image<uint16_t> reference_pixelate(img_proc::image::Image<uint16_t> const& image, size_t block)
+{
+    img_proc::image::Image<uint16_t> pixelated{image.height(), image.width(), image.max_color()};
+    for (size_t top = 0; top < image.height(); top += block) {
+        for (size_t left = 0; left < image.width(); left += block) {
+            size_t bottom = std::min(top + block, image.height());
+            size_t right = std::min(left + block, image.width());
+            uint64_t r = 0, g = 0, b = 0;
+            for (size_t y = top; y < bottom; ++y) {
+                for (size_t x = left; x < right; ++x) {
+                    r += image(y, x).r;
+                    g += image(y, x).g;
+                    b += image(y, x).b;
+                }
+            }
+            uint64_t count = (bottom - top) * (right - left);
+            img_proc::RGB<uint16_t> average(r / count, g / count, b / count);
+            for (size_t y = top; y < bottom; ++y) {
+                for (size_t x = left; x < right; ++x) {
+                    pixelated(y, x) = average;
+                }
+            }
+        }
+    }
+    return pixelated;
+}
+
+BEGIN_TEST(test_pixelate_summed_area)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    for (size_t block : {1, 6, 7, 64, 1000}) {
+        img_proc::Pixelator<uint16_t> pixelator{block};
+        auto expected = reference_pixelate(original, block);
+        ASSERT_THAT(pixelator.transform_image(original, 1) == expected);
+        ASSERT_THAT(pixelator.transform_image(original, 5) == expected);
+    }
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+// Accepts the first `room` bytes, then fails every write
+struct FullDevice : std::streambuf {
+    explicit FullDevice(size_t room) : room_{room} {}
+
+    int_type overflow(int_type c) override
+    {
+        if (room_ == 0) {
+            return traits_type::eof();
+        }
+        --room_;
+        return traits_type::not_eof(c);
+    }
+
+    size_t room_;
+};
+
+BEGIN_TEST(test_stream_transform)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    std::ostringstream p3_file;
+    std::ostringstream p6_file;
+    img_proc::image::image_saver(p3_file, original, img_proc::image::Format::P3);
+    img_proc::image::image_saver(p6_file, original, img_proc::image::Format::P6);
+
+    auto streamed = [](std::string const& file, img_proc::ImageTransformer<uint16_t>& transformer, size_t band_rows) {
+        std::istringstream in{file};
+        std::ostringstream out;
+        img_proc::stream_transform(in, out, transformer, band_rows, 4);
+        return out.str();
+    };
+    auto saved = [](img_proc::Image<uint16_t> const& image, img_proc::image::Format format) {
+        std::ostringstream out;
+        img_proc::image::image_saver(out, image, format);
+        return out.str();
+    };
+
+    img_proc::GaussianBlur<uint16_t> blur{7, 1.5};
+    std::string blurred = saved(blur.transform_image(original, 4), img_proc::image::Format::P3);
+    for (size_t band_rows : {1, 2, 16, 97, 1000}) {    // bands thinner than the halo, uneven and whole image
+        ASSERT_THAT(streamed(p3_file.str(), blur, band_rows) == blurred);
+    }
+    ASSERT_THAT(streamed(p6_file.str(), blur, 64) == saved(blur.transform_image(original, 4), img_proc::image::Format::P6));
+
+    img_proc::ColorReduction<uint16_t> reduction{5};
+    ASSERT_THAT(streamed(p3_file.str(), reduction, 33) == saved(reduction.transform_image(original, 4), img_proc::image::Format::P3));
+
+    img_proc::Pixelator<uint16_t> pixelate{8};
+    bool unsupported = false;
+    try {
+        streamed(p3_file.str(), pixelate, 64);
+    } catch (img_proc::StreamingUnsupportedException const&) {
+        unsupported = true;
+    }
+    ASSERT_THAT(unsupported);
+
+    bool truncated = false;
+    try {
+        streamed(p3_file.str().substr(0, p3_file.str().size() / 2), blur, 64);
+    } catch (img_proc::FileFormatException const&) {
+        truncated = true;
+    }
+    ASSERT_THAT(truncated);
+
+    // A failing writer stops the reader and the bands in flight, whatever their number
+    for (size_t band_rows : {1, 64}) {
+        FullDevice device{p3_file.str().size() / 3};
+        std::ostream out{&device};
+        std::istringstream in{p3_file.str()};
+        bool failed = false;
+        try {
+            img_proc::stream_transform(in, out, blur, band_rows, 4);
+        } catch (img_proc::OutputStreamException const&) {
+            failed = true;
+        }
+        ASSERT_THAT(failed);
+    }
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_resize)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+
+    for (auto filter : {img_proc::ResizeFilter::Bilinear, img_proc::ResizeFilter::Bicubic, img_proc::ResizeFilter::Lanczos3}) {
+        img_proc::Resize<uint16_t> same_size{original.height(), original.width(), filter};
+        ASSERT_THAT(same_size.transform_image(original, 4) == original);
+
+        img_proc::Resize<uint16_t> shrink{original.height() / 3, original.width() / 2, filter};
+        auto small = shrink.transform_image(original, 4);
+        ASSERT_EQUAL(small.height(), original.height() / 3);
+        ASSERT_EQUAL(small.width(), original.width() / 2);
+        ASSERT_THAT(shrink.transform_image(original, 1) == small);
+
+        img_proc::Image<uint16_t> flat{37, 23, 255};
+        for (size_t i = 0; i < flat.size(); ++i) {
+            flat[i] = img_proc::RGB<uint16_t>(10, 128, 255);
+        }
+        img_proc::Resize<uint16_t> grow{101, 64, filter};
+        auto grown = grow.transform_image(flat, 4);
+        bool constant = true;
+        for (size_t i = 0; i < grown.size(); ++i) {
+            constant = constant && grown[i] == flat[0];
+        }
+        ASSERT_THAT(constant);
+    }
+
+    // Halving widens the triangle to four source columns, weighted 1/8, 3/8, 3/8, 1/8
+    img_proc::Image<uint16_t> stripes{8, 8, 255};
+    for (size_t i = 0; i < stripes.size(); ++i) {
+        uint16_t level = (i % 8) / 2 % 2 == 0 ? 0 : 200;
+        stripes[i] = img_proc::RGB<uint16_t>(level, level, level);
+    }
+    auto halved = img_proc::Resize<uint16_t>{4, 4}.transform_image(stripes, 2);
+    ASSERT_EQUAL(halved[0].r, 25);
+    ASSERT_EQUAL(halved[1].r, 150);
+
+    bool thrown = false;
+    try {
+        img_proc::Resize<uint16_t> empty{0, 10};
+    } catch (img_proc::InvalidDimensionsException const&) {
+        thrown = true;
+    }
+    ASSERT_THAT(thrown);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+// 2D convolution in double with replicated edges
+img_proc::Image<uint16_t> reference_convolution(img_proc::Image<uint16_t> const& image, std::vector<double> const& horizontal,
+                                                std::vector<double> const& vertical, bool absolute)
+{
+    long height = static_cast<long>(image.height());
+    long width = static_cast<long>(image.width());
+    long hh = static_cast<long>(horizontal.size() / 2);
+    long vh = static_cast<long>(vertical.size() / 2);
+    img_proc::Image<uint16_t> result{image.height(), image.width(), image.max_color()};
+    for (long y = 0; y < height; ++y) {
+        for (long x = 0; x < width; ++x) {
+            double r = 0, g = 0, b = 0;
+            for (long j = -vh; j <= vh; ++j) {
+                for (long i = -hh; i <= hh; ++i) {
+                    auto const& px = image[std::clamp(y + j, 0L, height - 1) * width + std::clamp(x + i, 0L, width - 1)];
+                    double w = vertical[j + vh] * horizontal[i + hh];
+                    r += w * px.r;
+                    g += w * px.g;
+                    b += w * px.b;
+                }
+            }
+            auto level = [&](double v) {
+                v = absolute ? std::fabs(v) : v;
+                return static_cast<uint16_t>(std::clamp(std::round(v), 0.0, static_cast<double>(image.max_color())));
+            };
+            result[y * width + x] = img_proc::RGB<uint16_t>(level(r), level(g), level(b));
+        }
+    }
+    return result;
+}
+
+bool within_one_level(img_proc::Image<uint16_t> const& a, img_proc::Image<uint16_t> const& b)
+{
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::abs(a[i].r - b[i].r) > 1 || std::abs(a[i].g - b[i].g) > 1 || std::abs(a[i].b - b[i].b) > 1) {
+            return false;
+        }
+    }
+    return a.size() == b.size();
+}
+
+BEGIN_TEST(test_separable_convolution)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+
+    auto box = img_proc::SeparableConvolution<uint16_t>::box(5);
+    std::vector<double> box_kernel(5, 0.2);
+    ASSERT_THAT(within_one_level(box.transform_image(original, 4), reference_convolution(original, box_kernel, box_kernel, false)));
+
+    auto sharpen = img_proc::SeparableConvolution<uint16_t>::sharpen(0.5f);
+    std::vector<double> sharpen_kernel{-0.5, 2.0, -0.5};
+    ASSERT_THAT(within_one_level(sharpen.transform_image(original, 4), reference_convolution(original, sharpen_kernel, sharpen_kernel, false)));
+
+    auto sobel = img_proc::SeparableConvolution<uint16_t>::sobel_x();
+    auto edges = sobel.transform_image(original, 4);
+    ASSERT_THAT(within_one_level(edges, reference_convolution(original, {-0.25, 0.0, 0.25}, {1.0, 2.0, 1.0}, true)));
+    ASSERT_THAT(sobel.transform_image(original, 1) == edges);
+
+    // Kernels of different lengths, and a pipeline fusing the stencil
+    img_proc::SeparableConvolution<uint16_t> wide{{0.25f, 0.5f, 0.25f}, {0.2f, 0.2f, 0.2f, 0.2f, 0.2f}};
+    ASSERT_EQUAL(wide.halo(), 2);
+    ASSERT_THAT(within_one_level(wide.transform_image(original, 4), reference_convolution(original, {0.25, 0.5, 0.25}, box_kernel, false)));
+    img_proc::Pipeline<uint16_t> pipeline;
+    pipeline.add(std::make_shared<img_proc::SeparableConvolution<uint16_t>>(wide));
+    ASSERT_THAT(pipeline.transform_image(original, 4) == wide.transform_image(original, 4));
+
+    bool thrown = false;
+    try {
+        img_proc::SeparableConvolution<uint16_t> even{{0.5f, 0.5f}, {1.0f}};
+    } catch (img_proc::InvalidKernelSizeException const&) {
+        thrown = true;
+    }
+    ASSERT_THAT(thrown);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_histogram_equalization)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+
+    img_proc::HistogramEqualization<uint16_t> equalize;
+    auto equalized = equalize.transform_image(original, 4);
+    ASSERT_THAT(equalize.transform_image(original, 1) == equalized);
+
+    // The mapping keeps the order of values, and the extremes move to 0 and max_color
+    bool monotonic = true;
+    uint16_t lowest = original.max_color();
+    uint16_t highest = 0;
+    for (size_t i = 1; i < original.size(); ++i) {
+        if (original[i].r < original[i - 1].r) {
+            monotonic = monotonic && equalized[i].r <= equalized[i - 1].r;
+        } else {
+            monotonic = monotonic && equalized[i].r >= equalized[i - 1].r;
+        }
+        lowest = std::min(lowest, equalized[i].g);
+        highest = std::max(highest, equalized[i].g);
+    }
+    ASSERT_THAT(monotonic);
+    ASSERT_EQUAL(lowest, 0);
+    ASSERT_EQUAL(highest, original.max_color());
+
+    // Two values split evenly: the lower one maps to 0, the upper one to max_color
+    img_proc::Image<uint16_t> two_levels{4, 4, 255};
+    for (size_t i = 0; i < two_levels.size(); ++i) {
+        uint16_t level = i % 2 == 0 ? 100 : 120;
+        two_levels[i] = img_proc::RGB<uint16_t>(level, level, level);
+    }
+    auto spread = equalize.transform_image(two_levels, 3);
+    ASSERT_EQUAL(spread[0].r, 0);
+    ASSERT_EQUAL(spread[1].r, 255);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_fixed_point_intensity)
+    for (uint16_t level : {0, 1, 128, 255, 1000, 65535}) {
+        ASSERT_EQUAL(img_proc::RGB<uint16_t>(level, level, level).to_intensity(), level);
+    }
+    ASSERT_EQUAL(img_proc::RGB8(255, 255, 255).to_intensity(), 255);
+
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    std::vector<uint16_t> row(original.width());
+    img_proc::simd::intensity(&original[0], row.data(), row.size());
+    bool close = true;
+    for (size_t x = 0; x < row.size(); ++x) {
+        auto const& px = original[x];
+        double exact = 0.299 * px.r + 0.587 * px.g + 0.114 * px.b;
+        close = close && row[x] == px.to_intensity() && std::fabs(row[x] - exact) <= 1.0;
+    }
+    ASSERT_THAT(close);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+img_proc::Image<uint16_t> widened(img_proc::Image8 const& image)
+{
+    img_proc::Image<uint16_t> result{image.height(), image.width(), image.max_color()};
+    for (size_t i = 0; i < image.size(); ++i) {
+        result[i] = img_proc::RGB<uint16_t>(image[i].r, image[i].g, image[i].b);
+    }
+    return result;
+}
+
+BEGIN_TEST(test_eight_bit_images)
+    auto wide = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    auto narrow = img_proc::image::image_loader<uint8_t>("vegetables.ppm");
+    ASSERT_THAT(widened(narrow) == wide);
+
+    std::vector<std::pair<std::shared_ptr<img_proc::ImageTransformer<uint8_t>>, std::shared_ptr<img_proc::ImageTransformer<uint16_t>>>> pairs{
+        {std::make_shared<img_proc::NullTransformer<uint8_t>>(), std::make_shared<img_proc::NullTransformer<uint16_t>>()},
+        {std::make_shared<img_proc::ColorReduction<uint8_t>>(2), std::make_shared<img_proc::ColorReduction<uint16_t>>(2)},
+        {std::make_shared<img_proc::ColorReduction<uint8_t>>(6), std::make_shared<img_proc::ColorReduction<uint16_t>>(6)},
+        {std::make_shared<img_proc::Pixelator<uint8_t>>(8), std::make_shared<img_proc::Pixelator<uint16_t>>(8)},
+        {std::make_shared<img_proc::GaussianBlur<uint8_t>>(7, 1.5), std::make_shared<img_proc::GaussianBlur<uint16_t>>(7, 1.5)},
+        {std::make_shared<img_proc::GaussianBlur<uint8_t>>(41, 5.0), std::make_shared<img_proc::GaussianBlur<uint16_t>>(41, 5.0)},
+        {std::make_shared<img_proc::Resize<uint8_t>>(200, 300, img_proc::ResizeFilter::Lanczos3),
+         std::make_shared<img_proc::Resize<uint16_t>>(200, 300, img_proc::ResizeFilter::Lanczos3)},
+        {std::make_shared<img_proc::SeparableConvolution<uint8_t>>(img_proc::SeparableConvolution<uint8_t>::sobel_y()),
+         std::make_shared<img_proc::SeparableConvolution<uint16_t>>(img_proc::SeparableConvolution<uint16_t>::sobel_y())},
+        {std::make_shared<img_proc::HistogramEqualization<uint8_t>>(), std::make_shared<img_proc::HistogramEqualization<uint16_t>>()},
+    };
+    for (auto const& [eight, sixteen] : pairs) {
+        ASSERT_THAT(widened(eight->transform_image(narrow, 4)) == sixteen->transform_image(wide, 4));
+    }
+
+    img_proc::Pipeline<uint8_t> pipeline;
+    pipeline.add(pairs[2].first).add(pairs[4].first);
+    ASSERT_THAT(widened(pipeline.transform_image(narrow, 4)) == pairs[4].second->transform_image(pairs[2].second->transform_image(wide, 4), 4));
+
+    for (auto format : {img_proc::image::Format::P3, img_proc::image::Format::P5, img_proc::image::Format::P6}) {
+        std::ostringstream eight_file;
+        std::ostringstream sixteen_file;
+        img_proc::image::image_saver(eight_file, narrow, format);
+        img_proc::image::image_saver(sixteen_file, wide, format);
+        ASSERT_THAT(eight_file.str() == sixteen_file.str());
+    }
+
+    std::istringstream in{"P3\n1 1\n65535\n1 2 3\n"};
+    bool rejected = false;
+    try {
+        img_proc::image::image_loader<uint8_t>(in);
+    } catch (img_proc::FileFormatException const&) {
+        rejected = true;
+    }
+    ASSERT_THAT(rejected);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_image_views)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    img_proc::Image<uint16_t> const& image = original;
+
+    auto row = image.row(17);
+    ASSERT_EQUAL(row.size(), image.width());
+    ASSERT_THAT(row.data() == image.row_ptr(17));
+    ASSERT_THAT(&image.at_unchecked(17, 5) == &row[5]);
+    ASSERT_THAT(image.at_unchecked(17, 5) == image(17, 5));
+
+    size_t count = 0;
+    for (auto const& px : image.row(image.height() - 1)) {
+        count += px == image(image.height() - 1, count) ? 1 : 0;
+    }
+    ASSERT_EQUAL(count, image.width());
+
+    // A subview keeps the parent's stride, and a mutable view converts to a read-only one
+    img_proc::ImageView<img_proc::RGB<uint16_t>> whole = original.view();
+    auto window = whole.subview(100, 200, 30, 40);
+    ASSERT_EQUAL(window.height(), 30);
+    ASSERT_EQUAL(window.width(), 40);
+    ASSERT_EQUAL(window.stride(), image.width());
+    ASSERT_THAT(&window.at_unchecked(2, 3) == &original.at_unchecked(102, 203));
+    ASSERT_THAT(window.row(29).end() == original.row_ptr(129) + 240);
+
+    window.at_unchecked(0, 0) = img_proc::RGB<uint16_t>(1, 2, 3);
+    img_proc::ImageView<const img_proc::RGB<uint16_t>> read_only = window;
+    ASSERT_THAT(read_only.subview(0, 0, 1, 1).row(0)[0] == img_proc::RGB<uint16_t>(1, 2, 3));
+    ASSERT_THAT(original(100, 200) == img_proc::RGB<uint16_t>(1, 2, 3));
+END_TEST
+
+BEGIN_TEST(test_transform_into)
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+
+    // A point-wise stage writes into the caller's buffer, or over its input
+    img_proc::ColorReduction<uint16_t> reduce{4};
+    auto expected = reduce.transform_image(original, 4);
+    img_proc::Image<uint16_t> out{original.height(), original.width(), original.max_color()};
+    const img_proc::RGB<uint16_t>* buffer = out.row_ptr(0);
+    reduce.transform_into(original, out, 4);
+    ASSERT_THAT(out == expected);
+    ASSERT_THAT(out.row_ptr(0) == buffer);
+
+    auto frame = original;
+    reduce.transform_in_place(frame, 4);
+    ASSERT_THAT(frame == expected);
+
+    img_proc::ColorReduction<uint16_t> to_bw;
+    to_bw.transform_to_bw(original, out, 4);
+    ASSERT_THAT(out == to_bw.transform_to_bw(original, 4));
+    ASSERT_THAT(out.row_ptr(0) == buffer);
+
+    // Other transformers resize out to their output's dimensions
+    img_proc::Resize<uint16_t> half{original.height() / 2, original.width() / 2};
+    half.transform_into(original, out, 4);
+    ASSERT_THAT(out == half.transform_image(original, 4));
+    ASSERT_THAT(out.row_ptr(0) == buffer);
+
+    img_proc::Pixelator<uint16_t> pixelate{8};
+    auto sharpen = img_proc::SeparableConvolution<uint16_t>::sharpen();
+    img_proc::HistogramEqualization<uint16_t> equalize;
+    img_proc::GaussianBlur<uint16_t> blur{5, 1.0};
+    std::vector<img_proc::ImageTransformer<uint16_t>*> stages = {&pixelate, &sharpen, &equalize, &blur};
+    for (auto* stage : stages) {
+        stage->transform_into(original, out, 4);
+        ASSERT_THAT(out == stage->transform_image(original, 4));
+    }
+
+    // The pipeline's last pass writes into out, intermediates go back to its pool
+    img_proc::Pipeline<uint16_t> pipeline;
+    pipeline.add(std::make_shared<img_proc::ColorReduction<uint16_t>>(4))
+            .add(std::make_shared<img_proc::Pixelator<uint16_t>>(8))
+            .add(std::make_shared<img_proc::GaussianBlur<uint16_t>>(5, 1.0));
+    expected = pipeline.transform_image(original, 4);
+    out = img_proc::Image<uint16_t>{original.height(), original.width(), original.max_color()};
+    buffer = out.row_ptr(0);
+    for (int i = 0; i < 3; ++i) {
+        pipeline.transform_into(original, out, 4);
+        ASSERT_THAT(out == expected);
+        ASSERT_THAT(out.row_ptr(0) == buffer);
+    }
+    ASSERT_THAT(pipeline.pooled_images() > 0);
+END_TEST
+
+BEGIN_TEST(test_image_pool)
+    img_proc::ImagePool<uint16_t> pool{2};
+    ASSERT_EQUAL(pool.size(), 0);
+
+    auto first = pool.acquire(30, 40, 255);
+    ASSERT_EQUAL(first.height(), 30);
+    ASSERT_EQUAL(first.width(), 40);
+    const img_proc::RGB<uint16_t>* buffer = first.row_ptr(0);
+    pool.release(std::move(first));
+    ASSERT_EQUAL(pool.size(), 1);
+
+    // Any idle image with the same pixel count is reused, whatever its shape
+    auto second = pool.acquire(40, 30, 1023);
+    ASSERT_THAT(second.row_ptr(0) == buffer);
+    ASSERT_EQUAL(second.height(), 40);
+    ASSERT_EQUAL(second.max_color(), 1023);
+    ASSERT_EQUAL(pool.size(), 0);
+
+    auto other = pool.acquire(10, 10, 255);
+    ASSERT_THAT(other.row_ptr(0) != buffer);
+
+    // Releases beyond the capacity free the image
+    pool.release(std::move(second));
+    pool.release(std::move(other));
+    pool.release(img_proc::Image<uint16_t>{5, 5, 255});
+    ASSERT_EQUAL(pool.size(), pool.capacity());
+    pool.clear();
+    ASSERT_EQUAL(pool.size(), 0);
+END_TEST
+
+BEGIN_TEST(test_parallel_p3_decoder)
+    // A few MiB of raster, so it is decoded in several chunks; the separators vary
+    size_t height = 480;
+    size_t width = 640;
+    img_proc::Image<uint16_t> expected{height, width, 60000};
+    std::string encoded = "P3\n# chunked\n640 480\n60000";
+    const char* separators[] = {" ", "\n", "  ", "\t", " \r\n"};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        uint16_t r = static_cast<uint16_t>(i * 7 % 60001);
+        uint16_t g = static_cast<uint16_t>(i % 10);
+        uint16_t b = static_cast<uint16_t>(i * 131 % 60001);
+        expected[i] = img_proc::RGB<uint16_t>(r, g, b);
+        for (uint16_t sample : {r, g, b}) {
+            encoded += separators[(i + sample) % 5];
+            encoded += std::to_string(sample);
+        }
+    }
+    encoded += "\n";
+    ASSERT_THAT(encoded.size() > 4 * img_proc::image::detail::decode_chunk);
+
+    auto parallel = img_proc::image::image_decoder<uint16_t>(encoded.data(), encoded.size(), 4);
+    ASSERT_THAT(parallel == expected);
+    ASSERT_THAT(img_proc::image::image_decoder<uint16_t>(encoded.data(), encoded.size(), 1) == expected);
+
+    // Samples past the last pixel are ignored, as in a serial parse
+    std::string trailing = encoded + "1 2 3 junk\n";
+    ASSERT_THAT(img_proc::image::image_decoder<uint16_t>(trailing.data(), trailing.size(), 4) == expected);
+
+    auto throws = [](std::string const& data) {
+        try {
+            img_proc::image::image_decoder<uint16_t>(data.data(), data.size(), 4);
+        } catch (img_proc::FileFormatException const&) {
+            return true;
+        }
+        return false;
+    };
+    ASSERT_THAT(throws(encoded.substr(0, encoded.size() - 8)));
+    std::string malformed = encoded;
+    malformed[malformed.size() / 2] = 'x';
+    ASSERT_THAT(throws(malformed));
+    std::string too_large = encoded;
+    too_large.insert(too_large.size() / 3, " 60001 ");
+    ASSERT_THAT(throws(too_large));
+
+    // A malformed last token of a chunk is rejected by every thread count. The cuts are found
+    // as decode_ascii_raster finds them: every bytes / chunks, moved forward to whitespace
+    std::string header = "P3\n640 400\n255";
+    std::string uniform = header;
+    for (size_t i = 0; i < 3 * 640 * 400; ++i) {
+        uniform += " 226";
+    }
+    size_t threads = 4;
+    size_t bytes = uniform.size() - header.size();
+    size_t chunks = std::min(bytes / img_proc::image::detail::decode_chunk, 4 * threads);
+    ASSERT_THAT(chunks >= 2);
+    for (size_t k = 1; k < chunks; ++k) {
+        size_t cut = header.size() + bytes / chunks * k;
+        while (uniform[cut] != ' ') {
+            ++cut;
+        }
+        std::string corrupted = uniform;
+        corrupted[cut - 1] = 'x';      // "226" becomes "22x" right before the cut
+        for (size_t count : {size_t{1}, threads}) {
+            bool rejected = false;
+            try {
+                img_proc::image::image_decoder<uint16_t>(corrupted.data(), corrupted.size(), count);
+            } catch (img_proc::FileFormatException const&) {
+                rejected = true;
+            }
+            ASSERT_THAT(rejected);
+        }
+    }
+END_TEST
+
+BEGIN_TEST(test_palette_reduction)
+    // simd::nearest against a scalar search, over the vector and tail paths
+    std::vector<float> r(37), g(37), b(37);
+    std::vector<float> pr = {0, 255, 128, 30, 200}, pg = {0, 255, 64, 220, 10}, pb = {0, 255, 190, 40, 90};
+    for (size_t i = 0; i < r.size(); ++i) {
+        r[i] = static_cast<float>(i * 97 % 256);
+        g[i] = static_cast<float>(i * 31 % 256);
+        b[i] = static_cast<float>(i * 173 % 256);
+    }
+    std::vector<uint32_t> entry(r.size());
+    img_proc::simd::nearest(r.data(), g.data(), b.data(), r.size(), pr.data(), pg.data(), pb.data(), pr.size(), entry.data());
+    size_t agree = 0;
+    for (size_t i = 0; i < r.size(); ++i) {
+        auto distance = [&](size_t e) {
+            return (r[i] - pr[e]) * (r[i] - pr[e]) + (g[i] - pg[e]) * (g[i] - pg[e]) + (b[i] - pb[e]) * (b[i] - pb[e]);
+        };
+        size_t best = 0;
+        for (size_t e = 1; e < pr.size(); ++e) {
+            best = distance(e) < distance(best) ? e : best;
+        }
+        agree += entry[i] == best ? 1 : 0;
+    }
+    ASSERT_EQUAL(agree, r.size());
+
+    // An image of four flat colors is reproduced exactly by a four color palette
+    img_proc::Image<uint16_t> blocks{64, 96, 255};
+    img_proc::RGB<uint16_t> colors[] = {img_proc::RGB<uint16_t>(200, 30, 30), img_proc::RGB<uint16_t>(20, 180, 40),
+                                        img_proc::RGB<uint16_t>(10, 10, 250), img_proc::RGB<uint16_t>(240, 240, 0)};
+    for (size_t y = 0; y < blocks.height(); ++y) {
+        for (size_t x = 0; x < blocks.width(); ++x) {
+            blocks(y, x) = colors[(y / 32) * 2 + x / 48];
+        }
+    }
+    img_proc::PaletteReduction<uint16_t> four{4};
+    ASSERT_THAT(four.transform_image(blocks, 4) == blocks);
+    ASSERT_EQUAL(four.palette().size(), 4);
+    img_proc::PaletteReduction<uint16_t> many{16};
+    ASSERT_THAT(many.transform_image(blocks, 4) == blocks);
+    ASSERT_EQUAL(many.palette().size(), 4);
+
+    // Every output pixel is its input's nearest palette color, whatever the thread count
+    auto original = img_proc::image::image_loader<uint16_t>("vegetables.ppm");
+    img_proc::PaletteReduction<uint16_t> palette{27};
+    auto reduced = palette.transform_image(original, 4);
+    ASSERT_THAT(palette.transform_image(original, 1) == reduced);
+    auto const& entries = palette.palette();
+    ASSERT_THAT(entries.size() <= 27);
+    size_t nearest = 0;
+    auto distance = [](img_proc::RGB<uint16_t> const& a, img_proc::RGB<uint16_t> const& c) {
+        auto d = [](uint16_t x, uint16_t y) { return (static_cast<int64_t>(x) - y) * (static_cast<int64_t>(x) - y); };
+        return d(a.r, c.r) + d(a.g, c.g) + d(a.b, c.b);
+    };
+    for (size_t i = 0; i < original.size(); i += 101) {
+        int64_t best = distance(original[i], entries[0]);
+        for (auto const& entry : entries) {
+            best = std::min(best, distance(original[i], entry));
+        }
+        nearest += distance(original[i], reduced[i]) == best ? 1 : 0;
+    }
+    ASSERT_EQUAL(nearest, (original.size() + 100) / 101);
+
+    // A fitted palette of 27 colors beats 3 fixed levels per channel (27 colors)
+    img_proc::ColorReduction<uint16_t> levels{3};
+    auto uniform = levels.transform_image(original, 4);
+    int64_t fitted_error = 0;
+    int64_t uniform_error = 0;
+    for (size_t i = 0; i < original.size(); ++i) {
+        fitted_error += distance(original[i], reduced[i]);
+        uniform_error += distance(original[i], uniform[i]);
+    }
+    ASSERT_THAT(fitted_error < uniform_error / 2);
+
+    bool thrown = false;
+    try {
+        img_proc::PaletteReduction<uint16_t> empty{0};
+    } catch (img_proc::InvalidPaletteSizeException const&) {
+        thrown = true;
+    }
+    ASSERT_THAT(thrown);
+END_TEST
+
+/*------------------------------------------------------------------------------------------------------*/
+
 BEGIN_SUITE(image_processing_tests)
     TEST(test_null_transformer)
     TEST(test_color_reduction)
     TEST(test_pixelate)
     TEST(test_gaussian_blur)
+    TEST(test_netpbm_formats)
+    TEST(test_netpbm_invalid_files)
+    TEST(test_planar_layout)
+    TEST(test_separable_gaussian)
+    TEST(test_tile_scheduler)
+    TEST(test_tile_scheduler_honors_thread_count)
+    TEST(test_pipeline)
+    TEST(test_color_reduction_table)
+    TEST(test_pixelate_summed_area)
+    TEST(test_stream_transform)
+    TEST(test_resize)
+    TEST(test_separable_convolution)
+    TEST(test_histogram_equalization)
+    TEST(test_fixed_point_intensity)
+    TEST(test_eight_bit_images)
+    TEST(test_image_views)
+    TEST(test_transform_into)
+    TEST(test_image_pool)
+    TEST(test_parallel_p3_decoder)
+    TEST(test_palette_reduction)
 END_SUITE
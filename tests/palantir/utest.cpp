@@ -12,6 +12,7 @@
 #include "palantir/encryption/vigenere.hpp"
 #include "palantir/encryption/null_encryption.hpp"
 #include "palantir/encryption/xor.hpp"
+#include "palantir/encryption/cipher_kernels.hpp"
 
 
 #include "palantir/message_source/console_in.hpp"
@@ -37,6 +38,51 @@
 #include "palantir/messenger.hpp"
 
 #include <thread>  // For threading to simulate simultaneous actions
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <cctype>
+
+// Byte-at-a-time ciphers as they were written before the kernels, for differential tests
+namespace reference {
+
+char rotate(char c, int shift)
+{
+    if (std::isalpha(static_cast<unsigned char>(c))) {
+        char base = std::isupper(static_cast<unsigned char>(c)) ? 'A' : 'a';
+        return (base + (c - base + shift + 26) % 26);
+    }
+    return c;
+}
+
+char atbash(char c)
+{
+    if (std::isalpha(static_cast<unsigned char>(c))) {
+        if (std::isupper(static_cast<unsigned char>(c))) {
+            return 'Z' - (c - 'A');
+        }
+        return 'z' - (c - 'a');
+    }
+    return c;
+}
+
+std::string vigenere(std::string const& text, std::string const& key, int direction)
+{
+    std::string out;
+    size_t key_index = 0;
+    for (char c : text) {
+        if (std::isalpha(static_cast<unsigned char>(c))) {
+            int key_shift = direction * (key[key_index] - 'a');
+            key_index = (key_index + 1) % key.size();
+            char base = std::isupper(static_cast<unsigned char>(c)) ? 'A' : 'a';
+            c = base + (c - base + key_shift + 26) % 26;
+        }
+        out.push_back(c);
+    }
+    return out;
+}
+
+}       // namespace reference
 
 BEGIN_TEST(test_rot13_text)
     palantir::Rot13 rot13{};
@@ -133,6 +179,132 @@ END_TEST
 
 /*-------------------------------------------------------------------------------*/
 
+BEGIN_TEST(test_encode_inplace_matches_encode)
+    palantir::Rot13 rot13{};
+    palantir::Caesar caesar{-4};
+    palantir::Atbash atbash{};
+    palantir::Vigenere vigenere{"Palantir"};
+    palantir::XorEncryptor xor_encryptor{"k3y"};
+    palantir::NullEncryption null_encryption{};
+    palantir::EncryptionAbstract* ciphers[] = {&rot13, &caesar, &atbash, &vigenere, &xor_encryptor, &null_encryption};
+
+    std::string text = "Seven stars and 7 stones, and ONE white tree! [zZaA@`{]";
+    for (palantir::EncryptionAbstract* cipher : ciphers) {
+        std::string expected = cipher->encode(text);
+
+        std::string out(text.size(), '\0');
+        cipher->encode_into(text, out.data());
+        ASSERT_EQUAL(out, expected);
+
+        // A second call starts again from the first key character
+        std::string buffer = text;
+        cipher->encode_inplace(buffer.data(), buffer.size());
+        ASSERT_EQUAL(buffer, expected);
+
+        cipher->decode_inplace(buffer.data(), buffer.size());
+        ASSERT_EQUAL(buffer, text);
+    }
+END_TEST
+
+/*-------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_messenger_chain_in_place)
+    palantir::Vigenere vigenere{"key"};
+    palantir::XorEncryptor xor_encryptor{"\x1F"};
+    palantir::Atbash atbash{};
+    palantir::Messenger messenger{std::vector<palantir::EncryptionAbstract*>{&vigenere, &xor_encryptor, &atbash}};
+
+    std::string text = "The passcode is: 12345! Please confirm.";
+    std::string expected = atbash.encode(xor_encryptor.encode(vigenere.encode(text)));
+
+    std::string input_path = "test_messenger_chain_in.txt";
+    std::string output_path = "test_messenger_chain_out.txt";
+    {
+        std::ofstream input(input_path);
+        input << text;
+    }
+    {
+        palantir::FileSource source(input_path);
+        palantir::FileDestination destination(output_path);
+        messenger.process(source, destination);
+    }
+    std::ifstream output(output_path);
+    std::string result((std::istreambuf_iterator<char>(output)), std::istreambuf_iterator<char>());
+    ASSERT_THAT(result.find(expected) != std::string::npos);
+
+    std::filesystem::remove(input_path);
+    std::filesystem::remove(output_path);
+END_TEST
+
+/*-------------------------------------------------------------------------------*/
+
+BEGIN_TEST(test_cipher_kernels_match_reference)
+    using palantir::kernels::Isa;
+    std::mt19937 rng{2024};
+    std::vector<std::string> texts;
+    for (size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 47, 64, 65, 200, 1031}) {
+        std::string any(size, '\0');
+        std::string letters(size, '\0');
+        for (size_t i = 0; i < size; ++i) {
+            any[i] = static_cast<char>(rng() % 256);
+            // Mostly letters, with spaces and punctuation at random gaps
+            letters[i] = (rng() % 5 == 0) ? " ,.!7"[rng() % 5] : "aZzAqM"[rng() % 6];
+        }
+        texts.push_back(any);
+        texts.push_back(letters);
+    }
+    std::string keys[] = {"a", "z", "lemon", "palantirpalantir", "oculorhinolaryngologyoculorhinolarynx", "qwertyuiopasdfghjklzxcvbnmqwertyuio"};
+
+    size_t mismatches = 0;
+    size_t checks = 0;
+    auto check = [&](std::string const& expected, std::string const& actual) {
+        mismatches += (expected != actual) ? 1 : 0;
+        ++checks;
+    };
+    for (int level = 0; level <= static_cast<int>(palantir::kernels::best_isa()); ++level) {
+        Isa isa = static_cast<Isa>(level);
+        for (std::string const& text : texts) {
+            std::string out(text.size(), '\0');
+            for (int shift : {-26, -13, -3, 0, 1, 13, 25, 26, 40}) {
+                std::string expected = text;
+                std::transform(text.begin(), text.end(), expected.begin(), [shift](char c) { return reference::rotate(c, shift); });
+                palantir::kernels::rotate(text, out.data(), shift, isa);
+                check(expected, out);
+            }
+
+            std::string expected = text;
+            std::transform(text.begin(), text.end(), expected.begin(), reference::atbash);
+            palantir::kernels::atbash(text, out.data(), isa);
+            check(expected, out);
+
+            for (std::string const& key : keys) {
+                for (size_t i = 0; i < text.size(); ++i) {
+                    expected[i] = text[i] ^ key[i % key.size()];
+                }
+                palantir::kernels::xor_key(text, out.data(), palantir::kernels::pad_key(key), isa);
+                check(expected, out);
+
+                for (int direction : {1, -1}) {
+                    std::string shifts = palantir::kernels::pad_key(palantir::kernels::key_shifts(key, direction));
+                    palantir::kernels::vigenere(text, out.data(), shifts, isa);
+                    check(reference::vigenere(text, key, direction), out);
+
+                    // In place, starting off a vector boundary
+                    if (text.size() > 3) {
+                        std::string buffer = text;
+                        palantir::kernels::vigenere(std::string_view{buffer}.substr(3), buffer.data() + 3, shifts, isa);
+                        check(text.substr(0, 3) + reference::vigenere(text.substr(3), key, direction), buffer);
+                    }
+                }
+            }
+        }
+    }
+    ASSERT_THAT(checks > 0);
+    ASSERT_EQUAL(mismatches, 0);
+END_TEST
+
+/*-------------------------------------------------------------------------------*/
+
 BEGIN_TEST(test_console_live_input)
     palantir::ConsoleInput console;
     std::string message;
@@ -538,6 +710,10 @@ BEGIN_SUITE(palantir_tests)
 
     TEST(test_xor_encryptor)
 
+    TEST(test_encode_inplace_matches_encode)
+    TEST(test_messenger_chain_in_place)
+    TEST(test_cipher_kernels_match_reference)
+
     TEST(test_file_source_get_message)
 
     TEST(test_console_output_send_message)